@@ -0,0 +1,107 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "AudioWriterThread.h"
+
+#include <utility> /* move */
+
+
+
+namespace GS {
+
+AudioWriterThread::AudioWriterThread(std::size_t maxQueueSize)
+		: maxQueueSize_(maxQueueSize > 0 ? maxQueueSize : 1)
+		, busy_()
+		, stop_()
+{
+	thread_ = std::thread(&AudioWriterThread::run, this);
+}
+
+AudioWriterThread::~AudioWriterThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	jobAddedCondition_.notify_one();
+	thread_.join();
+}
+
+void
+AudioWriterThread::write(std::vector<float> block, Output output)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	jobDoneCondition_.wait(lock, [&] { return queue_.size() < maxQueueSize_ || error_; });
+	rethrowError();
+
+	queue_.push_back(Job{std::move(block), std::move(output)});
+	lock.unlock();
+	jobAddedCondition_.notify_one();
+}
+
+void
+AudioWriterThread::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	jobDoneCondition_.wait(lock, [&] { return queue_.empty() && !busy_; });
+	rethrowError();
+}
+
+void
+AudioWriterThread::rethrowError()
+{
+	if (error_) {
+		std::exception_ptr error;
+		std::swap(error, error_);
+		std::rethrow_exception(error);
+	}
+}
+
+void
+AudioWriterThread::run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		jobAddedCondition_.wait(lock, [&] { return !queue_.empty() || stop_; });
+		if (queue_.empty()) break; // stop_ is true
+
+		Job job = std::move(queue_.front());
+		queue_.pop_front();
+		if (error_) {
+			// Discard the blocks queued after the error.
+			jobDoneCondition_.notify_all();
+			continue;
+		}
+		busy_ = true;
+		lock.unlock();
+		jobDoneCondition_.notify_all();
+
+		std::exception_ptr error;
+		try {
+			job.output(job.block);
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		lock.lock();
+		busy_ = false;
+		if (error) error_ = error;
+		jobDoneCondition_.notify_all();
+	}
+}
+
+} /* namespace GS */
@@ -0,0 +1,85 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef AUDIO_WRITER_THREAD_H_
+#define AUDIO_WRITER_THREAD_H_
+
+#include <condition_variable>
+#include <cstddef> /* std::size_t */
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace GS {
+
+// Writes blocks of audio in a separate thread, so a slow output
+// does not stall the synthesis.
+//
+// The blocks are passed through a bounded queue. When the queue is full,
+// write() waits until the writer thread has consumed a block.
+// If an output function throws an exception, the blocks that are still
+// in the queue are discarded, and the exception is rethrown by the next
+// call to write() or wait().
+class AudioWriterThread {
+public:
+	// Called in the writer thread.
+	typedef std::function<void(const std::vector<float>& block)> Output;
+
+	explicit AudioWriterThread(std::size_t maxQueueSize);
+	// Writes the queued blocks before returning. Errors are ignored.
+	~AudioWriterThread();
+
+	// Queues a block, to be sent to output.
+	void write(std::vector<float> block, Output output);
+
+	// Waits until all the queued blocks have been written.
+	void wait();
+private:
+	struct Job {
+		std::vector<float> block;
+		Output output;
+	};
+
+	AudioWriterThread(const AudioWriterThread&) = delete;
+	AudioWriterThread& operator=(const AudioWriterThread&) = delete;
+	AudioWriterThread(AudioWriterThread&&) = delete;
+	AudioWriterThread& operator=(AudioWriterThread&&) = delete;
+
+	// Main thread function.
+	void run();
+	// The mutex must be locked.
+	void rethrowError();
+
+	const std::size_t maxQueueSize_;
+	std::deque<Job> queue_;
+	bool busy_;
+	bool stop_;
+	std::exception_ptr error_;
+	std::mutex mutex_;
+	std::condition_variable jobAddedCondition_;
+	std::condition_variable jobDoneCondition_;
+	std::thread thread_;
+};
+
+} /* namespace GS */
+
+#endif /* AUDIO_WRITER_THREAD_H_ */
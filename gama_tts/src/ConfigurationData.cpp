@@ -188,6 +188,13 @@ ConfigurationData::convertValue(const T& value, std::string& s)
 	s = out.str();
 }
 
+template<>
+void
+ConfigurationData::convertValue<int>(const int& value, std::string& s)
+{
+	s = std::to_string(value);
+}
+
 template<>
 void
 ConfigurationData::convertValue<float>(const float& value, std::string& s)
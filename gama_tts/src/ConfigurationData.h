@@ -47,6 +47,7 @@ public:
 
 	template<typename T> T value(const std::string& key) const;
 	template<typename T> T value(const std::string& key, T minValue, T maxValue) const;
+	bool contains(const std::string& key) const { return valueMap_.find(key) != valueMap_.end(); }
 
 	// If an entry with the same key exists, it will be overwritten.
 	template<typename T> void put(const std::string& key, T value);
@@ -17,10 +17,78 @@
 
 #include "Log.h"
 
+#include <sstream>
+#include <string>
 
 
+
+namespace {
+
+// Flush the buffer if it gets larger than this, even inside a scope.
+constexpr std::string::size_type MAX_DEBUG_BUFFER_SIZE = 64 * 1024;
+
+struct DebugBuffer {
+	std::ostringstream stream;
+	unsigned int scopeDepth = 0;
+};
+
+DebugBuffer&
+debugBuffer()
+{
+	thread_local DebugBuffer buffer;
+	return buffer;
+}
+
+void
+writeDebugBuffer(DebugBuffer& buffer)
+{
+	const std::string s = buffer.stream.str();
+	if (s.empty()) return;
+
+	// A single write, to avoid mixing with the messages of other threads.
+	std::cout.write(s.data(), s.size());
+	std::cout.flush();
+
+	buffer.stream.str(std::string());
+}
+
+} /* namespace */
+
 namespace GS {
 
-bool Log::debugEnabled = false;
+Log::DebugScope::DebugScope(bool enabled)
+		: previousDebugEnabled_(Log::debugEnabled)
+{
+	++debugBuffer().scopeDepth;
+	Log::debugEnabled = enabled;
+}
+
+Log::DebugScope::~DebugScope()
+{
+	DebugBuffer& buffer = debugBuffer();
+	if (--buffer.scopeDepth == 0) {
+		writeDebugBuffer(buffer);
+	}
+	Log::debugEnabled = previousDebugEnabled_;
+}
+
+std::ostream&
+Log::debugStream()
+{
+	DebugBuffer& buffer = debugBuffer();
+	if (buffer.scopeDepth == 0) {
+		return std::cout;
+	}
+	if (static_cast<std::string::size_type>(buffer.stream.tellp()) > MAX_DEBUG_BUFFER_SIZE) {
+		writeDebugBuffer(buffer);
+	}
+	return buffer.stream;
+}
+
+void
+Log::flushDebugStream()
+{
+	writeDebugBuffer(debugBuffer());
+}
 
 } /* namespace GS */
@@ -19,18 +19,57 @@
 #define LOG_H_
 
 #include <iostream>
+#include <ostream>
 
 #define LOG_ERROR(M) std::cerr << M << std::endl
 
-#define LOG_DEBUG(M) if (Log::debugEnabled) std::cout << M << std::endl
-//#define LOG_DEBUG(M)
+#if defined(__GNUC__)
+# define LOG_UNLIKELY(C) __builtin_expect(!!(C), 0)
+#else
+# define LOG_UNLIKELY(C) (C)
+#endif
+
+// Define GS_DISABLE_DEBUG_LOG to remove all the LOG_DEBUG calls at compile time.
+#ifdef GS_DISABLE_DEBUG_LOG
+# define LOG_DEBUG(M) do {} while (false)
+#else
+# define LOG_DEBUG(M) do { if (LOG_UNLIKELY(Log::debugEnabled)) Log::debugStream() << M << '\n'; } while (false)
+#endif
 
 
 
 namespace GS {
 
+/*******************************************************************************
+ * Debug logging configuration.
+ *
+ * The flag is per thread. Objects that have their own logging
+ * configuration (e.g. VTMControlModel::Controller) install a DebugScope
+ * while they are working, so a single synthesizer can be debugged without
+ * enabling the messages of the other threads.
+ *
+ * Inside a DebugScope the messages are written to a buffer owned by the
+ * thread, and are sent to std::cout in one block when the outermost scope
+ * ends. Outside any scope the messages are sent directly to std::cout.
+ */
 struct Log {
-	static bool debugEnabled;
+	static inline thread_local bool debugEnabled = false;
+
+	class DebugScope {
+	public:
+		explicit DebugScope(bool enabled);
+		~DebugScope();
+	private:
+		DebugScope(const DebugScope&) = delete;
+		DebugScope& operator=(const DebugScope&) = delete;
+		DebugScope(DebugScope&&) = delete;
+		DebugScope& operator=(DebugScope&&) = delete;
+
+		bool previousDebugEnabled_;
+	};
+
+	static std::ostream& debugStream();
+	static void flushDebugStream();
 };
 
 } /* namespace GS */
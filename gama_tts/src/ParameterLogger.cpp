@@ -0,0 +1,98 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "ParameterLogger.h"
+
+#include <memory>
+#include <utility> /* move */
+
+
+
+namespace {
+
+template<typename T>
+void
+convertValues(std::istream& in, std::vector<std::unique_ptr<std::ofstream>>& outList)
+{
+	const std::size_t numChannels = outList.size();
+	std::vector<T> frame(numChannels);
+	while (in.read(reinterpret_cast<char*>(frame.data()), numChannels * sizeof(T))) {
+		for (std::size_t i = 0; i < numChannels; ++i) {
+			*outList[i] << frame[i] << '\n';
+		}
+	}
+}
+
+} /* namespace */
+
+namespace GS {
+
+void
+convertParameterLogToText(const char* logFilePath, const char* outputDir)
+{
+	std::ifstream in(logFilePath, std::ios_base::binary);
+	if (!in) {
+		THROW_EXCEPTION(IOException, "Could not open the file " << logFilePath << '.');
+	}
+
+	ParameterLogHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+			std::memcmp(header.magic, GS_PARAMETER_LOG_MAGIC, sizeof(header.magic)) != 0) {
+		THROW_EXCEPTION(InvalidFileException, "The file " << logFilePath << " is not a parameter log.");
+	}
+	if (header.byteOrderMark != GS_PARAMETER_LOG_BYTE_ORDER_MARK) {
+		THROW_EXCEPTION(InvalidFileException, "The parameter log " << logFilePath << " was created in a system with a different byte order.");
+	}
+	if (header.version != GS_PARAMETER_LOG_VERSION) {
+		THROW_EXCEPTION(InvalidFileException, "Unsupported parameter log version: " << header.version << '.');
+	}
+	if (header.valueSize != sizeof(float) && header.valueSize != sizeof(double)) {
+		THROW_EXCEPTION(InvalidFileException, "Invalid value size in the parameter log: " << header.valueSize << '.');
+	}
+
+	std::string dir{outputDir};
+	if (!dir.empty() && dir.back() != '/') {
+		dir += '/';
+	}
+
+	std::vector<std::unique_ptr<std::ofstream>> outList;
+	for (uint32_t i = 0; i < header.numChannels; ++i) {
+		uint32_t size;
+		if (!in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+			THROW_EXCEPTION(InvalidFileException, "Truncated parameter log: " << logFilePath << '.');
+		}
+		std::string name(size, '\0');
+		if (!in.read(&name[0], size) || name.empty()) {
+			THROW_EXCEPTION(InvalidFileException, "Invalid channel name in the parameter log " << logFilePath << '.');
+		}
+		const std::string filePath = dir + name + ".txt";
+		auto out = std::make_unique<std::ofstream>(filePath, std::ios_base::binary);
+		if (!*out) {
+			THROW_EXCEPTION(IOException, "Could not open the file " << filePath << '.');
+		}
+		outList.push_back(std::move(out));
+	}
+	if (outList.empty()) return;
+
+	if (header.valueSize == sizeof(float)) {
+		convertValues<float>(in, outList);
+	} else {
+		convertValues<double>(in, outList);
+	}
+}
+
+} /* namespace GS */
@@ -1,5 +1,5 @@
 /***************************************************************************
- *  Copyright 2017 Marcelo Y. Matuda                                       *
+ *  Copyright 2017, 2026 Marcelo Y. Matuda                                 *
  *                                                                         *
  *  This program is free software: you can redistribute it and/or modify   *
  *  it under the terms of the GNU General Public License as published by   *
@@ -18,79 +18,198 @@
 #ifndef GS_PARAMETER_LOGGER_H_
 #define GS_PARAMETER_LOGGER_H_
 
-#include <exception>
+#include <cstddef> /* std::size_t */
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <string>
-#include <utility> /* pair */
 #include <vector>
 
-#define GS_LOG_PARAMETER(L,P,V) do { L.put(P, V, #P); } while (false)
+#include "Exception.h"
+
+#define GS_PARAMETER_LOG_MAGIC "GSPARLOG"
+#define GS_PARAMETER_LOG_VERSION 1
+#define GS_PARAMETER_LOG_BYTE_ORDER_MARK 0x01020304U
 
 
 
 namespace GS {
 
+/*******************************************************************************
+ * Binary log file format (native byte order):
+ *
+ * ParameterLogHeader
+ * for each channel:
+ *     uint32_t name length
+ *     name (without the terminating null character)
+ * frames:
+ *     one value per channel, of valueSize bytes
+ *
+ * The number of frames is not stored. It is calculated from the file size,
+ * so a file that was not closed is still readable.
+ */
+struct ParameterLogHeader {
+	char     magic[8];      // GS_PARAMETER_LOG_MAGIC
+	uint32_t byteOrderMark; // GS_PARAMETER_LOG_BYTE_ORDER_MARK
+	uint32_t version;
+	uint32_t valueSize;     // 4 (float) or 8 (double)
+	uint32_t numChannels;
+	uint32_t decimation;
+	uint32_t reserved;
+	double   frameRate;     // frames per second in the file
+};
+
+// Logs internal signals of the vocal tract models.
+//
+// The values of each frame are set with put(), and nextFrame() stores them.
+// Only one of each "decimation" frames is stored. The frames are kept in a
+// preallocated buffer, which is written to the file when it is full, so
+// put() and nextFrame() do not allocate memory.
 template<typename T>
 class ParameterLogger {
 public:
-	ParameterLogger() = default;
+	ParameterLogger();
 	~ParameterLogger() noexcept;
 
-	void put(unsigned int param, T value, const char* fileName) noexcept;
+	// frameRate: number of calls of nextFrame() per second.
+	void open(const std::string& filePath, const std::vector<std::string>& channelNames,
+			double frameRate, unsigned int decimation);
+	void close() noexcept;
+	bool isOpen() const noexcept { return out_.is_open(); }
+
+	void put(unsigned int channel, T value) noexcept {
+		if (decimationCounter_ == 0 && channel < numChannels_) {
+			buffer_[bufferPos_ + channel] = value;
+		}
+	}
+	void nextFrame() noexcept;
 private:
+	enum {
+		BUFFER_FRAMES = 16384
+	};
+
 	ParameterLogger(const ParameterLogger&) = delete;
 	ParameterLogger& operator=(const ParameterLogger&) = delete;
 	ParameterLogger(ParameterLogger&&) = delete;
 	ParameterLogger& operator=(ParameterLogger&&) = delete;
 
-	std::vector<std::pair<std::string, std::vector<T>>> data_;
+	void flush() noexcept;
+
+	std::ofstream out_;
+	std::string filePath_;
+	std::vector<T> buffer_;
+	std::size_t bufferPos_;
+	unsigned int numChannels_;
+	unsigned int decimation_;
+	unsigned int decimationCounter_;
 };
 
+// Converts a binary log to text files, one for each channel, named
+// <channel name>.txt, with one value per line.
+void convertParameterLogToText(const char* logFilePath, const char* outputDir);
+
+
+
+template<typename T>
+ParameterLogger<T>::ParameterLogger()
+		: bufferPos_()
+		, numChannels_()
+		, decimation_(1)
+		, decimationCounter_()
+{
+}
+
 template<typename T>
 ParameterLogger<T>::~ParameterLogger() noexcept
 {
-	try {
-		int i = -1;
-		for (const auto& param : data_) {
-			++i;
-			if (param.first.empty()) {
-				std::cerr << "[GS::ParameterLogger] Empty file name (parameter " << i << ")." << std::endl;
-				continue;
-			}
-			std::ofstream out(param.first, std::ios_base::binary);
-			if (!out) {
-				std::cerr << "[GS::ParameterLogger] Could not open the file " << param.first << '.' << std::endl;
-				continue;
-			}
-			for (const T value : param.second) {
-				out << value << '\n';
-			}
-		}
-	} catch (std::exception& e) {
-		std::cerr << "[ParameterLogger<T>::~ParameterLogger] Exception: " << e.what() << std::endl;
-	} catch (...) {
-		std::cerr << "[ParameterLogger<T>::~ParameterLogger] Unknown exception." << std::endl;
+	close();
+}
+
+template<typename T>
+void
+ParameterLogger<T>::open(const std::string& filePath, const std::vector<std::string>& channelNames,
+				double frameRate, unsigned int decimation)
+{
+	close();
+
+	if (channelNames.empty()) {
+		THROW_EXCEPTION(InvalidParameterException, "[ParameterLogger] No channels.");
 	}
+	if (decimation == 0) {
+		THROW_EXCEPTION(InvalidParameterException, "[ParameterLogger] Invalid decimation: " << decimation << '.');
+	}
+
+	out_.open(filePath, std::ios_base::binary);
+	if (!out_) {
+		THROW_EXCEPTION(IOException, "[ParameterLogger] Could not open the file " << filePath << '.');
+	}
+
+	ParameterLogHeader header{};
+	std::memcpy(header.magic, GS_PARAMETER_LOG_MAGIC, sizeof(header.magic));
+	header.byteOrderMark = GS_PARAMETER_LOG_BYTE_ORDER_MARK;
+	header.version       = GS_PARAMETER_LOG_VERSION;
+	header.valueSize     = sizeof(T);
+	header.numChannels   = channelNames.size();
+	header.decimation    = decimation;
+	header.frameRate     = frameRate / decimation;
+	out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	for (const auto& name : channelNames) {
+		const uint32_t size = name.size();
+		out_.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		out_.write(name.data(), size);
+	}
+	if (!out_) {
+		THROW_EXCEPTION(IOException, "[ParameterLogger] Could not write to the file " << filePath << '.');
+	}
+
+	filePath_ = filePath;
+	numChannels_ = channelNames.size();
+	buffer_.assign(static_cast<std::size_t>(BUFFER_FRAMES) * numChannels_, T{});
+	bufferPos_ = 0;
+	decimation_ = decimation;
+	decimationCounter_ = 0;
 }
 
 template<typename T>
 void
-ParameterLogger<T>::put(unsigned int param, T value, const char* fileName) noexcept
+ParameterLogger<T>::close() noexcept
 {
-	try {
-		if (data_.size() <= param) {
-			data_.resize(param + 1);
+	if (!out_.is_open()) return;
+
+	flush();
+	out_.close();
+	numChannels_ = 0;
+}
+
+template<typename T>
+void
+ParameterLogger<T>::nextFrame() noexcept
+{
+	if (numChannels_ == 0) return;
+
+	if (decimationCounter_ == 0) {
+		bufferPos_ += numChannels_;
+		if (bufferPos_ == buffer_.size()) {
+			flush();
 		}
-		if (data_[param].first.empty()) { // empty file name
-			data_[param].first = std::string(fileName) + ".txt";
+	}
+	if (++decimationCounter_ == decimation_) {
+		decimationCounter_ = 0;
+	}
+}
+
+template<typename T>
+void
+ParameterLogger<T>::flush() noexcept
+{
+	if (bufferPos_ > 0 && out_) {
+		out_.write(reinterpret_cast<const char*>(buffer_.data()), bufferPos_ * sizeof(T));
+		if (!out_) {
+			std::cerr << "[GS::ParameterLogger] Could not write to the file " << filePath_ << '.' << std::endl;
 		}
-		data_[param].second.push_back(value);
-	} catch (std::exception& e) {
-		std::cerr << "[ParameterLogger<T>::put] Exception: " << e.what() << std::endl;
-	} catch (...) {
-		std::cerr << "[ParameterLogger<T>::put] Unknown exception." << std::endl;
 	}
+	bufferPos_ = 0;
 }
 
 } /* namespace GS */
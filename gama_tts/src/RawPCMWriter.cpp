@@ -0,0 +1,75 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "RawPCMWriter.h"
+
+#include "Exception.h"
+
+
+
+namespace GS {
+
+RawPCMWriter::RawPCMWriter(FILE* stream, Format format)
+		: stream_(stream)
+		, format_(format)
+{
+	buffer_.reserve(BUFFER_SIZE);
+}
+
+void
+RawPCMWriter::writeSamples(const float* samples, std::size_t numSamples, float gain)
+{
+	for (std::size_t i = 0; i < numSamples; ++i) {
+		putSample(samples[i] * gain);
+	}
+}
+
+void
+RawPCMWriter::flush()
+{
+	writeBuffer();
+	if (fflush(stream_) != 0) {
+		THROW_EXCEPTION(IOException, "Could not flush the PCM output.");
+	}
+}
+
+void
+RawPCMWriter::writeBuffer()
+{
+	if (buffer_.empty()) return;
+
+	if (fwrite(buffer_.data(), 1, buffer_.size(), stream_) != buffer_.size()) {
+		buffer_.clear();
+		THROW_EXCEPTION(IOException, "Could not write the PCM output.");
+	}
+	buffer_.clear();
+}
+
+bool
+RawPCMWriter::getFormat(const char* name, Format& format)
+{
+	if (std::strcmp(name, "s16le") == 0) {
+		format = Format::s16le;
+	} else if (std::strcmp(name, "f32le") == 0) {
+		format = Format::f32le;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+} /* namespace GS */
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef RAW_PCM_WRITER_H_
+#define RAW_PCM_WRITER_H_
+
+#include <cmath> /* round */
+#include <cstddef> /* std::size_t */
+#include <cstdint>
+#include <cstdio>
+#include <cstring> /* memcpy */
+#include <vector>
+
+
+
+namespace GS {
+
+// Writes headerless PCM to a stream (e.g. stdout).
+//
+// The samples are converted into a buffer, which is written when full
+// or when flush() is called. The stream is not closed.
+class RawPCMWriter {
+public:
+	enum class Format {
+		s16le, // 16-bit signed integer, little-endian
+		f32le  // 32-bit IEEE float, little-endian
+	};
+
+	RawPCMWriter(FILE* stream, Format format);
+	~RawPCMWriter() = default;
+
+	// Writes interleaved samples, multiplied by gain.
+	// samples: [-1.0, 1.0] after the multiplication by gain
+	void writeSamples(const float* samples, std::size_t numSamples, float gain = 1.0f);
+
+	// Writes the buffer and flushes the stream.
+	void flush();
+
+	// Returns false if the name is invalid.
+	static bool getFormat(const char* name, Format& format);
+private:
+	enum {
+		BUFFER_SIZE = 65536 /* bytes */
+	};
+
+	RawPCMWriter(const RawPCMWriter&) = delete;
+	RawPCMWriter& operator=(const RawPCMWriter&) = delete;
+	RawPCMWriter(RawPCMWriter&&) = delete;
+	RawPCMWriter& operator=(RawPCMWriter&&) = delete;
+
+	void putSample(float sample) {
+		if (format_ == Format::s16le) {
+			const int data = static_cast<int>(std::round(sample * INT16_MAX));
+			buffer_.push_back( data       & 0xff);
+			buffer_.push_back((data >> 8) & 0xff);
+		} else {
+			std::uint32_t data;
+			std::memcpy(&data, &sample, sizeof data);
+			buffer_.push_back( data        & 0xff);
+			buffer_.push_back((data >> 8)  & 0xff);
+			buffer_.push_back((data >> 16) & 0xff);
+			buffer_.push_back((data >> 24) & 0xff);
+		}
+		if (buffer_.size() >= BUFFER_SIZE) writeBuffer();
+	}
+	void writeBuffer();
+
+	FILE* stream_;
+	const Format format_;
+	std::vector<unsigned char> buffer_;
+};
+
+} /* namespace GS */
+
+#endif /* RAW_PCM_WRITER_H_ */
@@ -0,0 +1,330 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "VoicePool.h"
+
+#include <cstddef> /* std::size_t */
+#include <stdexcept> /* invalid_argument, out_of_range */
+
+#include "ConfigurationData.h"
+#include "Controller.h"
+#include "Exception.h"
+#include "Index.h"
+#include "Model.h"
+#include "TextParser.h"
+#include "VTMControlModelConfiguration.h"
+
+
+
+namespace {
+
+double
+convertDouble(const std::string& key, const std::string& s)
+{
+	try {
+		std::size_t pos;
+		const double value = std::stod(s, &pos);
+		if (pos == s.size()) return value;
+	} catch (const std::invalid_argument&) {
+	} catch (const std::out_of_range&) {
+	}
+	THROW_EXCEPTION(GS::InvalidValueException, "Invalid value for key '" << key << "': " << s << '.');
+}
+
+int
+convertInt(const std::string& key, const std::string& s)
+{
+	try {
+		std::size_t pos;
+		const int value = std::stoi(s, &pos);
+		if (pos == s.size()) return value;
+	} catch (const std::invalid_argument&) {
+	} catch (const std::out_of_range&) {
+	}
+	THROW_EXCEPTION(GS::InvalidValueException, "Invalid value for key '" << key << "': " << s << '.');
+}
+
+double
+convertPositiveDouble(const std::string& key, const std::string& s)
+{
+	const double value = convertDouble(key, s);
+	if (!(value > 0.0)) {
+		THROW_EXCEPTION(GS::InvalidValueException, "The value for key '" << key << "' must be > 0.");
+	}
+	return value;
+}
+
+} /* namespace */
+
+namespace GS {
+
+// The overridable values.
+struct VoicePool::Settings {
+	double tempo;
+	double pitchOffset;
+	double driftDeviation;
+	double driftLowpassCutoff;
+	bool microIntonation;
+	bool macroIntonation;
+	bool smoothIntonation;
+	bool intonationDrift;
+	bool randomIntonation;
+	int outputRate;
+};
+
+struct VoicePool::Entry {
+	std::unique_ptr<VTMControlModel::Controller> controller;
+	std::unique_ptr<TextParser::TextParser> textParser;
+	bool busy;
+};
+
+struct VoicePool::Voice {
+	Index index;
+	VTMControlModel::Model model;
+	Settings defaultSettings;
+	std::vector<std::unique_ptr<Entry>> entryList;
+
+	explicit Voice(const char* dataDir) : index{dataDir}, defaultSettings() {}
+};
+
+VoicePool::Lease::Lease(VoicePool& pool, Voice& voice, Entry& entry) noexcept
+		: pool_(&pool)
+		, voice_(&voice)
+		, entry_(&entry)
+{
+}
+
+VoicePool::Lease::Lease(Lease&& other) noexcept
+		: pool_(other.pool_)
+		, voice_(other.voice_)
+		, entry_(other.entry_)
+{
+	other.pool_ = nullptr;
+	other.voice_ = nullptr;
+	other.entry_ = nullptr;
+}
+
+VoicePool::Lease::~Lease()
+{
+	if (pool_) pool_->release(*voice_, *entry_);
+}
+
+VTMControlModel::Controller&
+VoicePool::Lease::controller()
+{
+	return *entry_->controller;
+}
+
+TextParser::TextParser&
+VoicePool::Lease::textParser()
+{
+	return *entry_->textParser;
+}
+
+VoicePool::VoicePool()
+{
+}
+
+VoicePool::~VoicePool()
+{
+}
+
+void
+VoicePool::addVoice(const std::string& name, const char* dataDir, unsigned int numControllers)
+{
+	if (numControllers == 0) {
+		THROW_EXCEPTION(InvalidParameterException, "[VoicePool::addVoice] The number of controllers must be > 0.");
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (voiceMap_.find(name) != voiceMap_.end()) {
+			THROW_EXCEPTION(InvalidParameterException, "[VoicePool::addVoice] Duplicate voice: " << name << '.');
+		}
+	}
+
+	// The voice is loaded without holding the lock.
+	auto voice = std::make_unique<Voice>(dataDir);
+	voice->model.load(voice->index);
+	for (unsigned int i = 0; i < numControllers; ++i) {
+		auto entry = std::make_unique<Entry>();
+		entry->controller = std::make_unique<VTMControlModel::Controller>(voice->index, voice->model);
+		entry->textParser = TextParser::TextParser::getInstance(
+						voice->index,
+						entry->controller->vtmControlModelConfiguration().phoStrFormat);
+		entry->busy = false;
+		voice->entryList.push_back(std::move(entry));
+	}
+	getSettings(*voice->entryList.front()->controller, voice->defaultSettings);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!voiceMap_.emplace(name, std::move(voice)).second) {
+		THROW_EXCEPTION(InvalidParameterException, "[VoicePool::addVoice] Duplicate voice: " << name << '.');
+	}
+}
+
+VoicePool::Lease
+VoicePool::acquire(const std::string& voiceName, const Overrides& overrides)
+{
+	Voice* voice;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto iter = voiceMap_.find(voiceName);
+		if (iter == voiceMap_.end()) {
+			THROW_EXCEPTION(InvalidParameterException, "[VoicePool::acquire] Voice not found: " << voiceName << '.');
+		}
+		voice = iter->second.get();
+	}
+
+	// Validate all the values before acquiring the controller.
+	Settings settings = voice->defaultSettings;
+	applyOverrides(overrides, settings);
+
+	Entry* entry = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;) {
+			for (auto& e : voice->entryList) {
+				if (!e->busy) {
+					entry = e.get();
+					break;
+				}
+			}
+			if (entry) break;
+			entryReleasedCondition_.wait(lock);
+		}
+		entry->busy = true;
+	}
+
+	Lease lease{*this, *voice, *entry};
+	if (!overrides.empty()) {
+		applySettings(settings, *entry->controller);
+	}
+	return lease;
+}
+
+void
+VoicePool::release(Voice& voice, Entry& entry) noexcept
+{
+	try {
+		applySettings(voice.defaultSettings, *entry.controller);
+	} catch (...) {
+		// The controller may be in an inconsistent state.
+		// It is not returned to the pool.
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		entry.busy = false;
+	}
+	entryReleasedCondition_.notify_all();
+}
+
+void
+VoicePool::getSettings(VTMControlModel::Controller& controller, Settings& settings)
+{
+	const VTMControlModel::Configuration& config = controller.vtmControlModelConfiguration();
+	settings.tempo              = config.tempo;
+	settings.pitchOffset        = config.pitchOffset;
+	settings.driftDeviation     = config.driftDeviation;
+	settings.driftLowpassCutoff = config.driftLowpassCutoff;
+	settings.microIntonation    = config.microIntonation;
+	settings.macroIntonation    = config.macroIntonation;
+	settings.smoothIntonation   = config.smoothIntonation;
+	settings.intonationDrift    = config.intonationDrift;
+	settings.randomIntonation   = config.randomIntonation;
+	settings.outputRate         = controller.vtmConfigData().value<int>("output_rate");
+}
+
+// The Configuration values are read by the controller at the start of
+// each utterance, so changing them is cheap. The vocal tract model is
+// updated only if the output rate has changed.
+void
+VoicePool::applySettings(const Settings& settings, VTMControlModel::Controller& controller)
+{
+	VTMControlModel::Configuration& config = controller.vtmControlModelConfiguration();
+	config.tempo              = settings.tempo;
+	config.pitchOffset        = settings.pitchOffset;
+	config.driftDeviation     = settings.driftDeviation;
+	config.driftLowpassCutoff = settings.driftLowpassCutoff;
+	config.microIntonation    = settings.microIntonation;
+	config.macroIntonation    = settings.macroIntonation;
+	config.smoothIntonation   = settings.smoothIntonation;
+	config.intonationDrift    = settings.intonationDrift;
+	config.randomIntonation   = settings.randomIntonation;
+	controller.setOutputSampleRate(settings.outputRate);
+}
+
+void
+VoicePool::applyOverrides(const Overrides& overrides, Settings& settings)
+{
+	for (const auto& item : overrides) {
+		const std::string& key = item.first;
+		const std::string& value = item.second;
+		if (key == "tempo") {
+			settings.tempo = convertPositiveDouble(key, value);
+		} else if (key == "pitch_offset") {
+			settings.pitchOffset = convertDouble(key, value);
+		} else if (key == "drift_deviation") {
+			settings.driftDeviation = convertDouble(key, value);
+			if (settings.driftDeviation < 0.0) {
+				THROW_EXCEPTION(InvalidValueException, "The value for key '" << key << "' must be >= 0.");
+			}
+		} else if (key == "drift_lowpass_cutoff") {
+			settings.driftLowpassCutoff = convertPositiveDouble(key, value);
+		} else if (key == "micro_intonation") {
+			settings.microIntonation = (convertInt(key, value) != 0);
+		} else if (key == "macro_intonation") {
+			settings.macroIntonation = (convertInt(key, value) != 0);
+		} else if (key == "smooth_intonation") {
+			settings.smoothIntonation = (convertInt(key, value) != 0);
+		} else if (key == "intonation_drift") {
+			settings.intonationDrift = (convertInt(key, value) != 0);
+		} else if (key == "random_intonation") {
+			settings.randomIntonation = (convertInt(key, value) != 0);
+		} else if (key == "output_rate") {
+			settings.outputRate = convertInt(key, value);
+			if (settings.outputRate <= 0) {
+				THROW_EXCEPTION(InvalidValueException, "The value for key '" << key << "' must be > 0.");
+			}
+		} else {
+			THROW_EXCEPTION(InvalidParameterException, "[VoicePool::applyOverrides] The key '" << key << "' can not be overridden.");
+		}
+	}
+}
+
+bool
+VoicePool::isOverridable(const std::string& key)
+{
+	static const char* const keyList[] = {
+		"tempo",
+		"pitch_offset",
+		"drift_deviation",
+		"drift_lowpass_cutoff",
+		"micro_intonation",
+		"macro_intonation",
+		"smooth_intonation",
+		"intonation_drift",
+		"random_intonation",
+		"output_rate"
+	};
+	for (const char* k : keyList) {
+		if (key == k) return true;
+	}
+	return false;
+}
+
+} /* namespace GS */
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef VOICE_POOL_H_
+#define VOICE_POOL_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace GS {
+
+class Index;
+namespace TextParser {
+class TextParser;
+}
+namespace VTMControlModel {
+class Controller;
+class Model;
+}
+
+// Pool of preloaded voices.
+//
+// Each voice has a fixed number of controllers (with their text parsers),
+// created by addVoice(). A request acquires one of them with acquire(),
+// which may override some configuration values for that request only.
+// The overrides are applied to the existing objects, and the default
+// values are restored when the lease is destroyed.
+//
+// Overridable keys (same names and formats as in the configuration files):
+//   tempo, pitch_offset, drift_deviation, drift_lowpass_cutoff,
+//   micro_intonation, macro_intonation, smooth_intonation,
+//   intonation_drift, random_intonation, output_rate
+//
+// The methods of VoicePool are thread-safe. A Lease must be used
+// by one thread at a time.
+class VoicePool {
+private:
+	struct Settings;
+	struct Entry;
+	struct Voice;
+public:
+	typedef std::unordered_map<std::string, std::string> Overrides;
+
+	// Exclusive access to one controller of the pool.
+	class Lease {
+	public:
+		Lease(Lease&& other) noexcept;
+		// Restores the default values and returns the controller to the pool.
+		~Lease();
+
+		VTMControlModel::Controller& controller();
+		TextParser::TextParser& textParser();
+	private:
+		friend class VoicePool;
+
+		Lease(VoicePool& pool, Voice& voice, Entry& entry) noexcept;
+		Lease(const Lease&) = delete;
+		Lease& operator=(const Lease&) = delete;
+		Lease& operator=(Lease&&) = delete;
+
+		VoicePool* pool_;
+		Voice* voice_;
+		Entry* entry_;
+	};
+
+	VoicePool();
+	~VoicePool();
+
+	// Loads a voice and creates numControllers controllers for it.
+	// The name must be unique.
+	void addVoice(const std::string& name, const char* dataDir, unsigned int numControllers);
+
+	// Waits until a controller of the voice is available.
+	// Throws InvalidParameterException if a key is not overridable,
+	// and InvalidValueException if a value is invalid. In these cases
+	// no controller is acquired.
+	Lease acquire(const std::string& voiceName, const Overrides& overrides = Overrides());
+
+	static bool isOverridable(const std::string& key);
+private:
+	VoicePool(const VoicePool&) = delete;
+	VoicePool& operator=(const VoicePool&) = delete;
+	VoicePool(VoicePool&&) = delete;
+	VoicePool& operator=(VoicePool&&) = delete;
+
+	static void getSettings(VTMControlModel::Controller& controller, Settings& settings);
+	static void applySettings(const Settings& settings, VTMControlModel::Controller& controller);
+	static void applyOverrides(const Overrides& overrides, Settings& settings);
+	void release(Voice& voice, Entry& entry) noexcept;
+
+	std::unordered_map<std::string, std::unique_ptr<Voice>> voiceMap_;
+	std::mutex mutex_;
+	std::condition_variable entryReleasedCondition_;
+};
+
+} /* namespace GS */
+
+#endif /* VOICE_POOL_H_ */
@@ -25,30 +25,99 @@
 #include "Exception.h"
 
 #include <cmath> /* ceil, round */
-#include <cstdint>
 
 
 
-#define BITS_PER_SAMPLE 16
+#define UNKNOWN_SIZE 0xFFFFFFFFU
+#define RIFF_SIZE_OFFSET 4
+#define WAVE_FORMAT_PCM 0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+#define SPEAKER_FRONT_LEFT 0x1
+#define SPEAKER_FRONT_RIGHT 0x2
+#define SPEAKER_FRONT_CENTER 0x4
 
 
 
+namespace {
+
+bool
+isLittleEndian()
+{
+	const std::uint32_t value = 1;
+	unsigned char firstByte;
+	std::memcpy(&firstByte, &value, 1);
+	return firstByte == 1;
+}
+
+} /* namespace */
+
 namespace GS {
 
-WAVEFileWriter::WAVEFileWriter(const char* filePath, int channels, int numberSamples, float outputRate)
-		: sampleScale_(INT16_MAX)
+WAVEFileWriter::WAVEFileWriter(const char* filePath, int channels, float outputRate, Format format)
+		: format_(format)
+		, seekable_()
+		, sampleScale_()
+		, channels_(channels)
+		, bytesPerSample_()
+		, factSizeOffset_()
+		, dataSizeOffset_()
+		, headerSize_()
+		, dataChunkSize_()
 {
+	switch (format_) {
+	case Format::pcm16:
+		sampleScale_ = INT16_MAX;
+		bytesPerSample_ = 2;
+		break;
+	case Format::pcm24:
+		sampleScale_ = 8388607.0f; // 2^23 - 1
+		bytesPerSample_ = 3;
+		break;
+	case Format::float32:
+		sampleScale_ = 1.0f;
+		bytesPerSample_ = 4;
+		break;
+	}
+
 	stream_ = fopen(filePath, "wb"); // the b is for non-POSIX systems
 	if (stream_ == NULL) {
 		THROW_EXCEPTION(IOException, "Could not open the file " << filePath << " for writing.");
 	}
+	seekable_ = (fseek(stream_, 0, SEEK_CUR) == 0);
 
-	writeWaveFileHeader(channels, numberSamples, outputRate);
+	buffer_.reserve(BUFFER_SIZE);
+
+	writeWaveFileHeader(channels, outputRate);
 }
 
 WAVEFileWriter::~WAVEFileWriter()
 {
-	fclose(stream_);
+	try {
+		close();
+	} catch (...) {
+		// Ignore.
+	}
+}
+
+void
+WAVEFileWriter::close()
+{
+	if (stream_ == NULL) return;
+
+	FILE* stream = stream_;
+	try {
+		flushBuffer();
+		if (seekable_) updateSizes();
+	} catch (...) {
+		stream_ = NULL;
+		fclose(stream);
+		throw;
+	}
+	stream_ = NULL;
+	if (fclose(stream) != 0) {
+		THROW_EXCEPTION(IOException, "Could not close the WAVE file.");
+	}
 }
 
 /******************************************************************************
@@ -56,21 +125,32 @@ WAVEFileWriter::~WAVEFileWriter()
 *       function:       writeWaveFileHeader
 *
 *       purpose:        Writes the header in WAVE format to the output file.
+*                       The sizes are provisional.
+*
+*                       16-bit PCM uses the basic format chunk. The other
+*                       formats use WAVE_FORMAT_EXTENSIBLE, and the float
+*                       format has a fact chunk.
 *
 ******************************************************************************/
 void
-WAVEFileWriter::writeWaveFileHeader(int channels, int numberSamples, float outputRate)
+WAVEFileWriter::writeWaveFileHeader(int channels, float outputRate)
 {
-	int dataChunkSize = channels * numberSamples * sizeof(std::int16_t);
-	int formSize = 4 + 24 + (8 + dataChunkSize);
-	int frameSize = static_cast<int>(std::ceil(channels * (BITS_PER_SAMPLE / 8.0)));
+	const bool extensible = (format_ != Format::pcm16);
+	const bool hasFact = (format_ == Format::float32);
+	const int bitsPerSample = bytesPerSample_ * 8;
+	const int fmtChunkSize = extensible ? 40 : 16;
+	int frameSize = channels * bytesPerSample_;
 	int bytesPerSecond = static_cast<int>(std::ceil(outputRate * frameSize));
 
+	factSizeOffset_ = hasFact ? 12 + (8 + fmtChunkSize) + 8 : 0;
+	dataSizeOffset_ = 12 + (8 + fmtChunkSize) + (hasFact ? 12 : 0) + 4;
+	headerSize_ = dataSizeOffset_ + 4;
+
 	/*  Form container identifier  */
 	fputs("RIFF", stream_);
 
 	/*  Form size  */
-	writeUInt32LE(formSize);
+	writeUInt32LE(seekable_ ? static_cast<std::uint32_t>(headerSize_ - 8) : UNKNOWN_SIZE);
 
 	/*  Form container type  */
 	fputs("WAVE", stream_);
@@ -78,11 +158,11 @@ WAVEFileWriter::writeWaveFileHeader(int channels, int numberSamples, float outpu
 	/*  Format chunk identifier (Note: space after 't' needed)  */
 	fputs("fmt ", stream_);
 
-	/*  Chunk size (fixed at 16 bytes)  */
-	writeUInt32LE(16);
+	/*  Chunk size  */
+	writeUInt32LE(fmtChunkSize);
 
-	/*  Compression code: 1 = PCM  */
-	writeUInt16LE(1);
+	/*  Compression code  */
+	writeUInt16LE(extensible ? WAVE_FORMAT_EXTENSIBLE : WAVE_FORMAT_PCM);
 
 	/*  Number of channels  */
 	writeUInt16LE(channels);
@@ -97,22 +177,117 @@ WAVEFileWriter::writeWaveFileHeader(int channels, int numberSamples, float outpu
 	writeUInt16LE(frameSize);
 
 	/*  Bits per sample  */
-	writeUInt16LE(BITS_PER_SAMPLE);
+	writeUInt16LE(bitsPerSample);
+
+	if (extensible) {
+		/*  Size of the extension  */
+		writeUInt16LE(22);
+
+		/*  Valid bits per sample  */
+		writeUInt16LE(bitsPerSample);
+
+		/*  Channel mask  */
+		if (channels == 1) {
+			writeUInt32LE(SPEAKER_FRONT_CENTER);
+		} else if (channels == 2) {
+			writeUInt32LE(SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT);
+		} else {
+			writeUInt32LE(0);
+		}
+
+		/*  Sub-format GUID: the format code + KSDATAFORMAT_SUBTYPE suffix  */
+		static const unsigned char guidSuffix[14] = {
+			0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+		};
+		writeUInt16LE(format_ == Format::float32 ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+		fwrite(guidSuffix, 1, sizeof guidSuffix, stream_);
+	}
+
+	if (hasFact) {
+		/*  Fact chunk: number of sample frames  */
+		fputs("fact", stream_);
+		writeUInt32LE(4);
+		writeUInt32LE(seekable_ ? 0 : UNKNOWN_SIZE);
+	}
 
 	/*  Sound Data chunk identifier  */
 	fputs("data", stream_);
 
 	/*  Chunk size  */
-	writeUInt32LE(dataChunkSize);
+	writeUInt32LE(seekable_ ? 0 : UNKNOWN_SIZE);
+
+	if (ferror(stream_)) {
+		THROW_EXCEPTION(IOException, "Could not write the WAVE file header.");
+	}
+}
+
+/******************************************************************************
+*
+*       function:       updateSizes
+*
+*       purpose:        Writes the final form and data chunk sizes in the
+*                       header. If the data does not fit in a 32-bit
+*                       size, the sizes are set to "unknown".
+*
+******************************************************************************/
+void
+WAVEFileWriter::updateSizes()
+{
+	const std::uint64_t formSize = (headerSize_ - 8) + dataChunkSize_;
+	const bool fits = formSize < UNKNOWN_SIZE;
+
+	if (fseek(stream_, RIFF_SIZE_OFFSET, SEEK_SET) != 0) {
+		THROW_EXCEPTION(IOException, "Could not update the WAVE file header.");
+	}
+	writeUInt32LE(fits ? static_cast<std::uint32_t>(formSize) : UNKNOWN_SIZE);
+
+	if (factSizeOffset_ != 0) {
+		if (fseek(stream_, factSizeOffset_, SEEK_SET) != 0) {
+			THROW_EXCEPTION(IOException, "Could not update the WAVE file header.");
+		}
+		const std::uint64_t numFrames = dataChunkSize_ / (channels_ * bytesPerSample_);
+		writeUInt32LE(numFrames < UNKNOWN_SIZE ? static_cast<std::uint32_t>(numFrames) : UNKNOWN_SIZE);
+	}
+
+	if (fseek(stream_, dataSizeOffset_, SEEK_SET) != 0) {
+		THROW_EXCEPTION(IOException, "Could not update the WAVE file header.");
+	}
+	writeUInt32LE(fits ? static_cast<std::uint32_t>(dataChunkSize_) : UNKNOWN_SIZE);
+
+	if (fflush(stream_) != 0) {
+		THROW_EXCEPTION(IOException, "Could not update the WAVE file header.");
+	}
+}
+
+void
+WAVEFileWriter::flushBuffer()
+{
+	if (buffer_.empty()) return;
+
+	try {
+		writeData(buffer_.data(), buffer_.size());
+	} catch (...) {
+		buffer_.clear();
+		throw;
+	}
+	buffer_.clear();
+}
+
+void
+WAVEFileWriter::writeData(const void* data, std::size_t size)
+{
+	if (fwrite(data, 1, size, stream_) != size) {
+		THROW_EXCEPTION(IOException, "Could not write to the WAVE file.");
+	}
+	dataChunkSize_ += size;
 }
 
 /******************************************************************************
 *
 *       function:       writeSample
 *
-*       purpose:        Reads the double f.p. samples in the temporary file,
-*                       scales them, rounds them to a short (16-bit) integer,
-*                       and writes them to the output file in little-endian
+*       purpose:        Converts the sample to the output format, and
+*                       writes it to the output file in little-endian
 *                       format.
 *
 *       sample: [-1.0, 1.0]
@@ -121,17 +296,16 @@ WAVEFileWriter::writeWaveFileHeader(int channels, int numberSamples, float outpu
 void
 WAVEFileWriter::writeSample(float sample)
 {
-	writeUInt16LE(static_cast<int>(std::round(sample * sampleScale_)));
+	putSample(sample);
 }
 
 /******************************************************************************
 *
 *       function:       writeStereoSamples
 *
-*       purpose:        Reads the double f.p. samples in the temporary file,
-*                       does stereo scaling, rounds them to a short (16-bit)
-*                       integer, and writes them to the output file in
-*                       little-endian format.
+*       purpose:        Converts the samples to the output format, and
+*                       writes them to the output file in little-endian
+*                       format.
 *
 *       leftSample, rightSample: [-1.0, 1.0]
 *
@@ -139,8 +313,49 @@ WAVEFileWriter::writeSample(float sample)
 void
 WAVEFileWriter::writeStereoSamples(float leftSample, float rightSample)
 {
-	writeUInt16LE(static_cast<int>(std::round(leftSample * sampleScale_)));
-	writeUInt16LE(static_cast<int>(std::round(rightSample * sampleScale_)));
+	putSample(leftSample);
+	putSample(rightSample);
+}
+
+/******************************************************************************
+*
+*       function:       writeSamples
+*
+*       purpose:        Writes a block of interleaved samples.
+*                       Float samples with unity gain are written
+*                       directly on little-endian systems.
+*
+*       samples: [-1.0, 1.0] after the multiplication by gain
+*
+******************************************************************************/
+void
+WAVEFileWriter::writeSamples(const float* samples, std::size_t numSamples, float gain)
+{
+	static const bool littleEndian = isLittleEndian();
+	if (format_ == Format::float32 && gain == 1.0f && littleEndian) {
+		flushBuffer();
+		writeData(samples, numSamples * sizeof(float));
+		return;
+	}
+
+	for (std::size_t i = 0; i < numSamples; ++i) {
+		putSample(samples[i] * gain);
+	}
+}
+
+bool
+WAVEFileWriter::getFormat(const char* name, Format& format)
+{
+	if (std::strcmp(name, "s16") == 0) {
+		format = Format::pcm16;
+	} else if (std::strcmp(name, "s24") == 0) {
+		format = Format::pcm24;
+	} else if (std::strcmp(name, "f32") == 0) {
+		format = Format::float32;
+	} else {
+		return false;
+	}
+	return true;
 }
 
 /******************************************************************************
@@ -154,7 +369,7 @@ WAVEFileWriter::writeStereoSamples(float leftSample, float rightSample)
 *
 ******************************************************************************/
 void
-WAVEFileWriter::writeUInt32LE(int data)
+WAVEFileWriter::writeUInt32LE(std::uint32_t data)
 {
 	unsigned char array[4];
 
@@ -23,33 +23,113 @@
 #ifndef WAVE_FILE_WRITER_H_
 #define WAVE_FILE_WRITER_H_
 
+#include <algorithm> /* clamp */
+#include <cmath> /* round */
+#include <cstddef> /* std::size_t */
+#include <cstdint>
 #include <cstdio>
+#include <cstring> /* memcpy */
+#include <vector>
 
 
 
 namespace GS {
 
-// Note: Almost no error checking.
-
+// Writes a WAVE file progressively.
+//
+// Formats: 16-bit PCM, 24-bit PCM (WAVE_FORMAT_EXTENSIBLE) and
+// 32-bit IEEE float (WAVE_FORMAT_EXTENSIBLE, with a fact chunk).
+// The integer formats clip the samples to [-1.0, 1.0]. The float format
+// stores the values unchanged, so samples outside this range are kept.
+//
+// A provisional header is written when the file is opened, and the sizes
+// in the header are updated by close(). If the file is not seekable
+// (e.g. a pipe), the sizes are set to 0xFFFFFFFF ("unknown length").
+// The samples are converted into a buffer, which is written in one call
+// when full.
 class WAVEFileWriter {
 public:
-	WAVEFileWriter(const char* filePath, int channels, int numberSamples, float outputRate);
+	enum class Format {
+		pcm16,
+		pcm24,
+		float32
+	};
+
+	WAVEFileWriter(const char* filePath, int channels, float outputRate, Format format = Format::pcm16);
 	~WAVEFileWriter();
 
 	void writeSample(float sample);
 	void writeStereoSamples(float leftSample, float rightSample);
+	// Writes interleaved samples, multiplied by gain.
+	// In the float format, if gain is 1.0, the samples are written without
+	// conversion on little-endian systems.
+	void writeSamples(const float* samples, std::size_t numSamples, float gain = 1.0f);
+
+	// Writes the remaining samples and updates the header.
+	// The destructor calls this function, but ignores the errors.
+	void close();
+
+	// Returns false if the name is invalid.
+	// Names: s16, s24, f32.
+	static bool getFormat(const char* name, Format& format);
 private:
+	enum {
+		BUFFER_SIZE = 65536 /* bytes */
+	};
+
 	WAVEFileWriter(const WAVEFileWriter&) = delete;
 	WAVEFileWriter& operator=(const WAVEFileWriter&) = delete;
 	WAVEFileWriter(WAVEFileWriter&&) = delete;
 	WAVEFileWriter& operator=(WAVEFileWriter&&) = delete;
 
-	void writeWaveFileHeader(int channels, int numberSamples, float outputRate);
-	void writeUInt32LE(int data);
+	void writeWaveFileHeader(int channels, float outputRate);
+	void updateSizes();
+	void flushBuffer();
+	void putSample(float sample) {
+		switch (format_) {
+		case Format::pcm16:
+			{
+				const int data = static_cast<int>(std::round(std::clamp(sample, -1.0f, 1.0f) * sampleScale_));
+				buffer_.push_back( data       & 0xff);
+				buffer_.push_back((data >> 8) & 0xff);
+			}
+			break;
+		case Format::pcm24:
+			{
+				const int data = static_cast<int>(std::round(std::clamp(sample, -1.0f, 1.0f) * sampleScale_));
+				buffer_.push_back( data        & 0xff);
+				buffer_.push_back((data >> 8)  & 0xff);
+				buffer_.push_back((data >> 16) & 0xff);
+			}
+			break;
+		case Format::float32:
+			{
+				std::uint32_t data;
+				std::memcpy(&data, &sample, sizeof data);
+				buffer_.push_back( data        & 0xff);
+				buffer_.push_back((data >> 8)  & 0xff);
+				buffer_.push_back((data >> 16) & 0xff);
+				buffer_.push_back((data >> 24) & 0xff);
+			}
+			break;
+		}
+		if (buffer_.size() >= BUFFER_SIZE) flushBuffer();
+	}
+	void writeData(const void* data, std::size_t size);
+	void writeUInt32LE(std::uint32_t data);
 	void writeUInt16LE(int data);
 
 	FILE* stream_;
+	const Format format_;
+	bool seekable_;
 	float sampleScale_;
+	int channels_;
+	int bytesPerSample_;
+	long factSizeOffset_; // 0: no fact chunk
+	long dataSizeOffset_;
+	std::uint64_t headerSize_;
+	std::uint64_t dataChunkSize_;
+	std::vector<unsigned char> buffer_;
 };
 
 } /* namespace GS */
@@ -0,0 +1,269 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "gama_tts.h"
+
+#include <algorithm> /* copy, min */
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new> /* bad_alloc */
+#include <string>
+#include <vector>
+
+#include "Controller.h"
+#include "Index.h"
+#include "Model.h"
+#include "TextParser.h"
+
+
+
+struct GamaTTSVoice {
+	GS::Index index;
+	GS::VTMControlModel::Model model;
+	std::unique_ptr<GS::TextParser::TextParser> textParser;
+	std::mutex textParserMutex;
+	double sampleRate;
+
+	explicit GamaTTSVoice(const char* dataDir) : index{dataDir}, sampleRate() {}
+};
+
+struct GamaTTSSession {
+	GamaTTSVoice& voice;
+	GS::VTMControlModel::Controller controller;
+	unsigned long defaultRandomSeed;
+	std::deque<std::string> chunkQueue;
+	std::vector<std::string> chunkList;
+	std::vector<float> audio;
+	std::size_t audioPos;
+
+	explicit GamaTTSSession(GamaTTSVoice& v)
+			: voice(v)
+			, controller(v.index, v.model)
+			, defaultRandomSeed(controller.vtmControlModelConfiguration().randomSeed)
+			, audioPos() {}
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+void
+setError(const char* message)
+{
+	try {
+		lastError = message;
+	} catch (...) {
+		// Ignore.
+	}
+}
+
+// Converts the current exception to an error code.
+int
+handleException()
+{
+	try {
+		throw;
+	} catch (const std::bad_alloc&) {
+		setError("Out of memory.");
+		return GAMA_TTS_ERROR_OUT_OF_MEMORY;
+	} catch (const std::exception& exc) {
+		setError(exc.what());
+		return GAMA_TTS_ERROR_SYNTHESIS;
+	} catch (...) {
+		setError("Unknown exception.");
+		return GAMA_TTS_ERROR_SYNTHESIS;
+	}
+}
+
+int
+invalidArgument(const char* message)
+{
+	setError(message);
+	return GAMA_TTS_ERROR_INVALID_ARGUMENT;
+}
+
+void
+queuePhoneticString(GamaTTSSession& session, const std::string& phoneticString)
+{
+	session.controller.splitPhoneticString(phoneticString, session.chunkList);
+	session.chunkQueue.insert(session.chunkQueue.end(), session.chunkList.begin(), session.chunkList.end());
+}
+
+} /* namespace */
+
+extern "C" {
+
+uint32_t
+gama_tts_api_version(void)
+{
+	return GAMA_TTS_API_VERSION;
+}
+
+const char*
+gama_tts_last_error(void)
+{
+	return lastError.c_str();
+}
+
+GamaTTSVoice*
+gama_tts_voice_load(const char* data_dir)
+{
+	if (!data_dir) {
+		invalidArgument("Null data directory.");
+		return nullptr;
+	}
+	try {
+		auto voice = std::make_unique<GamaTTSVoice>(data_dir);
+		voice->model.load(voice->index);
+
+		// A temporary controller provides the configuration
+		// that selects the text parser.
+		GS::VTMControlModel::Controller controller(voice->index, voice->model);
+		voice->textParser = GS::TextParser::TextParser::getInstance(
+						voice->index,
+						controller.vtmControlModelConfiguration().phoStrFormat);
+		voice->sampleRate = controller.outputSampleRate();
+		return voice.release();
+	} catch (...) {
+		handleException();
+		return nullptr;
+	}
+}
+
+void
+gama_tts_voice_free(GamaTTSVoice* voice)
+{
+	delete voice;
+}
+
+double
+gama_tts_voice_sample_rate(const GamaTTSVoice* voice)
+{
+	return voice ? voice->sampleRate : 0.0;
+}
+
+GamaTTSSession*
+gama_tts_session_create(GamaTTSVoice* voice)
+{
+	if (!voice) {
+		invalidArgument("Null voice.");
+		return nullptr;
+	}
+	try {
+		return new GamaTTSSession(*voice);
+	} catch (...) {
+		handleException();
+		return nullptr;
+	}
+}
+
+void
+gama_tts_session_free(GamaTTSSession* session)
+{
+	delete session;
+}
+
+int
+gama_tts_session_push_text(GamaTTSSession* session, const char* text)
+{
+	if (!session) return invalidArgument("Null session.");
+	if (!text) return invalidArgument("Null text.");
+	try {
+		std::string phoneticString;
+		{
+			std::lock_guard<std::mutex> lock(session->voice.textParserMutex);
+			phoneticString = session->voice.textParser->parse(text);
+		}
+		queuePhoneticString(*session, phoneticString);
+		return GAMA_TTS_OK;
+	} catch (...) {
+		return handleException();
+	}
+}
+
+int
+gama_tts_session_push_phonetic_string(GamaTTSSession* session, const char* phonetic_string)
+{
+	if (!session) return invalidArgument("Null session.");
+	if (!phonetic_string) return invalidArgument("Null phonetic string.");
+	try {
+		queuePhoneticString(*session, phonetic_string);
+		return GAMA_TTS_OK;
+	} catch (...) {
+		return handleException();
+	}
+}
+
+int32_t
+gama_tts_session_pull_audio(GamaTTSSession* session, float* buffer, uint32_t capacity)
+{
+	if (!session) return invalidArgument("Null session.");
+	if (!buffer && capacity > 0) return invalidArgument("Null buffer.");
+	try {
+		while (session->audioPos == session->audio.size()) {
+			if (session->chunkQueue.empty()) return 0;
+
+			const std::string chunk = std::move(session->chunkQueue.front());
+			session->chunkQueue.pop_front();
+			session->audioPos = 0;
+			session->audio.clear();
+			session->controller.synthesizePhoneticStringToBuffer(chunk, nullptr, session->audio);
+		}
+
+		const std::size_t available = session->audio.size() - session->audioPos;
+		const std::size_t n = std::min<std::size_t>({available, capacity, INT32_MAX});
+		std::copy(session->audio.begin() + session->audioPos,
+				session->audio.begin() + session->audioPos + n,
+				buffer);
+		session->audioPos += n;
+		return static_cast<int32_t>(n);
+	} catch (...) {
+		session->audio.clear();
+		session->audioPos = 0;
+		return handleException();
+	}
+}
+
+int
+gama_tts_session_reset(GamaTTSSession* session)
+{
+	if (!session) return invalidArgument("Null session.");
+	session->chunkQueue.clear();
+	session->audio.clear();
+	session->audioPos = 0;
+	return GAMA_TTS_OK;
+}
+
+int
+gama_tts_session_set_normalization(GamaTTSSession* session, int enabled)
+{
+	if (!session) return invalidArgument("Null session.");
+	session->controller.setOutputNormalization(enabled != 0);
+	return GAMA_TTS_OK;
+}
+
+int
+gama_tts_session_set_random_seed(GamaTTSSession* session, unsigned long seed)
+{
+	if (!session) return invalidArgument("Null session.");
+	session->controller.vtmControlModelConfiguration().randomSeed = (seed != 0) ? seed : session->defaultRandomSeed;
+	return GAMA_TTS_OK;
+}
+
+} /* extern "C" */
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*******************************************************************************
+ * C API of GamaTTS, version 1.
+ *
+ * A voice is loaded once with gama_tts_voice_load(), and shared by any
+ * number of synthesis sessions. Text or phonetic strings are pushed to a
+ * session, and the audio is pulled in blocks into buffers owned by the
+ * caller. The synthesis is done on demand by gama_tts_session_pull_audio(),
+ * one chunk (about one sentence) at a time.
+ *
+ * Thread safety:
+ *   - gama_tts_api_version(), gama_tts_last_error(), gama_tts_voice_load()
+ *     and the functions that receive a const voice may be called by any
+ *     thread at any time.
+ *   - gama_tts_session_create() may be called concurrently for the same
+ *     voice. The voice must not be freed while it has sessions.
+ *   - The functions that receive a session may be called by one thread at
+ *     a time for each session. Different sessions may be used in parallel,
+ *     also when they share a voice (the text parser of the voice is
+ *     protected by a lock).
+ *
+ * The functions that return int return GAMA_TTS_OK on success, or a
+ * negative error code. If a function fails, gama_tts_last_error() returns
+ * a description of the error, for the calling thread.
+ */
+
+#ifndef GAMA_TTS_C_API_H
+#define GAMA_TTS_C_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GAMA_TTS_API_VERSION 1U
+
+#if defined(_WIN32)
+# define GAMA_TTS_API
+#else
+# define GAMA_TTS_API __attribute__((visibility("default")))
+#endif
+
+/* Error codes. */
+#define GAMA_TTS_OK                      0
+#define GAMA_TTS_ERROR_INVALID_ARGUMENT (-1)
+#define GAMA_TTS_ERROR_SYNTHESIS        (-2)
+#define GAMA_TTS_ERROR_OUT_OF_MEMORY    (-3)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GamaTTSVoice GamaTTSVoice;
+typedef struct GamaTTSSession GamaTTSSession;
+
+/* Returns GAMA_TTS_API_VERSION of the library. */
+GAMA_TTS_API uint32_t gama_tts_api_version(void);
+
+/* Returns the message of the last error in the calling thread.
+   The string is valid until the next failed call in the same thread. */
+GAMA_TTS_API const char* gama_tts_last_error(void);
+
+/* Loads the voice in data_dir (e.g. data/voice/english/0_male).
+   Returns NULL on error. */
+GAMA_TTS_API GamaTTSVoice* gama_tts_voice_load(const char* data_dir);
+GAMA_TTS_API void gama_tts_voice_free(GamaTTSVoice* voice);
+
+/* Sample rate of the audio (Hz). */
+GAMA_TTS_API double gama_tts_voice_sample_rate(const GamaTTSVoice* voice);
+
+/* Creates a synthesis session. Returns NULL on error. */
+GAMA_TTS_API GamaTTSSession* gama_tts_session_create(GamaTTSVoice* voice);
+GAMA_TTS_API void gama_tts_session_free(GamaTTSSession* session);
+
+/* Converts the text (UTF-8) to a phonetic string, and queues it. */
+GAMA_TTS_API int gama_tts_session_push_text(GamaTTSSession* session, const char* text);
+
+/* Queues a phonetic string, in the format of the voice. */
+GAMA_TTS_API int gama_tts_session_push_phonetic_string(GamaTTSSession* session, const char* phonetic_string);
+
+/* Writes up to capacity samples (mono, float, [-1.0, 1.0] if normalized)
+   to buffer. Synthesizes the next queued chunk when the previous one has
+   been consumed.
+   Returns the number of samples written, 0 if the queue is empty, or a
+   negative error code. */
+GAMA_TTS_API int32_t gama_tts_session_pull_audio(GamaTTSSession* session, float* buffer, uint32_t capacity);
+
+/* Discards the queued input and the audio that has not been pulled. */
+GAMA_TTS_API int gama_tts_session_reset(GamaTTSSession* session);
+
+/* Normalization of each chunk (enabled by default). If disabled, the
+   range of the samples depends on the vocal tract model. */
+GAMA_TTS_API int gama_tts_session_set_normalization(GamaTTSSession* session, int enabled);
+
+/* Seed for the random intonation. 0: the seed of the voice configuration. */
+GAMA_TTS_API int gama_tts_session_set_random_seed(GamaTTSSession* session, unsigned long seed);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* GAMA_TTS_C_API_H */
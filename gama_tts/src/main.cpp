@@ -15,6 +15,7 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -22,6 +23,8 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility> /* pair */
+#include <vector>
 
 #include "Controller.h"
 #include "Exception.h"
@@ -29,10 +32,17 @@
 #include "Index.h"
 #include "Log.h"
 #include "Model.h"
+#include "ParameterLogger.h"
+#include "RawPCMWriter.h"
+#include "TextChunkReader.h"
 #include "TextParser.h"
 #include "VTMControlModelConfiguration.h"
+#include "WAVEFileWriter.h"
 
 #define PROGRAM_NAME "gama_tts"
+#define MAX_BUFFERED_TEXT_SIZE 65536
+#define MAX_SYNTHESIS_THREADS 256
+#define MAX_OUTPUT_SAMPLE_RATE 384000
 
 
 
@@ -46,6 +56,39 @@ isOption(const char* arg)
 	}
 }
 
+bool
+getSeed(const char* arg, unsigned long& seed)
+{
+	char* end;
+	errno = 0;
+	seed = std::strtoul(arg, &end, 10);
+	return errno == 0 && end != arg && *end == '\0' && seed != 0;
+}
+
+bool
+getNumberOfThreads(const char* arg, unsigned int& numThreads)
+{
+	char* end;
+	errno = 0;
+	const unsigned long n = std::strtoul(arg, &end, 10);
+	if (errno != 0 || end == arg || *end != '\0' || n == 0 || n > MAX_SYNTHESIS_THREADS) return false;
+	numThreads = static_cast<unsigned int>(n);
+	return true;
+}
+
+// Format: rate:file
+bool
+getRateOutput(const char* arg, std::pair<int, std::string>& rateOutput)
+{
+	char* end;
+	errno = 0;
+	const unsigned long rate = std::strtoul(arg, &end, 10);
+	if (errno != 0 || end == arg || *end != ':' || end[1] == '\0' || rate == 0 || rate > MAX_OUTPUT_SAMPLE_RATE) return false;
+	rateOutput.first = static_cast<int>(rate);
+	rateOutput.second = end + 1;
+	return true;
+}
+
 void
 showUsage()
 {
@@ -58,7 +101,9 @@ showUsage()
 		PROGRAM_NAME << " --version\n"
 		"    Shows the program version and usage.\n\n"
 
-		PROGRAM_NAME << " tts [-v] [-i input.txt] [-p vtm_param.txt] data_dir [speech.wav]\n"
+		PROGRAM_NAME << " tts [-v] [-d] [-n] [-i input.txt] [-p vtm_param.txt] [-s seed] [-f format] [-j threads] [-a rate:file.wav]... data_dir [speech.wav]\n"
+		PROGRAM_NAME << " tts [-v] [-d] [-n] [-c] [-i input.txt] [-s seed] [-f format] data_dir [speech.wav]\n"
+		PROGRAM_NAME << " tts [-v] [-d] [-n] [-c] [-i input.txt] [-s seed] -r format data_dir\n"
 		"    Converts text to speech.\n\n"
 		"    data_dir   : The directory containing the data and configuration files.\n"
 		"    speech.wav : This file will be created, and will contain the\n"
@@ -67,13 +112,50 @@ showUsage()
 		"    Options:\n"
 		"    -v\n"
 		"        Verbose.\n"
+		"    -d\n"
+		"        Draft mode. Faster synthesis with lower quality, for the vocal\n"
+		"        tract models 4 and 5.\n"
+		"    -n\n"
+		"        Do not normalize the output. The samples of the vocal tract\n"
+		"        model are written without scaling. Their range depends on the\n"
+		"        model, so use this with the f32 format (the integer formats\n"
+		"        clip the samples outside [-1.0, 1.0]).\n"
+		"    -c\n"
+		"        Read the input text incrementally, and synthesize it sentence by\n"
+		"        sentence while the rest is being read. Each chunk of speech is\n"
+		"        normalized separately. The memory use does not depend on the\n"
+		"        length of the text.\n"
 		"    -i input.txt\n"
 		"        Get the text from a file instead of from stdin.\n"
 		"    -p vtm_param.txt\n"
 		"        This file will be created, and will contain the parameters for the\n"
-		"        vocal tract model.\n\n"
-
-		PROGRAM_NAME << " pho [-v] [-i input.txt] [-p vtm_param.txt] data_dir [speech.wav]\n"
+		"        vocal tract model.\n"
+		"    -s seed\n"
+		"        Seed for the random intonation (overrides random_seed in\n"
+		"        vtm_control_model.txt). The same seed produces the same audio.\n"
+		"    -f format\n"
+		"        Sample format of the WAV file: s16 (16-bit integer, default),\n"
+		"        s24 (24-bit integer) or f32 (32-bit float).\n"
+		"    -j threads\n"
+		"        Number of synthesis threads (default: 1). Long texts are split in\n"
+		"        segments at sentence boundaries, which are synthesized in parallel\n"
+		"        and joined with short crossfades. The result is not equal to the\n"
+		"        result with one thread, but it does not depend on the number of\n"
+		"        threads. Not used with -c and -r.\n"
+		"    -a rate:file.wav\n"
+		"        Additional output. The speech is converted to the sample rate\n"
+		"        (Hz) and written to the file. This option can be repeated, and\n"
+		"        all the files are created from the same synthesis. Use the\n"
+		"        highest rate as output_rate in vtm.txt. Each file is normalized\n"
+		"        separately. Can not be used with -c and -r.\n"
+		"    -r format\n"
+		"        Send raw PCM (without header) to stdout instead of creating a\n"
+		"        WAV file. Each chunk of speech is sent as soon as it has been\n"
+		"        synthesized, and is normalized separately. The sample rate is\n"
+		"        output_rate in vtm.txt. The messages are sent to stderr.\n"
+		"        format: s16le (16-bit integer) or f32le (32-bit float).\n\n"
+
+		PROGRAM_NAME << " pho [-v] [-d] [-i input.txt] [-p vtm_param.txt] [-s seed] data_dir [speech.wav]\n"
 		"    Converts phonetic string to speech.\n\n"
 		"    data_dir   : The directory containing the data and configuration files.\n"
 		"    speech.wav : This file will be created, and will contain the\n"
@@ -82,11 +164,17 @@ showUsage()
 		"    Options:\n"
 		"    -v\n"
 		"        Verbose.\n"
+		"    -d\n"
+		"        Draft mode. Faster synthesis with lower quality, for the vocal\n"
+		"        tract models 4 and 5.\n"
 		"    -i input.txt\n"
 		"        Get the phonetic string from a file instead of from stdin.\n"
 		"    -p vtm_param.txt\n"
 		"        This file will be created, and will contain the parameters for the\n"
-		"        vocal tract model.\n\n"
+		"        vocal tract model.\n"
+		"    -s seed\n"
+		"        Seed for the random intonation (overrides random_seed in\n"
+		"        vtm_control_model.txt). The same seed produces the same audio.\n\n"
 
 		PROGRAM_NAME << " vtm [-v] data_dir vtm_param.txt speech.wav\n"
 		"    Converts vocal tract parameters to speech.\n\n"
@@ -98,6 +186,13 @@ showUsage()
 		"    Options:\n"
 		"    -v\n"
 		"        Verbose.\n\n"
+
+		PROGRAM_NAME << " log2txt parameter_log [output_dir]\n"
+		"    Converts a binary parameter log (see log_parameters in vtm.txt)\n"
+		"    to text files, one for each logged signal.\n\n"
+		"    parameter_log : The binary log file.\n"
+		"    output_dir    : The directory where the text files will be created\n"
+		"                    (default: current directory).\n"
 		<< std::endl;
 }
 
@@ -106,17 +201,30 @@ showUsage()
 int
 tts(int argc, char* argv[])
 {
-	std::cout << PROGRAM_NAME << " tts" << std::endl;
-
 	const char* textInput    = nullptr;
 	const char* vtmParamFile = nullptr;
 	const char* dataDir      = nullptr;
 	const char* outputFile   = nullptr;
+	unsigned long seed       = 0;
+	bool draftMode           = false;
+	bool normalization       = true;
+	bool streamInput         = false;
+	bool rawOutput           = false;
+	unsigned int numThreads  = 1;
+	std::vector<std::pair<int, std::string>> rateOutputList;
+	GS::RawPCMWriter::Format rawFormat{};
+	GS::WAVEFileWriter::Format fileFormat = GS::WAVEFileWriter::Format::pcm16;
 
 	int i = 2;
 	while (argc - i > 0 && isOption(argv[i])) {
 		if (strcmp("-v", argv[i]) == 0) {
 			GS::Log::debugEnabled = true;
+		} else if (strcmp("-d", argv[i]) == 0) {
+			draftMode = true;
+		} else if (strcmp("-n", argv[i]) == 0) {
+			normalization = false;
+		} else if (strcmp("-c", argv[i]) == 0) {
+			streamInput = true;
 		} else if (strcmp("-i", argv[i]) == 0) {
 			++i;
 			if (argc - i < 1) {
@@ -129,12 +237,40 @@ tts(int argc, char* argv[])
 				showUsage(); return EXIT_FAILURE;
 			}
 			vtmParamFile = argv[i];
+		} else if (strcmp("-s", argv[i]) == 0) {
+			++i;
+			if (argc - i < 1 || !getSeed(argv[i], seed)) {
+				showUsage(); return EXIT_FAILURE;
+			}
+		} else if (strcmp("-f", argv[i]) == 0) {
+			++i;
+			if (argc - i < 1 || !GS::WAVEFileWriter::getFormat(argv[i], fileFormat)) {
+				showUsage(); return EXIT_FAILURE;
+			}
+		} else if (strcmp("-r", argv[i]) == 0) {
+			++i;
+			if (argc - i < 1 || !GS::RawPCMWriter::getFormat(argv[i], rawFormat)) {
+				showUsage(); return EXIT_FAILURE;
+			}
+			rawOutput = true;
+		} else if (strcmp("-a", argv[i]) == 0) {
+			++i;
+			std::pair<int, std::string> rateOutput;
+			if (argc - i < 1 || !getRateOutput(argv[i], rateOutput)) {
+				showUsage(); return EXIT_FAILURE;
+			}
+			rateOutputList.push_back(rateOutput);
+		} else if (strcmp("-j", argv[i]) == 0) {
+			++i;
+			if (argc - i < 1 || !getNumberOfThreads(argv[i], numThreads)) {
+				showUsage(); return EXIT_FAILURE;
+			}
 		} else {
 			showUsage(); return EXIT_FAILURE;
 		}
 		++i;
 	}
-	if (argc - i == 2) {
+	if (argc - i == 2 && !rawOutput) {
 		dataDir    = argv[i++];
 		outputFile = argv[i];
 	} else if (argc - i == 1) {
@@ -142,45 +278,121 @@ tts(int argc, char* argv[])
 	} else {
 		showUsage(); return EXIT_FAILURE;
 	}
+	if ((rawOutput || streamInput) && (vtmParamFile || !rateOutputList.empty())) {
+		showUsage(); return EXIT_FAILURE;
+	}
+	if (rawOutput) {
+		// stdout is used for the audio.
+		std::cout.rdbuf(std::cerr.rdbuf());
+	}
 
-	std::ostringstream inputTextStream;
-	if (textInput == nullptr) {
-		std::string line;
-		while (std::getline(std::cin, line)) {
-			inputTextStream << line << ' ';
-		}
-	} else {
-		std::ifstream in(textInput, std::ios_base::binary);
-		if (!in) {
+	std::cout << PROGRAM_NAME << " tts" << std::endl;
+
+	std::ifstream inputFile;
+	std::istream* input = &std::cin;
+	if (textInput != nullptr) {
+		inputFile.open(textInput, std::ios_base::binary);
+		if (!inputFile) {
 			std::cerr << "Error: Could not open the file " << textInput << '.' << std::endl;
 			return EXIT_FAILURE;
 		}
+		input = &inputFile;
+	}
+
+	std::string text;
+	if (!streamInput) {
+		std::ostringstream inputTextStream;
 		std::string line;
-		while (std::getline(in, line)) {
+		while (std::getline(*input, line)) {
 			inputTextStream << line << ' ';
 		}
-	}
-	std::string text = inputTextStream.str();
-	if (text.empty()) {
-		std::cerr << "Error: Empty input text." << std::endl;
-		return EXIT_FAILURE;
-	}
-	if (GS::Log::debugEnabled) {
-		std::cout << "INPUT TEXT [" << text << ']' << std::endl;
+		text = inputTextStream.str();
+		if (text.empty()) {
+			std::cerr << "Error: Empty input text." << std::endl;
+			return EXIT_FAILURE;
+		}
+		if (GS::Log::debugEnabled) {
+			std::cout << "INPUT TEXT [" << text << ']' << std::endl;
+		}
 	}
 
 	try {
+		// Used by the chunk outputs, in the output thread.
+		// They are declared before the controller, which waits for
+		// the output thread when it is destroyed.
+		std::unique_ptr<GS::RawPCMWriter> rawWriter;
+		std::unique_ptr<GS::WAVEFileWriter> fileWriter;
+
 		const GS::Index index{dataDir};
 
 		auto vtmControlModel = std::make_unique<GS::VTMControlModel::Model>();
 		vtmControlModel->load(index);
 
 		auto vtmController = std::make_unique<GS::VTMControlModel::Controller>(index, *vtmControlModel);
+		if (seed != 0) {
+			vtmController->vtmControlModelConfiguration().randomSeed = seed;
+		}
+		vtmController->setDraftMode(draftMode);
+		vtmController->setOutputNormalization(normalization);
+		vtmController->setOutputFileFormat(fileFormat);
+		vtmController->setOutputThreadEnabled(true);
+		vtmController->setSynthesisThreads(numThreads);
 		auto textParser = GS::TextParser::TextParser::getInstance(
 								index,
 								vtmController->vtmControlModelConfiguration().phoStrFormat);
-		std::string phoneticString = textParser->parse(text.c_str());
-		vtmController->synthesizePhoneticStringToFile(phoneticString, vtmParamFile, outputFile);
+
+		if (rawOutput) {
+			rawWriter = std::make_unique<GS::RawPCMWriter>(stdout, rawFormat);
+		} else if (streamInput && outputFile) {
+			fileWriter = std::make_unique<GS::WAVEFileWriter>(outputFile, 1, vtmController->outputSampleRate(), fileFormat);
+		}
+		auto chunkOutput = [&](const std::vector<float>& buffer) {
+			if (rawWriter) {
+				rawWriter->writeSamples(buffer.data(), buffer.size());
+				rawWriter->flush();
+			} else if (fileWriter) {
+				fileWriter->writeSamples(buffer.data(), buffer.size());
+			}
+		};
+
+		if (streamInput) {
+			GS::TextParser::TextChunkReader textReader(*input, *textParser, MAX_BUFFERED_TEXT_SIZE);
+			std::string textChunk;
+			bool emptyInput = true;
+			while (textReader.nextChunk(textChunk)) {
+				emptyInput = false;
+				std::string phoneticString = textParser->parse(textChunk.c_str());
+				vtmController->synthesizePhoneticStringByChunk(phoneticString, chunkOutput);
+			}
+			if (emptyInput) {
+				std::cerr << "Error: Empty input text." << std::endl;
+				return EXIT_FAILURE;
+			}
+		} else {
+			std::string phoneticString = textParser->parse(text.c_str());
+			if (rawOutput) {
+				vtmController->synthesizePhoneticStringByChunk(phoneticString, chunkOutput);
+			} else if (!rateOutputList.empty()) {
+				std::vector<GS::VTMControlModel::Controller::RateOutput> outputList;
+				if (outputFile) {
+					rateOutputList.emplace(rateOutputList.begin(), static_cast<int>(vtmController->outputSampleRate()), outputFile);
+				}
+				for (const auto& rateOutput : rateOutputList) {
+					const int rate = rateOutput.first;
+					const std::string filePath = rateOutput.second;
+					outputList.push_back({rate, [rate, filePath, fileFormat](const std::vector<float>& buffer) {
+						GS::WAVEFileWriter fileWriter(filePath.c_str(), 1, rate, fileFormat);
+						fileWriter.writeSamples(buffer.data(), buffer.size());
+						fileWriter.close();
+					}});
+				}
+				vtmController->synthesizePhoneticStringToRates(phoneticString, vtmParamFile, outputList);
+			} else {
+				vtmController->synthesizePhoneticStringToFile(phoneticString, vtmParamFile, outputFile);
+			}
+		}
+		vtmController->waitForOutput();
+		if (fileWriter) fileWriter->close();
 
 	} catch (std::exception& e) {
 		std::cerr << "Exception: " << e.what() << std::endl;
@@ -204,11 +416,15 @@ pho(int argc, char* argv[])
 	const char* vtmParamFile  = nullptr;
 	const char* dataDir       = nullptr;
 	const char* outputFile    = nullptr;
+	unsigned long seed        = 0;
+	bool draftMode            = false;
 
 	int i = 2;
 	while (argc - i > 0 && isOption(argv[i])) {
 		if (strcmp("-v", argv[i]) == 0) {
 			GS::Log::debugEnabled = true;
+		} else if (strcmp("-d", argv[i]) == 0) {
+			draftMode = true;
 		} else if (strcmp("-i", argv[i]) == 0) {
 			++i;
 			if (argc - i < 1) {
@@ -221,6 +437,11 @@ pho(int argc, char* argv[])
 				showUsage(); return EXIT_FAILURE;
 			}
 			vtmParamFile = argv[i];
+		} else if (strcmp("-s", argv[i]) == 0) {
+			++i;
+			if (argc - i < 1 || !getSeed(argv[i], seed)) {
+				showUsage(); return EXIT_FAILURE;
+			}
 		} else {
 			showUsage(); return EXIT_FAILURE;
 		}
@@ -268,6 +489,10 @@ pho(int argc, char* argv[])
 		vtmControlModel->load(index);
 
 		auto vtmController = std::make_unique<GS::VTMControlModel::Controller>(index, *vtmControlModel);
+		if (seed != 0) {
+			vtmController->vtmControlModelConfiguration().randomSeed = seed;
+		}
+		vtmController->setDraftMode(draftMode);
 		vtmController->synthesizePhoneticStringToFile(phoneticString, vtmParamFile, outputFile);
 
 	} catch (std::exception& e) {
@@ -338,6 +563,33 @@ vtm(int argc, char* argv[])
 
 //==============================================================================
 
+int
+log2txt(int argc, char* argv[])
+{
+	if (argc < 3 || argc > 4) {
+		showUsage(); return EXIT_FAILURE;
+	}
+	const char* logFile   = argv[2];
+	const char* outputDir = (argc == 4) ? argv[3] : ".";
+	if (isOption(logFile) || isOption(outputDir)) {
+		showUsage(); return EXIT_FAILURE;
+	}
+
+	try {
+		GS::convertParameterLogToText(logFile, outputDir);
+	} catch (std::exception& e) {
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	} catch (...) {
+		std::cerr << "Unknown exception." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+//==============================================================================
+
 int
 main(int argc, char* argv[])
 {
@@ -351,6 +603,8 @@ main(int argc, char* argv[])
 		return pho(argc, argv);
 	} else if (strcmp(argv[1], "vtm") == 0) {
 		return vtm(argc, argv);
+	} else if (strcmp(argv[1], "log2txt") == 0) {
+		return log2txt(argc, argv);
 	} else if (strcmp(argv[1], "--version") == 0 || strcmp(argv[1], "--help") == 0) {
 		showUsage(); return EXIT_SUCCESS;
 	}
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "PhoneticStringCache.h"
+
+#include "Exception.h"
+
+
+
+namespace GS {
+namespace TextParser {
+
+PhoneticStringCache::PhoneticStringCache(std::size_t maxSize)
+		: maxSize_(maxSize)
+{
+	if (maxSize_ == 0) {
+		THROW_EXCEPTION(InvalidParameterException, "Invalid phonetic string cache size: " << maxSize_ << '.');
+	}
+	entryMap_.reserve(maxSize_);
+}
+
+const std::string*
+PhoneticStringCache::get(const std::string& key)
+{
+	auto iter = entryMap_.find(key);
+	if (iter == entryMap_.end()) {
+		return nullptr;
+	}
+
+	// Move the entry to the front of the list.
+	entryList_.splice(entryList_.begin(), entryList_, iter->second);
+	return &iter->second->second;
+}
+
+void
+PhoneticStringCache::put(const std::string& key, const std::string& value)
+{
+	auto iter = entryMap_.find(key);
+	if (iter != entryMap_.end()) {
+		iter->second->second = value;
+		entryList_.splice(entryList_.begin(), entryList_, iter->second);
+		return;
+	}
+
+	if (entryMap_.size() >= maxSize_) {
+		// Remove the least recently used entry.
+		entryMap_.erase(entryList_.back().first);
+		entryList_.pop_back();
+	}
+
+	entryList_.emplace_front(key, value);
+	entryMap_[key] = entryList_.begin();
+}
+
+void
+PhoneticStringCache::clear()
+{
+	entryMap_.clear();
+	entryList_.clear();
+}
+
+} /* namespace TextParser */
+} /* namespace GS */
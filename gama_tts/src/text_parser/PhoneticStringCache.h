@@ -0,0 +1,63 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef TEXT_PARSER_PHONETIC_STRING_CACHE_H_
+#define TEXT_PARSER_PHONETIC_STRING_CACHE_H_
+
+#include <cstddef> /* std::size_t */
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility> /* pair */
+
+
+
+namespace GS {
+namespace TextParser {
+
+// Bounded cache of phonetic strings, indexed by the input text.
+// The least recently used entry is removed when the cache is full.
+class PhoneticStringCache {
+public:
+	explicit PhoneticStringCache(std::size_t maxSize);
+	~PhoneticStringCache() = default;
+
+	// Returns nullptr if the key is not in the cache.
+	// The returned pointer is invalidated by the next call to put() or clear().
+	const std::string* get(const std::string& key);
+	void put(const std::string& key, const std::string& value);
+	void clear();
+
+	std::size_t size() const { return entryMap_.size(); }
+	std::size_t maxSize() const { return maxSize_; }
+private:
+	typedef std::list<std::pair<std::string, std::string>> EntryList;
+
+	PhoneticStringCache(const PhoneticStringCache&) = delete;
+	PhoneticStringCache& operator=(const PhoneticStringCache&) = delete;
+	PhoneticStringCache(PhoneticStringCache&&) = delete;
+	PhoneticStringCache& operator=(PhoneticStringCache&&) = delete;
+
+	std::size_t maxSize_;
+	EntryList entryList_; // the most recently used entry is at the front
+	std::unordered_map<std::string, EntryList::iterator> entryMap_;
+};
+
+} /* namespace TextParser */
+} /* namespace GS */
+
+#endif /* TEXT_PARSER_PHONETIC_STRING_CACHE_H_ */
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "TextChunkReader.h"
+
+#include <cctype> /* isspace */
+
+#include "Exception.h"
+#include "Log.h"
+#include "TextParser.h"
+
+
+
+namespace GS {
+namespace TextParser {
+
+TextChunkReader::TextChunkReader(std::istream& in, TextParser& textParser, std::size_t maxBufferSize)
+		: in_(in)
+		, textParser_(textParser)
+		, maxBufferSize_(maxBufferSize > 0 ? maxBufferSize : 1)
+		, endOfInput_()
+		, readBuffer_(READ_SIZE)
+{
+}
+
+bool
+TextChunkReader::nextChunk(std::string& chunk)
+{
+	for (;;) {
+		const std::size_t sentenceEnd = textParser_.findLastSentenceEnd(buffer_);
+		if (sentenceEnd > 0) {
+			if (takeChunk(sentenceEnd, chunk)) return true;
+			continue;
+		}
+		if (buffer_.size() >= maxBufferSize_) {
+			std::size_t splitPos = buffer_.rfind(' ', maxBufferSize_ - 1);
+			splitPos = (splitPos == std::string::npos || splitPos == 0) ? maxBufferSize_ : splitPos + 1;
+			LOG_DEBUG("[TextChunkReader::nextChunk] No sentence end, splitting at position " << splitPos << '.');
+			if (takeChunk(splitPos, chunk)) return true;
+			continue;
+		}
+		if (endOfInput_) {
+			if (buffer_.empty()) return false;
+			if (takeChunk(buffer_.size(), chunk)) return true;
+			return false;
+		}
+		readInput();
+	}
+}
+
+void
+TextChunkReader::readInput()
+{
+	in_.get(readBuffer_.data(), readBuffer_.size(), '\n');
+	buffer_.append(readBuffer_.data(), in_.gcount());
+	if (in_.bad()) {
+		THROW_EXCEPTION(IOException, "Could not read the input text.");
+	}
+	if (in_.fail() && !in_.eof()) {
+		in_.clear(); // empty line
+	}
+
+	const auto c = in_.peek();
+	if (c == std::istream::traits_type::eof()) {
+		endOfInput_ = true;
+	} else if (c == '\n') {
+		in_.ignore();
+		buffer_ += ' ';
+	}
+}
+
+bool
+TextChunkReader::takeChunk(std::size_t size, std::string& chunk)
+{
+	chunk.assign(buffer_, 0, size);
+	buffer_.erase(0, size);
+
+	for (char c : chunk) {
+		if (!isspace(static_cast<unsigned char>(c))) {
+			LOG_DEBUG("[TextChunkReader::takeChunk] Text chunk: [" << chunk << ']');
+			return true;
+		}
+	}
+	return false;
+}
+
+} /* namespace TextParser */
+} /* namespace GS */
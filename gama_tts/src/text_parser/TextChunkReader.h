@@ -0,0 +1,76 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef TEXT_PARSER_TEXT_CHUNK_READER_H_
+#define TEXT_PARSER_TEXT_CHUNK_READER_H_
+
+#include <cstddef> /* std::size_t */
+#include <istream>
+#include <string>
+#include <vector>
+
+
+
+namespace GS {
+namespace TextParser {
+
+class TextParser;
+
+// Reads text from a stream incrementally, and returns it in chunks that
+// end at sentence boundaries (see TextParser::findLastSentenceEnd),
+// so each chunk can be parsed and synthesized while the rest of the
+// input is still being read.
+//
+// The newlines are converted to spaces.
+// If the buffered text reaches maxBufferSize without a sentence end,
+// it is split at the last space (or at maxBufferSize if there is none).
+class TextChunkReader {
+public:
+	TextChunkReader(std::istream& in, TextParser& textParser, std::size_t maxBufferSize);
+	~TextChunkReader() = default;
+
+	// Returns false at the end of the input.
+	// The chunks that contain only white space are skipped.
+	bool nextChunk(std::string& chunk);
+private:
+	enum {
+		READ_SIZE = 4096
+	};
+
+	TextChunkReader(const TextChunkReader&) = delete;
+	TextChunkReader& operator=(const TextChunkReader&) = delete;
+	TextChunkReader(TextChunkReader&&) = delete;
+	TextChunkReader& operator=(TextChunkReader&&) = delete;
+
+	// Reads one line, or READ_SIZE - 1 characters.
+	void readInput();
+	// Moves the first size characters of the buffer to chunk.
+	// Returns false if they contain only white space.
+	bool takeChunk(std::size_t size, std::string& chunk);
+
+	std::istream& in_;
+	TextParser& textParser_;
+	const std::size_t maxBufferSize_;
+	bool endOfInput_;
+	std::string buffer_;
+	std::vector<char> readBuffer_;
+};
+
+} /* namespace TextParser */
+} /* namespace GS */
+
+#endif /* TEXT_PARSER_TEXT_CHUNK_READER_H_ */
@@ -49,6 +49,8 @@ TextParserConfiguration::TextParserConfiguration(const Index& index)
 	default:
 		THROW_EXCEPTION(InvalidValueException, "Invalid text parser mode: " << modeIndex << '.');
 	}
+
+	cacheSize = config.value<unsigned int>("cache_size");
 }
 
 std::unique_ptr<TextParser>
@@ -18,6 +18,7 @@
 #ifndef TEXT_PARSER_H_
 #define TEXT_PARSER_H_
 
+#include <cstddef> /* std::size_t */
 #include <memory>
 #include <string>
 
@@ -45,6 +46,12 @@ public:
 	virtual std::string parse(const char* text) = 0;
 	virtual void setMode(Mode mode) = 0;
 
+	// Returns the position after the last unambiguous sentence end in
+	// text, or 0 if there is none. The text before this position can be
+	// parsed separately from the rest.
+	// The default implementation does not split the text.
+	virtual std::size_t findLastSentenceEnd(const std::string& /*text*/) { return 0; }
+
 	static std::unique_ptr<TextParser> getInstance(const Index& index, VTMControlModel::PhoneticStringFormat phoStrFormat);
 private:
 	TextParser(const TextParser&) = delete;
@@ -59,6 +66,7 @@ struct TextParserConfiguration {
 	std::string dictionary2File;
 	std::string dictionary3File;
 	TextParser::Mode mode;
+	unsigned int cacheSize; // 0: cache disabled
 
 	explicit TextParserConfiguration(const Index& index);
 };
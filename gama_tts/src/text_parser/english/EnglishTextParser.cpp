@@ -150,7 +150,7 @@ namespace {
 using namespace GS;
 using namespace GS::English;
 
-void printStream(std::stringstream& stream, std::size_t streamLength);
+void printStream(std::stringstream& stream, std::size_t streamLength, std::ostream& out);
 void getState(const char* buffer, std::size_t length, std::size_t* i, int* current_state, int* next_state, char* word);
 void setToneGroup(std::stringstream& stream, long tg_pos, const char* word);
 int anotherWordFollows(const char* buffer, std::size_t length, std::size_t i, TextParser::TextParser::Mode mode);
@@ -183,9 +183,9 @@ void conditionInput(const char* input, std::size_t inputLength, char* output, st
 *
 ******************************************************************************/
 void
-printStream(std::stringstream& stream, std::size_t streamLength)
+printStream(std::stringstream& stream, std::size_t streamLength, std::ostream& out)
 {
-	printf("stream length = %-ld\n<begin>", streamLength);
+	out << "stream length = " << streamLength << "\n<begin>";
 
 	/*  REWIND STREAM TO BEGINNING  */
 	stream.seekg(0);
@@ -195,14 +195,14 @@ printStream(std::stringstream& stream, std::size_t streamLength)
 		char c = stream.get();
 		switch (c) {
 		case '\0':
-			printf("\\0");
+			out << "\\0";
 			break;
 		default:
-			printf("%c", c);
+			out << c;
 			break;
 		}
 	}
-	printf("<end>\n");
+	out << "<end>\n";
 }
 
 /******************************************************************************
@@ -1145,6 +1145,19 @@ EnglishTextParser::EnglishTextParser(
 	std::ostringstream specialAcronymsFilePath;
 	specialAcronymsFilePath << dir << SPECIAL_ACRONYMS_FILE;
 	specialAcronymsMap_.load(specialAcronymsFilePath.str().c_str());
+
+	if (config.cacheSize > 0) {
+		cache_ = std::make_unique<PhoneticStringCache>(config.cacheSize);
+	}
+}
+
+std::string
+EnglishTextParser::parse(const char* text)
+{
+	if (cache_) {
+		return parseTextWithCache(text);
+	}
+	return parseText(text);
 }
 
 /******************************************************************************
@@ -1162,15 +1175,13 @@ EnglishTextParser::EnglishTextParser(
 *
 ******************************************************************************/
 std::string
-EnglishTextParser::parse(const char* text)
+EnglishTextParser::parseText(const char* text)
 {
 	std::size_t buffer_length, stream1_length, stream2_length;
 
 	const std::size_t input_length = strlen(text);
 
-	if (Log::debugEnabled) {
-		printf("PHONETIC STRING INPUT [%s]\n", text);
-	}
+	LOG_DEBUG("PHONETIC STRING INPUT [" << text << ']');
 
 	std::vector<char> buffer(input_length + 1);
 
@@ -1178,9 +1189,7 @@ EnglishTextParser::parse(const char* text)
 	    CONNECT WORDS HYPHENATED OVER A NEWLINE  */
 	conditionInput(text, input_length, &buffer[0], &buffer_length);
 
-	if (Log::debugEnabled) {
-		printf("PHONETIC STRING BUFFER [%s]\n", &buffer[0]);
-	}
+	LOG_DEBUG("PHONETIC STRING BUFFER [" << &buffer[0] << ']');
 
 	std::stringstream stream1;
 
@@ -1188,8 +1197,8 @@ EnglishTextParser::parse(const char* text)
 	stripPunctuation(&buffer[0], buffer_length, stream1, &stream1_length);
 
 	if (Log::debugEnabled) {
-		printf("PHONETIC STRING STREAM 1\n");
-		printStream(stream1, stream1_length);
+		LOG_DEBUG("PHONETIC STRING STREAM 1");
+		printStream(stream1, stream1_length, Log::debugStream());
 	}
 
 	std::stringstream stream2;
@@ -1201,8 +1210,8 @@ EnglishTextParser::parse(const char* text)
 	safetyCheck(stream2, &stream2_length);
 
 	if (Log::debugEnabled) {
-		printf("PHONETIC STRING STREAM 2\n");
-		printStream(stream2, stream2_length);
+		LOG_DEBUG("PHONETIC STRING STREAM 2");
+		printStream(stream2, stream2_length, Log::debugStream());
 	}
 
 	std::string phoneticString = stream2.str();
@@ -1212,6 +1221,158 @@ EnglishTextParser::parse(const char* text)
 	return phoneticString.substr(0, phoneticString.size() - 1); // the last character is '\0'
 }
 
+/******************************************************************************
+*
+*       function:       parseTextWithCache
+*
+*       purpose:        Normalizes the white space in the input, splits it in
+*                       sentences, and gets the phonetic string of each
+*                       sentence from the cache. Sentences that are not in
+*                       the cache are parsed and inserted. The input is not
+*                       split in letter mode.
+*
+******************************************************************************/
+std::string
+EnglishTextParser::parseTextWithCache(const char* text)
+{
+	/*  NORMALIZE WHITE SPACE;  KEEP NEWLINES ONLY AFTER HYPHENS  */
+	std::string normText;
+	bool pendingSpace = false;
+	bool pendingNewline = false;
+	for (const char* p = text; *p != '\0'; ++p) {
+		if (isspace(static_cast<unsigned char>(*p))) {
+			if (*p == '\n') {
+				pendingNewline = true;
+			} else {
+				pendingSpace = true;
+			}
+			continue;
+		}
+		if (!normText.empty()) {
+			if (pendingNewline && normText.back() == '-') {
+				normText += '\n';
+			} else if (pendingSpace || pendingNewline) {
+				normText += ' ';
+			}
+		}
+		pendingSpace = pendingNewline = false;
+		normText += *p;
+	}
+	if (normText.empty()) {
+		THROW_EXCEPTION(InvalidValueException, "Empty input text.");
+	}
+
+	/*  THE MODE IS PART OF THE KEY  */
+	const char modeChar = static_cast<char>('0' + static_cast<int>(mode_));
+
+	std::string phoneticString;
+	std::string key;
+	std::size_t start = 0;
+	const std::size_t size = normText.size();
+	while (start < size) {
+		std::size_t end = start;
+		if (mode_ == Mode::letter) {
+			end = size;
+		} else {
+			while (end < size && !isSentenceEnd(normText, end)) {
+				end++;
+			}
+			if (end < size) {
+				end++; /*  INCLUDE THE PUNCTUATION  */
+			}
+		}
+
+		key.assign(1, modeChar);
+		key.append(normText, start, end - start);
+
+		const std::string* entry = cache_->get(key);
+		if (entry) {
+			LOG_DEBUG("[EnglishTextParser::parseTextWithCache] Cache hit: [" << key.substr(1) << ']');
+			phoneticString += *entry;
+		} else {
+			std::string sentencePhoneticString = parseText(key.c_str() + 1);
+			cache_->put(key, sentencePhoneticString);
+			phoneticString += sentencePhoneticString;
+		}
+		if (phoneticString.back() != ' ') {
+			phoneticString += ' ';
+		}
+
+		start = end + 1; /*  SKIP THE SPACE  */
+	}
+
+	return phoneticString;
+}
+
+/******************************************************************************
+*
+*       function:       isSentenceEnd
+*
+*       purpose:        Returns true if the character at position i in the
+*                       normalized text ends a sentence. Only unambiguous
+*                       boundaries are accepted: the punctuation must follow
+*                       a word that is not a single letter or a listed
+*                       abbreviation, and must be followed by white space
+*                       and an upper case letter.
+*
+******************************************************************************/
+bool
+EnglishTextParser::isSentenceEnd(const std::string& text, std::size_t i)
+{
+	const char c = text[i];
+	if ((c != '.') && (c != '!') && (c != '?')) {
+		return false;
+	}
+	if ((i == 0) || !Text::isAlphaNum(text[i-1])) {
+		return false;
+	}
+	std::size_t next = i + 1;
+	while ((next < text.size()) && isspace(static_cast<unsigned char>(text[next]))) {
+		next++;
+	}
+	if ((next == i + 1) || (next >= text.size()) || !Text::isUpper(text[next])) {
+		return false;
+	}
+	if (c == '.') {
+		/*  GET PRECEDING WORD  */
+		std::size_t wordStart = i;
+		while ((wordStart > 0) && Text::isAlphaNum(text[wordStart-1])) {
+			wordStart--;
+		}
+		const std::size_t wordLength = i - wordStart;
+		if ((wordLength == 1) && Text::isAlpha(text[wordStart])) {
+			return false;
+		}
+		if ((wordLength >= 2) && (wordLength <= 4)) {
+			const std::string word = text.substr(wordStart, wordLength);
+			if (abbrevMap_.getEntry(word.c_str()) || abbrevWithNumberMap_.getEntry(word.c_str())) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/******************************************************************************
+*
+*       function:       findLastSentenceEnd
+*
+*       purpose:        Returns the position after the last sentence end
+*                       (see isSentenceEnd) in the text, or 0 if there is
+*                       none.
+*
+******************************************************************************/
+std::size_t
+EnglishTextParser::findLastSentenceEnd(const std::string& text)
+{
+	for (std::size_t i = text.size(); i > 0; --i) {
+		if (isSentenceEnd(text, i - 1)) {
+			return i;
+		}
+	}
+	return 0;
+}
+
 /******************************************************************************
 *
 *       function:       lookup_word
@@ -1224,9 +1385,7 @@ EnglishTextParser::parse(const char* text)
 const char*
 EnglishTextParser::lookupWord(const char* word)
 {
-	if (Log::debugEnabled) {
-		printf("lookupWord word: [%s]\n", word);
-	}
+	LOG_DEBUG("lookupWord word: [" << word << ']');
 
 	/*  SEARCH DICTIONARIES IN USER ORDER TILL PRONUNCIATION FOUND  */
 	for (int i = 0; i < DICTIONARY_ORDER_SIZE; i++) {
@@ -27,6 +27,7 @@
 
 #include "DictionarySearch.h"
 #include "english/NumberParser.h"
+#include "PhoneticStringCache.h"
 #include "StringMap.h"
 #include "TextParser.h"
 
@@ -46,6 +47,7 @@ public:
 
 	virtual std::string parse(const char* text);
 	virtual void setMode(Mode mode) { mode_ = mode; }
+	virtual std::size_t findLastSentenceEnd(const std::string& text);
 private:
 	enum {
 		DICTIONARY_ORDER_SIZE = 6
@@ -56,6 +58,10 @@ private:
 	EnglishTextParser(EnglishTextParser&&) = delete;
 	EnglishTextParser& operator=(EnglishTextParser&&) = delete;
 
+	std::string parseText(const char* text);
+	// Splits the text in sentences, and parses each sentence using the cache.
+	std::string parseTextWithCache(const char* text);
+	bool isSentenceEnd(const std::string& text, std::size_t i);
 	const char* lookupWord(const char* word);
 	void expandWord(char* word, int is_tonic, std::stringstream& stream);
 	void finalConversion(std::stringstream& stream1, std::size_t stream1Length,
@@ -74,6 +80,7 @@ private:
 	StringMap abbrevMap_;
 	StringMap abbrevWithNumberMap_;
 	StringMap specialAcronymsMap_;
+	std::unique_ptr<PhoneticStringCache> cache_;
 };
 
 } /* namespace English */
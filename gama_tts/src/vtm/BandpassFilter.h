@@ -23,6 +23,8 @@
 
 #include <cmath>
 
+#include "DSPState.h"
+
 
 
 namespace GS {
@@ -36,6 +38,8 @@ public:
 	~BandpassFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	void update(TFloat sampleRate, TFloat bandwidth, TFloat centerFreq);
 	TFloat filter(TFloat x);
 private:
@@ -86,6 +90,38 @@ BandpassFilter<TFloat>::reset()
 	prevCenterFreq_ = -1.0;
 }
 
+template<typename TFloat>
+void
+BandpassFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(b0_);
+	w.write(a2_);
+	w.write(a1_);
+	w.write(x1_);
+	w.write(x2_);
+	w.write(y1_);
+	w.write(y2_);
+	w.write(prevSampleRate_);
+	w.write(prevBandwidth_);
+	w.write(prevCenterFreq_);
+}
+
+template<typename TFloat>
+void
+BandpassFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(b0_);
+	r.read(a2_);
+	r.read(a1_);
+	r.read(x1_);
+	r.read(x2_);
+	r.read(y1_);
+	r.read(y2_);
+	r.read(prevSampleRate_);
+	r.read(prevBandwidth_);
+	r.read(prevCenterFreq_);
+}
+
 template<typename TFloat>
 void
 BandpassFilter<TFloat>::update(TFloat sampleRate, TFloat bandwidth, TFloat centerFreq)
@@ -18,7 +18,9 @@
 #define VTM_BUTTERWORTH_1_LOWPASS_FILTER_H_
 
 #include <cmath>
+#include <cstddef> /* std::size_t */
 
+#include "DSPState.h"
 #include "Exception.h"
 
 
@@ -33,8 +35,12 @@ public:
 	~Butterworth1LowPassFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	void update(TFloat sampleRate, TFloat cutoffFreq);
 	TFloat filter(TFloat x);
+	// y may be equal to x.
+	void filter(const TFloat* x, TFloat* y, std::size_t n);
 private:
 	Butterworth1LowPassFilter(const Butterworth1LowPassFilter&) = delete;
 	Butterworth1LowPassFilter& operator=(const Butterworth1LowPassFilter&) = delete;
@@ -66,6 +72,26 @@ Butterworth1LowPassFilter<TFloat>::reset()
 	y1_ = 0.0;
 }
 
+template<typename TFloat>
+void
+Butterworth1LowPassFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(b0_);
+	w.write(a1_);
+	w.write(x1_);
+	w.write(y1_);
+}
+
+template<typename TFloat>
+void
+Butterworth1LowPassFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(b0_);
+	r.read(a1_);
+	r.read(x1_);
+	r.read(y1_);
+}
+
 template<typename TFloat>
 void
 Butterworth1LowPassFilter<TFloat>::update(TFloat sampleRate, TFloat cutoffFreq)
@@ -95,6 +121,15 @@ Butterworth1LowPassFilter<TFloat>::filter(TFloat x)
 	return y;
 }
 
+template<typename TFloat>
+void
+Butterworth1LowPassFilter<TFloat>::filter(const TFloat* x, TFloat* y, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		y[i] = filter(x[i]);
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
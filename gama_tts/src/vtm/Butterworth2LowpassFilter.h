@@ -18,7 +18,9 @@
 #define VTM_BUTTERWORTH_2_LOWPASS_FILTER_H_
 
 #include <cmath>
+#include <cstddef> /* std::size_t */
 
+#include "DSPState.h"
 #include "Exception.h"
 
 
@@ -33,8 +35,12 @@ public:
 	~Butterworth2LowPassFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	void update(TFloat sampleRate, TFloat cutoffFreq);
 	TFloat filter(TFloat x);
+	// y may be equal to x.
+	void filter(const TFloat* x, TFloat* y, std::size_t n);
 private:
 	Butterworth2LowPassFilter(const Butterworth2LowPassFilter&) = delete;
 	Butterworth2LowPassFilter& operator=(const Butterworth2LowPassFilter&) = delete;
@@ -76,6 +82,34 @@ Butterworth2LowPassFilter<TFloat>::reset()
 	y2_ = 0.0;
 }
 
+template<typename TFloat>
+void
+Butterworth2LowPassFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(b0_);
+	w.write(b1_);
+	w.write(a1_);
+	w.write(a2_);
+	w.write(x1_);
+	w.write(x2_);
+	w.write(y1_);
+	w.write(y2_);
+}
+
+template<typename TFloat>
+void
+Butterworth2LowPassFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(b0_);
+	r.read(b1_);
+	r.read(a1_);
+	r.read(a2_);
+	r.read(x1_);
+	r.read(x2_);
+	r.read(y1_);
+	r.read(y2_);
+}
+
 template<typename TFloat>
 void
 Butterworth2LowPassFilter<TFloat>::update(TFloat sampleRate, TFloat cutoffFreq)
@@ -111,6 +145,15 @@ Butterworth2LowPassFilter<TFloat>::filter(TFloat x)
 	return y;
 }
 
+template<typename TFloat>
+void
+Butterworth2LowPassFilter<TFloat>::filter(const TFloat* x, TFloat* y, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		y[i] = filter(x[i]);
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
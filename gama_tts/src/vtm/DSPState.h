@@ -0,0 +1,191 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef VTM_DSP_STATE_H_
+#define VTM_DSP_STATE_H_
+
+#include <cstddef> /* std::size_t */
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Exception.h"
+
+
+
+namespace GS {
+namespace VTM {
+
+// Serializes the DSP state of the vocal tract models.
+//
+// The values are stored in the native binary representation, so a state
+// can only be restored in the same build of the program, by a model created
+// with the same configuration.
+class DSPStateWriter {
+public:
+	explicit DSPStateWriter(std::vector<unsigned char>& data) : data_(data) {}
+	~DSPStateWriter() = default;
+
+	template<typename T> void write(const T& value);
+	template<typename T> void writeVector(const std::vector<T>& v);
+
+	// The tag identifies the object that wrote the following values.
+	void writeTag(const char* tag);
+private:
+	DSPStateWriter(const DSPStateWriter&) = delete;
+	DSPStateWriter& operator=(const DSPStateWriter&) = delete;
+	DSPStateWriter(DSPStateWriter&&) = delete;
+	DSPStateWriter& operator=(DSPStateWriter&&) = delete;
+
+	void writeBytes(const void* p, std::size_t size);
+
+	std::vector<unsigned char>& data_;
+};
+
+// Reads the state written by DSPStateWriter.
+//
+// Throws InvalidValueException if the data is truncated or
+// does not match the object that is being restored.
+class DSPStateReader {
+public:
+	explicit DSPStateReader(const std::vector<unsigned char>& data) : data_(data), pos_() {}
+	~DSPStateReader() = default;
+
+	template<typename T> void read(T& value);
+	// If resize is false, the size of the vector must match the stored size.
+	template<typename T> void readVector(std::vector<T>& v, bool resize = false);
+
+	void readTag(const char* tag);
+
+	// Reads a value and checks if it is equal to the expected value.
+	template<typename T> void expect(const T& value, const char* name);
+
+	bool atEnd() const { return pos_ == data_.size(); }
+private:
+	DSPStateReader(const DSPStateReader&) = delete;
+	DSPStateReader& operator=(const DSPStateReader&) = delete;
+	DSPStateReader(DSPStateReader&&) = delete;
+	DSPStateReader& operator=(DSPStateReader&&) = delete;
+
+	void readBytes(void* p, std::size_t size);
+
+	const std::vector<unsigned char>& data_;
+	std::size_t pos_;
+};
+
+
+
+inline
+void
+DSPStateWriter::writeBytes(const void* p, std::size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(p);
+	data_.insert(data_.end(), bytes, bytes + size);
+}
+
+template<typename T>
+void
+DSPStateWriter::write(const T& value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "The type must be trivially copyable.");
+	writeBytes(&value, sizeof(T));
+}
+
+template<typename T>
+void
+DSPStateWriter::writeVector(const std::vector<T>& v)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "The type must be trivially copyable.");
+	write(static_cast<unsigned long long>(v.size()));
+	if (!v.empty()) {
+		writeBytes(v.data(), v.size() * sizeof(T));
+	}
+}
+
+inline
+void
+DSPStateWriter::writeTag(const char* tag)
+{
+	writeBytes(tag, std::strlen(tag) + 1U);
+}
+
+inline
+void
+DSPStateReader::readBytes(void* p, std::size_t size)
+{
+	if (data_.size() - pos_ < size) {
+		THROW_EXCEPTION(InvalidValueException, "[DSPStateReader] Truncated state.");
+	}
+	std::memcpy(p, data_.data() + pos_, size);
+	pos_ += size;
+}
+
+template<typename T>
+void
+DSPStateReader::read(T& value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "The type must be trivially copyable.");
+	readBytes(&value, sizeof(T));
+}
+
+template<typename T>
+void
+DSPStateReader::readVector(std::vector<T>& v, bool resize)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "The type must be trivially copyable.");
+	unsigned long long size;
+	read(size);
+	if (resize) {
+		if (size > (data_.size() - pos_) / sizeof(T)) {
+			THROW_EXCEPTION(InvalidValueException, "[DSPStateReader] Truncated state.");
+		}
+		v.resize(size);
+	} else if (size != v.size()) {
+		THROW_EXCEPTION(InvalidValueException, "[DSPStateReader] Wrong vector size: " << size <<
+				" (expected: " << v.size() << ").");
+	}
+	if (!v.empty()) {
+		readBytes(v.data(), v.size() * sizeof(T));
+	}
+}
+
+inline
+void
+DSPStateReader::readTag(const char* tag)
+{
+	const std::size_t size = std::strlen(tag) + 1U;
+	if (data_.size() - pos_ < size || std::memcmp(data_.data() + pos_, tag, size) != 0) {
+		THROW_EXCEPTION(InvalidValueException, "[DSPStateReader] Missing tag: " << tag << '.');
+	}
+	pos_ += size;
+}
+
+template<typename T>
+void
+DSPStateReader::expect(const T& value, const char* name)
+{
+	T storedValue;
+	read(storedValue);
+	if (std::memcmp(&storedValue, &value, sizeof(T)) != 0) {
+		THROW_EXCEPTION(InvalidValueException, "[DSPStateReader] The state was saved with a different " << name << '.');
+	}
+}
+
+} /* namespace VTM */
+} /* namespace GS */
+
+#endif /* VTM_DSP_STATE_H_ */
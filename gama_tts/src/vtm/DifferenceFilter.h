@@ -18,6 +18,8 @@
 #ifndef VTM_DIFFERENCE_FILTER_H_
 #define VTM_DIFFERENCE_FILTER_H_
 
+#include "DSPState.h"
+
 
 
 namespace GS {
@@ -31,6 +33,8 @@ public:
 	~DifferenceFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat filter(TFloat x);
 private:
 	DifferenceFilter(const DifferenceFilter&) = delete;
@@ -57,6 +61,22 @@ DifferenceFilter<TFloat>::reset()
 	x2_ = 0.0;
 }
 
+template<typename TFloat>
+void
+DifferenceFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(x1_);
+	w.write(x2_);
+}
+
+template<typename TFloat>
+void
+DifferenceFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(x1_);
+	r.read(x2_);
+}
+
 template<typename TFloat>
 TFloat
 DifferenceFilter<TFloat>::filter(TFloat x)
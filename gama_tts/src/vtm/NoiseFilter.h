@@ -21,6 +21,10 @@
 #ifndef VTM_NOISE_FILTER_H_
 #define VTM_NOISE_FILTER_H_
 
+#include <cstddef> /* std::size_t */
+
+#include "DSPState.h"
+
 
 
 namespace GS {
@@ -34,7 +38,11 @@ public:
 	~NoiseFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat filter(TFloat x);
+	// y may be equal to x.
+	void filter(const TFloat* x, TFloat* y, std::size_t n);
 private:
 	NoiseFilter(const NoiseFilter&) = delete;
 	NoiseFilter& operator=(const NoiseFilter&) = delete;
@@ -58,6 +66,20 @@ NoiseFilter<TFloat>::reset()
 	x1_ = 0.0;
 }
 
+template<typename TFloat>
+void
+NoiseFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(x1_);
+}
+
+template<typename TFloat>
+void
+NoiseFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(x1_);
+}
+
 template<typename TFloat>
 TFloat
 NoiseFilter<TFloat>::filter(TFloat x)
@@ -67,6 +89,15 @@ NoiseFilter<TFloat>::filter(TFloat x)
 	return y;
 }
 
+template<typename TFloat>
+void
+NoiseFilter<TFloat>::filter(const TFloat* x, TFloat* y, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		y[i] = filter(x[i]);
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
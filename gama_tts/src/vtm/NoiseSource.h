@@ -21,21 +21,60 @@
 #ifndef VTM_NOISE_SOURCE_H_
 #define VTM_NOISE_SOURCE_H_
 
+#include <array>
+#include <cstddef> /* std::size_t */
+#include <cstdint>
+
+#include "DSPState.h"
+#include "Exception.h"
+
 
 
 namespace GS {
 namespace VTM {
 
+// Uniform white noise in the range [-0.5, 0.5).
+//
+// GENERATOR_REFERENCE is the original Gnuspeech generator. It is kept
+// as the default, because it reproduces the output of previous versions.
+//
+// GENERATOR_INTEGER runs independent linear congruential generators in
+// parallel lanes, so getBlock() can be vectorized by the compiler.
 class NoiseSource {
 public:
-	NoiseSource()
-		: initialSeed_(0.7892347)
+	enum Generator {
+		GENERATOR_REFERENCE = 0,
+		GENERATOR_INTEGER   = 1
+	};
+
+	explicit NoiseSource(int generator = GENERATOR_REFERENCE)
+		: generator_(generator)
+		, initialSeed_(0.7892347)
 		, factor_(377.0)
-		, seed_(initialSeed_) {}
+		, seed_(initialSeed_)
+	{
+		if (generator_ != GENERATOR_REFERENCE && generator_ != GENERATOR_INTEGER) {
+			THROW_EXCEPTION(InvalidParameterException, "[NoiseSource] Invalid generator: " << generator << '.');
+		}
+		reset();
+	}
 	~NoiseSource() = default;
 
 	void reset() {
 		seed_ = initialSeed_;
+		for (std::size_t i = 0; i < LANES; ++i) {
+			laneState_[i] = static_cast<uint32_t>(0x9E3779B9U * (i + 1U));
+		}
+	}
+	void saveState(DSPStateWriter& w) const {
+		w.write(generator_);
+		w.write(seed_);
+		w.write(laneState_);
+	}
+	void loadState(DSPStateReader& r) {
+		r.expect(generator_, "noise generator");
+		r.read(seed_);
+		r.read(laneState_);
 	}
 	double getSample() {
 		double product = seed_ * factor_;
@@ -43,17 +82,62 @@ public:
 		return seed_ - 0.5;
 	}
 
+	// Fills the buffer with n samples.
+	// With GENERATOR_REFERENCE, the sequence is the same as the one
+	// produced by n calls to getSample().
+	template<typename TFloat> void getBlock(TFloat* buffer, std::size_t n);
 private:
+	enum {
+		LANES = 8
+	};
+
 	NoiseSource(const NoiseSource&) = delete;
 	NoiseSource& operator=(const NoiseSource&) = delete;
 	NoiseSource(NoiseSource&&) = delete;
 	NoiseSource& operator=(NoiseSource&&) = delete;
 
+	static uint32_t nextLaneState(uint32_t state) {
+		return state * 1664525U + 1013904223U;
+	}
+	template<typename TFloat>
+	static TFloat laneSample(uint32_t state) {
+		// Uses the 24 most significant bits, which have the longest periods.
+		return static_cast<TFloat>(static_cast<int32_t>(state >> 8U) - 0x800000) * TFloat{1.0 / 0x1000000};
+	}
+
+	const int generator_;
 	const double initialSeed_;
 	const double factor_;
 	double seed_;
+	std::array<uint32_t, LANES> laneState_;
 };
 
+
+
+template<typename TFloat>
+void
+NoiseSource::getBlock(TFloat* buffer, std::size_t n)
+{
+	if (generator_ == GENERATOR_REFERENCE) {
+		for (std::size_t i = 0; i < n; ++i) {
+			buffer[i] = getSample();
+		}
+		return;
+	}
+
+	std::size_t i = 0;
+	for ( ; i + LANES <= n; i += LANES) {
+		for (std::size_t j = 0; j < LANES; ++j) {
+			laneState_[j] = nextLaneState(laneState_[j]);
+			buffer[i + j] = laneSample<TFloat>(laneState_[j]);
+		}
+	}
+	for (std::size_t j = 0; j < LANES && i + j < n; ++j) {
+		laneState_[j] = nextLaneState(laneState_[j]);
+		buffer[i + j] = laneSample<TFloat>(laneState_[j]);
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
@@ -18,12 +18,16 @@
 #ifndef VTM_POLE_ZERO_RADIATION_IMPEDANCE_H_
 #define VTM_POLE_ZERO_RADIATION_IMPEDANCE_H_
 
+#include <algorithm> /* min */
 #include <cmath>
 
+#include "DSPState.h"
 #include "Exception.h"
 
 #define GS_VTM_POLE_ZERO_RAD_IMPED_TRANSITION_RADIUS (0.5e-2)
 #define GS_VTM_POLE_ZERO_RAD_IMPED_MIN_SAMPLE_RATE (50000.0)
+#define GS_VTM_POLE_ZERO_RAD_IMPED_LOW_QUALITY_MIN_SAMPLE_RATE (10000.0)
+#define GS_VTM_POLE_ZERO_RAD_IMPED_MAX_TRANSITION_FREQ_FACTOR (0.45)
 
 
 
@@ -55,6 +59,8 @@ namespace VTM {
  * Notes:
  * - Zr = 1.0 at fs/2.
  * - Real(Zr) = 0.5 at the transition frequency.
+ * - The transition frequency is limited to 0.45*fs. This only happens in
+ *   low quality mode, with fs < 50 kHz.
  *
  *
  *
@@ -88,15 +94,18 @@ namespace VTM {
 template<typename TFloat>
 class PoleZeroRadiationImpedance {
 public:
-	explicit PoleZeroRadiationImpedance(TFloat sampleRate);
+	explicit PoleZeroRadiationImpedance(TFloat sampleRate, bool lowQuality = false);
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	void update(TFloat radius /* m */);
 	void process(TFloat in /* flow */, TFloat& outT /* flow */, TFloat& outR /* flow */);
 private:
-	static TFloat transitionFrequency(TFloat radius /* m */);
+	TFloat transitionFrequency(TFloat radius /* m */) const;
 
 	TFloat samplePeriod_;
+	TFloat maxTransitionFreq_;
 	TFloat in1_; // the previous value
 	TFloat outT1_; // the previous value
 	TFloat outR1_; // the previous value
@@ -108,16 +117,21 @@ private:
 
 
 // sampleRate must be > 50 kHz, but not much higher than 100 kHz.
+// If lowQuality is true, sampleRate must be > 10 kHz.
 template<typename TFloat>
-PoleZeroRadiationImpedance<TFloat>::PoleZeroRadiationImpedance(TFloat sampleRate)
+PoleZeroRadiationImpedance<TFloat>::PoleZeroRadiationImpedance(TFloat sampleRate, bool lowQuality)
 {
 	reset();
 
-	if (sampleRate < TFloat{GS_VTM_POLE_ZERO_RAD_IMPED_MIN_SAMPLE_RATE}) {
+	const TFloat minSampleRate = lowQuality ?
+					GS_VTM_POLE_ZERO_RAD_IMPED_LOW_QUALITY_MIN_SAMPLE_RATE :
+					GS_VTM_POLE_ZERO_RAD_IMPED_MIN_SAMPLE_RATE;
+	if (sampleRate < minSampleRate) {
 		THROW_EXCEPTION(InvalidValueException, "[PoleZeroRadiationImpedance] Invalid sample rate: " << sampleRate <<
-				" (minimum: " << GS_VTM_POLE_ZERO_RAD_IMPED_MIN_SAMPLE_RATE << ").");
+				" (minimum: " << minSampleRate << ").");
 	} else {
 		samplePeriod_ = 1.0f / sampleRate;
+		maxTransitionFreq_ = TFloat{GS_VTM_POLE_ZERO_RAD_IMPED_MAX_TRANSITION_FREQ_FACTOR} * sampleRate;
 	}
 }
 
@@ -131,13 +145,45 @@ PoleZeroRadiationImpedance<TFloat>::reset()
 	prevRadius_ = -1.0;
 }
 
+template<typename TFloat>
+void
+PoleZeroRadiationImpedance<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(in1_);
+	w.write(outT1_);
+	w.write(outR1_);
+	w.write(cT1_);
+	w.write(cT2_);
+	w.write(cT3_);
+	w.write(cR1_);
+	w.write(cR2_);
+	w.write(cR3_);
+	w.write(prevRadius_);
+}
+
+template<typename TFloat>
+void
+PoleZeroRadiationImpedance<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(in1_);
+	r.read(outT1_);
+	r.read(outR1_);
+	r.read(cT1_);
+	r.read(cT2_);
+	r.read(cT3_);
+	r.read(cR1_);
+	r.read(cR2_);
+	r.read(cR3_);
+	r.read(prevRadius_);
+}
+
 template<typename TFloat>
 TFloat
-PoleZeroRadiationImpedance<TFloat>::transitionFrequency(TFloat radius) {
+PoleZeroRadiationImpedance<TFloat>::transitionFrequency(TFloat radius) const {
 	if (radius < TFloat{GS_VTM_POLE_ZERO_RAD_IMPED_TRANSITION_RADIUS}) {
 		radius = GS_VTM_POLE_ZERO_RAD_IMPED_TRANSITION_RADIUS;
 	}
-	return TFloat{62.3371} / radius + TFloat{320.204};
+	return std::min(TFloat{62.3371} / radius + TFloat{320.204}, maxTransitionFreq_);
 }
 
 template<typename TFloat>
@@ -21,6 +21,8 @@
 #ifndef VTM_RADIATION_FILTER_H_
 #define VTM_RADIATION_FILTER_H_
 
+#include "DSPState.h"
+
 
 
 namespace GS {
@@ -36,6 +38,8 @@ public:
 	~RadiationFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat filter(TFloat x);
 private:
 	RadiationFilter(const RadiationFilter&) = delete;
@@ -68,6 +72,22 @@ RadiationFilter<TFloat>::reset()
 	y1_ = 0.0;
 }
 
+template<typename TFloat>
+void
+RadiationFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(x1_);
+	w.write(y1_);
+}
+
+template<typename TFloat>
+void
+RadiationFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(x1_);
+	r.read(y1_);
+}
+
 template<typename TFloat>
 TFloat
 RadiationFilter<TFloat>::filter(TFloat x)
@@ -0,0 +1,103 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef VTM_REAL_TIME_RENDERER_H_
+#define VTM_REAL_TIME_RENDERER_H_
+
+#include <cmath> /* ceil */
+#include <cstddef> /* std::size_t */
+#include <vector>
+
+#include "SampleRateConverter.h"
+#include "VocalTractModel.h"
+#include "VTMUtil.h"
+
+
+
+namespace GS {
+namespace VTM {
+
+/*******************************************************************************
+ * Renders the output of a vocal tract model in blocks, for audio callbacks.
+ *
+ * reset() may allocate memory. After it, render() does not allocate memory
+ * or lock, if the blocks are not larger than maxBlockSize.
+ */
+class RealTimeRenderer {
+public:
+	explicit RealTimeRenderer(VocalTractModel& vtm) : vtm_(vtm), bufferPos_() {}
+	~RealTimeRenderer() = default;
+
+	// Resets the vocal tract model.
+	void reset(std::size_t maxBlockSize);
+
+	// Writes n samples multiplied by scale to buffer.
+	// Before each synthesis step, calls prepareStep(vtm), which must set
+	// the parameters and return true, or return false if there are no more data.
+	// Returns the number of samples written.
+	template<typename F> std::size_t render(float* buffer, std::size_t n, float scale, F&& prepareStep);
+private:
+	RealTimeRenderer(const RealTimeRenderer&) = delete;
+	RealTimeRenderer& operator=(const RealTimeRenderer&) = delete;
+	RealTimeRenderer(RealTimeRenderer&&) = delete;
+	RealTimeRenderer& operator=(RealTimeRenderer&&) = delete;
+
+	VocalTractModel& vtm_;
+	std::size_t bufferPos_;
+};
+
+
+
+inline
+void
+RealTimeRenderer::reset(std::size_t maxBlockSize)
+{
+	vtm_.reset();
+	bufferPos_ = 0;
+
+	// The sample rate converter sends the output samples in bursts.
+	// The VTM output buffer must hold one block plus one burst.
+	const std::size_t maxBurstSize = static_cast<std::size_t>(std::ceil(
+				SampleRateConverter<double>::maxInputBlockSize() * vtm_.outputSampleRate() / vtm_.internalSampleRate())) + 1U;
+	vtm_.outputBuffer().reserve(maxBlockSize + maxBurstSize);
+}
+
+template<typename F>
+std::size_t
+RealTimeRenderer::render(float* buffer, std::size_t n, float scale, F&& prepareStep)
+{
+	std::vector<float>& vtmOutputBuffer = vtm_.outputBuffer();
+
+	// Use the samples left from the previous block.
+	std::size_t count = Util::getSamples(vtmOutputBuffer, bufferPos_, buffer, n, scale);
+	if (count == n) return n;
+
+	// Here the VTM output buffer is empty.
+	const std::size_t targetBufferSize = n - count;
+	while (vtmOutputBuffer.size() < targetBufferSize) {
+		if (!prepareStep(vtm_)) break;
+		vtm_.execSynthesisStep();
+	}
+
+	count += Util::getSamples(vtmOutputBuffer, bufferPos_, buffer + count, n - count, scale);
+	return count;
+}
+
+} /* namespace VTM */
+} /* namespace GS */
+
+#endif /* VTM_REAL_TIME_RENDERER_H_ */
@@ -23,6 +23,8 @@
 
 #include <cmath>
 
+#include "DSPState.h"
+
 
 
 namespace GS {
@@ -37,6 +39,8 @@ public:
 	~ReflectionFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat filter(TFloat x);
 private:
 	ReflectionFilter(const ReflectionFilter&) = delete;
@@ -66,6 +70,20 @@ ReflectionFilter<TFloat>::reset()
 	y1_ = 0.0;
 }
 
+template<typename TFloat>
+void
+ReflectionFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(y1_);
+}
+
+template<typename TFloat>
+void
+ReflectionFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(y1_);
+}
+
 template<typename TFloat>
 TFloat
 ReflectionFilter<TFloat>::filter(TFloat x)
@@ -20,6 +20,7 @@
 
 #include <cmath> /* sin */
 
+#include "DSPState.h"
 #include "Exception.h"
 
 
@@ -43,6 +44,8 @@ public:
 	~RosenbergBGlottalSource() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat getSample(TFloat frequency /* Hz */);
 	void setup(TFloat amplitude /* [0.0, 1.0] */);
 private:
@@ -107,6 +110,26 @@ RosenbergBGlottalSource<TFloat>::reset()
 	t_ = 0.0;
 }
 
+template<typename TFloat>
+void
+RosenbergBGlottalSource<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(prevAmplitude_);
+	w.write(t2_);
+	w.write(nextT2_);
+	w.write(t_);
+}
+
+template<typename TFloat>
+void
+RosenbergBGlottalSource<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(prevAmplitude_);
+	r.read(t2_);
+	r.read(nextT2_);
+	r.read(t_);
+}
+
 template<typename TFloat>
 void
 RosenbergBGlottalSource<TFloat>::setup(TFloat amplitude)
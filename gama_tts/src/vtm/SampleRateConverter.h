@@ -25,6 +25,9 @@
 #include <functional>
 #include <vector>
 
+#include "DSPState.h"
+#include "Exception.h"
+
 
 
 namespace GS {
@@ -37,8 +40,17 @@ public:
 	~SampleRateConverter() = default;
 
 	void reset();
+	// Changes the sample rates and resets the converter.
+	// The filter impulse response is not recalculated.
+	void setSampleRates(TFloat inputRate, TFloat outputRate);
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	void dataFill(TFloat data);
 	void flushBuffer();
+
+	// The output is sent in blocks, each one generated from at most
+	// this number of input samples.
+	static constexpr unsigned int maxInputBlockSize() { return BUFFER_SIZE; }
 private:
 	enum {
 		BUFFER_SIZE = 1024, /*  ring buffer size  */
@@ -62,9 +74,17 @@ private:
 	SampleRateConverter(SampleRateConverter&&) = delete;
 	SampleRateConverter& operator=(SampleRateConverter&&) = delete;
 
+	// The filter impulse response does not depend on the sample rates,
+	// so it is calculated only once and shared by all the converters.
+	struct Filter {
+		Filter();
+		std::vector<TFloat> h;
+		std::vector<TFloat> deltaH;
+	};
+	static const Filter& filter();
+
 	void initializeConversion(TFloat inputRate, TFloat outputRate);
 	void initializeBuffer();
-	void initializeFilter();
 	void dataEmpty();
 
 	static TFloat Izero(TFloat x);
@@ -86,8 +106,8 @@ private:
 	unsigned int timeRegister_;
 	int fillCounter_;
 
-	std::vector<TFloat> h_;
-	std::vector<TFloat> deltaH_;
+	const std::vector<TFloat>& h_;
+	const std::vector<TFloat>& deltaH_;
 	std::vector<TFloat> buffer_;
 	std::function<void(float)> output_;
 };
@@ -106,8 +126,8 @@ SampleRateConverter<TFloat>::SampleRateConverter(TFloat inputRate, TFloat output
 		, phaseIncrement_()
 		, timeRegister_()
 		, fillCounter_()
-		, h_(FILTER_LENGTH)
-		, deltaH_(FILTER_LENGTH)
+		, h_(filter().h)
+		, deltaH_(filter().deltaH)
 		, buffer_(BUFFER_SIZE)
 		, output_(output)
 {
@@ -124,6 +144,43 @@ SampleRateConverter<TFloat>::reset()
 	initializeBuffer();
 }
 
+template<typename TFloat>
+void
+SampleRateConverter<TFloat>::setSampleRates(TFloat inputRate, TFloat outputRate)
+{
+	initializeConversion(inputRate, outputRate);
+	reset();
+}
+
+template<typename TFloat>
+void
+SampleRateConverter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(timeRegisterIncrement_);
+	w.write(fillPtr_);
+	w.write(emptyPtr_);
+	w.write(timeRegister_);
+	w.write(fillCounter_);
+	w.writeVector(buffer_);
+}
+
+template<typename TFloat>
+void
+SampleRateConverter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.expect(timeRegisterIncrement_, "sample rate ratio");
+	r.read(fillPtr_);
+	r.read(emptyPtr_);
+	r.read(timeRegister_);
+	r.read(fillCounter_);
+	r.readVector(buffer_);
+	if (fillPtr_ < 0 || fillPtr_ >= static_cast<int>(BUFFER_SIZE) ||
+			emptyPtr_ < 0 || emptyPtr_ >= static_cast<int>(BUFFER_SIZE) ||
+			fillCounter_ < 0 || fillCounter_ >= fillSize_) {
+		THROW_EXCEPTION(InvalidValueException, "[SampleRateConverter] Invalid state.");
+	}
+}
+
 /******************************************************************************
 *
 *  function:  initializeConversion
@@ -135,9 +192,6 @@ template<typename TFloat>
 void
 SampleRateConverter<TFloat>::initializeConversion(TFloat inputRate, TFloat outputRate)
 {
-	/*  INITIALIZE FILTER IMPULSE RESPONSE  */
-	initializeFilter();
-
 	/*  CALCULATE SAMPLE RATE RATIO  */
 	sampleRateRatio_ = outputRate / inputRate;
 
@@ -219,39 +273,48 @@ SampleRateConverter<TFloat>::initializeBuffer()
 
 /******************************************************************************
 *
-*  function:  initializeFilter
+*  function:  Filter
 *
 *  purpose:   Initializes filter impulse response and impulse delta
 *             values.
 *
 ******************************************************************************/
 template<typename TFloat>
-void
-SampleRateConverter<TFloat>::initializeFilter()
+SampleRateConverter<TFloat>::Filter::Filter()
+		: h(FILTER_LENGTH)
+		, deltaH(FILTER_LENGTH)
 {
 	const TFloat beta = 5.658;           /*  kaiser window parameter  */
 	const TFloat lpCutoff = 11.0 / 13.0; /*  (0.846 OF NYQUIST)  */
 
 	/*  INITIALIZE THE FILTER IMPULSE RESPONSE  */
-	h_[0] = lpCutoff;
+	h[0] = lpCutoff;
 	const TFloat x = M_PI / L_RANGE;
 	for (unsigned int i = 1; i < FILTER_LENGTH; i++) {
 		const TFloat y = i * x;
-		h_[i] = std::sin(y * lpCutoff) / y;
+		h[i] = std::sin(y * lpCutoff) / y;
 	}
 
 	/*  APPLY A KAISER WINDOW TO THE IMPULSE RESPONSE  */
 	const TFloat IBeta = 1.0f / Izero(beta);
 	for (unsigned int i = 0; i < FILTER_LENGTH; i++) {
 		const TFloat temp = static_cast<TFloat>(i) / FILTER_LENGTH;
-		h_[i] *= Izero(beta * std::sqrt(1.0f - (temp * temp))) * IBeta;
+		h[i] *= Izero(beta * std::sqrt(1.0f - (temp * temp))) * IBeta;
 	}
 
 	/*  INITIALIZE THE FILTER IMPULSE RESPONSE DELTA VALUES  */
 	for (unsigned int i = 0; i < FILTER_LIMIT; i++) {
-		deltaH_[i] = h_[i + 1] - h_[i];
+		deltaH[i] = h[i + 1] - h[i];
 	}
-	deltaH_[FILTER_LIMIT] = 0.0f - h_[FILTER_LIMIT];
+	deltaH[FILTER_LIMIT] = 0.0f - h[FILTER_LIMIT];
+}
+
+template<typename TFloat>
+const typename SampleRateConverter<TFloat>::Filter&
+SampleRateConverter<TFloat>::filter()
+{
+	static const Filter f;
+	return f;
 }
 
 /******************************************************************************
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef VTM_SILENCE_DETECTOR_H_
+#define VTM_SILENCE_DETECTOR_H_
+
+#define GS_VTM_SILENCE_THRESHOLD (1.0e-6)
+#define GS_VTM_SILENCE_HOLD_TIME (0.005) /* seconds */
+
+#include "DSPState.h"
+
+
+
+namespace GS {
+namespace VTM {
+
+// Detects when a vocal tract model has settled into silence.
+//
+// The model is considered silent when all its excitation amplitudes are zero
+// and the waves in the tube have stayed below GS_VTM_SILENCE_THRESHOLD
+// for GS_VTM_SILENCE_HOLD_TIME seconds. The level of the tube (not of the
+// output) is used, because a closed tract may hold energy that is only
+// radiated after the release. While silent, the model may skip the tube
+// computations and output zeros.
+template<typename TFloat>
+class SilenceDetector {
+public:
+	SilenceDetector()
+		: holdSamples_()
+		, quietCount_()
+	{
+	}
+	~SilenceDetector() = default;
+
+	void reset() {
+		quietCount_ = 0;
+	}
+	void saveState(DSPStateWriter& w) const {
+		w.write(quietCount_);
+	}
+	void loadState(DSPStateReader& r) {
+		r.read(quietCount_);
+	}
+	void setSampleRate(TFloat sampleRate) {
+		holdSamples_ = static_cast<unsigned int>(sampleRate * TFloat{GS_VTM_SILENCE_HOLD_TIME});
+		quietCount_ = 0;
+	}
+
+	// Returns true if the tube computations may be skipped for the current sample.
+	bool silent(bool inputsSilent) {
+		if (!inputsSilent) {
+			quietCount_ = 0;
+			return false;
+		}
+		return quietCount_ >= holdSamples_;
+	}
+
+	// Must be called after each sample that was not skipped and had silent inputs.
+	// tubeLevel is the maximum absolute value of the waves in the tube.
+	void update(TFloat tubeLevel) {
+		if (tubeLevel <= TFloat{GS_VTM_SILENCE_THRESHOLD}) {
+			++quietCount_;
+		} else {
+			quietCount_ = 0;
+		}
+	}
+private:
+	SilenceDetector(const SilenceDetector&) = delete;
+	SilenceDetector& operator=(const SilenceDetector&) = delete;
+	SilenceDetector(SilenceDetector&&) = delete;
+	SilenceDetector& operator=(SilenceDetector&&) = delete;
+
+	unsigned int holdSamples_;
+	unsigned int quietCount_;
+};
+
+} /* namespace VTM */
+} /* namespace GS */
+
+#endif /* VTM_SILENCE_DETECTOR_H_ */
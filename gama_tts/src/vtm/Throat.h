@@ -21,6 +21,8 @@
 #ifndef VTM_THROAT_H_
 #define VTM_THROAT_H_
 
+#include "DSPState.h"
+
 
 
 namespace GS {
@@ -33,6 +35,8 @@ public:
 	~Throat() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat process(TFloat x);
 private:
 	Throat(const Throat&) = delete;
@@ -67,6 +71,20 @@ Throat<TFloat>::reset()
 	y1_ = 0.0;
 }
 
+template<typename TFloat>
+void
+Throat<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(y1_);
+}
+
+template<typename TFloat>
+void
+Throat<TFloat>::loadState(DSPStateReader& r)
+{
+	r.read(y1_);
+}
+
 /******************************************************************************
 *
 *  function:  throat
@@ -0,0 +1,380 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef VTM_TUBE_H_
+#define VTM_TUBE_H_
+
+#include <algorithm> /* max */
+#include <array>
+#include <cmath> /* abs */
+#include <cstddef> /* std::size_t */
+#include <utility> /* index_sequence */
+
+#include "DSPState.h"
+#include "Exception.h"
+
+
+
+namespace GS {
+namespace VTM {
+
+// Connection between two consecutive sections of a tube.
+struct TubeBoundary {
+	enum Type {
+		COPY,          // no loss
+		DELAY,         // damping only
+		JUNCTION,      // two-way scattering junction
+		VELUM_JUNCTION // three-way scattering junction with the first nasal section
+	};
+	static constexpr int NO_FRICATION = -1;
+
+	Type type;
+	int junctionIndex;
+	int fricationTap; // index of the frication tap, or NO_FRICATION
+
+	static constexpr TubeBoundary copy() {
+		return {COPY, -1, NO_FRICATION};
+	}
+	static constexpr TubeBoundary delay(int fricationTap = NO_FRICATION) {
+		return {DELAY, -1, fricationTap};
+	}
+	static constexpr TubeBoundary junction(int junctionIndex, int fricationTap = NO_FRICATION) {
+		return {JUNCTION, junctionIndex, fricationTap};
+	}
+	static constexpr TubeBoundary velumJunction(int fricationTap = NO_FRICATION) {
+		return {VELUM_JUNCTION, -1, fricationTap};
+	}
+};
+
+// Scattering junctions for pressure waves (models 0, 2 and 4).
+template<typename TFloat>
+struct TubePressureJunctions {
+	struct Junction2 {
+		TFloat coeff{};
+		void configure(TFloat leftRadius, TFloat rightRadius) {
+			const TFloat r0_2 = leftRadius * leftRadius;
+			const TFloat r1_2 = rightRadius * rightRadius;
+			coeff = (r0_2 - r1_2) / (r0_2 + r1_2);
+		}
+		template<typename Section>
+		void propagate(Section& left, Section& right, unsigned int in, unsigned int out, TFloat dampingFactor) const {
+			const TFloat delta = coeff * (left.top[out] - right.bottom[out]);
+			right.top[  in] = (left.top[    out] + delta) * dampingFactor;
+			left.bottom[in] = (right.bottom[out] + delta) * dampingFactor;
+		}
+		template<typename Section>
+		void propagate(Section& left, Section& right, unsigned int in, unsigned int out, TFloat dampingFactor,
+				TFloat fricationTap, TFloat frication) const {
+			const TFloat delta = coeff * (left.top[out] - right.bottom[out]);
+			right.top[  in] = (left.top[    out] + delta) * dampingFactor + fricationTap * frication;
+			left.bottom[in] = (right.bottom[out] + delta) * dampingFactor;
+		}
+	};
+	struct Junction3 {
+		TFloat leftAlpha{};
+		TFloat rightAlpha{};
+		TFloat upperAlpha{};
+		void configure(TFloat leftRadius, TFloat rightRadius, TFloat upperRadius) {
+			const TFloat r0_2 = leftRadius * leftRadius;
+			const TFloat r1_2 = rightRadius * rightRadius;
+			const TFloat r2_2 = upperRadius * upperRadius;
+			const TFloat sum = 2.0f / (r0_2 + r1_2 + r2_2);
+			leftAlpha  = sum * r0_2;
+			rightAlpha = sum * r1_2;
+			upperAlpha = sum * r2_2;
+		}
+		template<typename Section>
+		void propagate(Section& left, Section& right, Section& upper, unsigned int in, unsigned int out, TFloat dampingFactor) const {
+			propagate(left, right, upper, in, out, dampingFactor, 0.0, 0.0);
+		}
+		template<typename Section>
+		void propagate(Section& left, Section& right, Section& upper, unsigned int in, unsigned int out, TFloat dampingFactor,
+				TFloat fricationTap, TFloat frication) const {
+			const TFloat junctionPressure =
+					leftAlpha  *  left.top[   out] +
+					rightAlpha * right.bottom[out] +
+					upperAlpha * upper.bottom[out];
+			left.bottom[in] = (junctionPressure -  left.top[   out]) * dampingFactor;
+			right.top[  in] = (junctionPressure - right.bottom[out]) * dampingFactor + fricationTap * frication;
+			upper.top[  in] = (junctionPressure - upper.bottom[out]) * dampingFactor;
+		}
+	};
+};
+
+// Scattering junctions for volume velocity waves (model 5).
+template<typename TFloat>
+struct TubeFlowJunctions {
+	struct Junction2 {
+		TFloat coeff{};
+		void configure(TFloat leftRadius, TFloat rightRadius) {
+			const TFloat r0_2 =  leftRadius *  leftRadius;
+			const TFloat r1_2 = rightRadius * rightRadius;
+			coeff = (r0_2 - r1_2) / (r0_2 + r1_2);
+		}
+		template<typename Section>
+		void propagate(Section& left, Section& right, unsigned int in, unsigned int out, TFloat dampingFactor) const {
+			const TFloat delta = coeff * (left.top[out] + right.bottom[out]);
+			right.top[  in] = (left.top[    out] - delta) * dampingFactor;
+			left.bottom[in] = (right.bottom[out] + delta) * dampingFactor;
+		}
+	};
+	struct Junction3 {
+		TFloat leftCoeff{};
+		TFloat rightCoeff{};
+		TFloat upperCoeff{};
+		void configure(TFloat leftRadius, TFloat rightRadius, TFloat upperRadius) {
+			const TFloat r0_2 =  leftRadius *  leftRadius;
+			const TFloat r1_2 = rightRadius * rightRadius;
+			const TFloat r2_2 = upperRadius * upperRadius;
+			const TFloat c = 1.0f / (r0_2 + r1_2 + r2_2);
+			leftCoeff  = c * (r0_2 - r1_2 - r2_2);
+			rightCoeff = c * (r1_2 - r0_2 - r2_2);
+			upperCoeff = c * (r2_2 - r0_2 - r1_2);
+		}
+		template<typename Section>
+		void propagate(Section& left, Section& right, Section& upper, unsigned int in, unsigned int out, TFloat dampingFactor) const {
+			const TFloat partialInflux = left.top[out] + right.bottom[out] + upper.bottom[out];
+			left.bottom[in] = (right.bottom[out] + upper.bottom[out] + leftCoeff  * partialInflux) * dampingFactor;
+			right.top[  in] = ( left.top[   out] + upper.bottom[out] + rightCoeff * partialInflux) * dampingFactor;
+			upper.top[  in] = ( left.top[   out] + right.bottom[out] + upperCoeff * partialInflux) * dampingFactor;
+		}
+	};
+};
+
+// Waveguide model of the oropharynx and the nasal cavity.
+//
+// Topology must provide:
+//   TOTAL_SECTIONS, TOTAL_JUNCTIONS,
+//   TOTAL_NASAL_SECTIONS, TOTAL_NASAL_JUNCTIONS,
+//   oropharynxBoundaries: std::array<TubeBoundary, TOTAL_SECTIONS - 1>,
+//   nasalBoundaries: std::array<TubeBoundary, TOTAL_NASAL_SECTIONS - 1>.
+// The boundary i connects the sections i and i + 1. The velum junction
+// connects the first nasal section.
+//
+// The propagation through the boundaries is unrolled at compile time.
+template<typename TFloat, unsigned int SectionDelay, typename Topology, template<typename> class Junctions>
+class Tube {
+public:
+	using Junction2 = typename Junctions<TFloat>::Junction2;
+	using Junction3 = typename Junctions<TFloat>::Junction3;
+
+	struct Section {
+		std::array<TFloat, SectionDelay + 1> top{};
+		std::array<TFloat, SectionDelay + 1> bottom{};
+		void reset() {
+			top.fill(0.0);
+			bottom.fill(0.0);
+		}
+		TFloat level() const {
+			TFloat value = 0.0;
+			for (TFloat x : top)    value = std::max(value, std::abs(x));
+			for (TFloat x : bottom) value = std::max(value, std::abs(x));
+			return value;
+		}
+	};
+
+	Tube() { reset(); }
+	~Tube() = default;
+
+	void reset() {
+		for (auto& section : oropharynx_) section.reset();
+		for (auto& section : nasal_)      section.reset();
+		inPtr_  = 0;
+		outPtr_ = 1;
+	}
+	void saveState(DSPStateWriter& w) const {
+		w.write(oropharynx_);
+		w.write(oropharynxJunction_);
+		w.write(nasal_);
+		w.write(nasalJunction_);
+		w.write(velumJunction_);
+		w.write(inPtr_);
+		w.write(outPtr_);
+	}
+	void loadState(DSPStateReader& r) {
+		r.read(oropharynx_);
+		r.read(oropharynxJunction_);
+		r.read(nasal_);
+		r.read(nasalJunction_);
+		r.read(velumJunction_);
+		r.read(inPtr_);
+		r.read(outPtr_);
+		if (inPtr_ > SectionDelay || outPtr_ > SectionDelay) {
+			THROW_EXCEPTION(InvalidValueException, "[Tube] Invalid delay pointers in state.");
+		}
+	}
+
+	// Returns the maximum absolute value of the waves in the tube.
+	TFloat level() const {
+		TFloat value = 0.0;
+		for (const auto& section : oropharynx_) value = std::max(value, section.level());
+		for (const auto& section : nasal_)      value = std::max(value, section.level());
+		return value;
+	}
+
+	Junction2& oropharynxJunction(unsigned int index) { return oropharynxJunction_[index]; }
+	Junction3& velumJunction() { return velumJunction_; }
+	Junction2& nasalJunction(unsigned int index) { return nasalJunction_[index]; }
+
+	// Advances the delay lines by one sample.
+	void movePointers() {
+		inPtr_ = outPtr_;
+		if (outPtr_ == SectionDelay) {
+			outPtr_ = 0;
+		} else {
+			++outPtr_;
+		}
+	}
+
+	// Injects the input at the glottis.
+	// The wave reflected at the glottis is multiplied by reflectionFactor.
+	void setInput(TFloat input, TFloat reflectionFactor) {
+		oropharynx_[0].top[inPtr_] = oropharynx_[0].bottom[outPtr_] * reflectionFactor + input;
+	}
+
+	// fricationTap may be null if no boundary has a frication tap.
+	void propagateOropharynx(TFloat dampingFactor, const TFloat* fricationTap = nullptr, TFloat frication = 0.0) {
+		propagateOropharynx(dampingFactor, fricationTap, frication, std::make_index_sequence<Topology::TOTAL_SECTIONS - 1>{});
+	}
+	void propagateNasal(TFloat dampingFactor) {
+		propagateNasal(dampingFactor, std::make_index_sequence<Topology::TOTAL_NASAL_SECTIONS - 1>{});
+	}
+
+	// Adds a value to the wave that enters a section of the oropharynx from the left.
+	void addToOropharynx(unsigned int section, TFloat value) {
+		oropharynx_[section].top[inPtr_] += value;
+	}
+
+	// Radiation at the mouth/nose, using a reflection (lowpass) filter and
+	// a radiation (highpass) filter. The last junction is the aperture.
+	// Returns the output.
+	template<typename ReflectionFilterType, typename RadiationFilterType>
+	TFloat radiateFromMouth(TFloat dampingFactor, ReflectionFilterType& reflectionFilter, RadiationFilterType& radiationFilter) {
+		return radiate(oropharynx_.back(), oropharynxJunction_.back().coeff, dampingFactor, reflectionFilter, radiationFilter);
+	}
+	template<typename ReflectionFilterType, typename RadiationFilterType>
+	TFloat radiateFromNose(TFloat dampingFactor, ReflectionFilterType& reflectionFilter, RadiationFilterType& radiationFilter) {
+		return radiate(nasal_.back(), nasalJunction_.back().coeff, dampingFactor, reflectionFilter, radiationFilter);
+	}
+
+	// Radiation at the mouth/nose, using a radiation impedance.
+	// Returns the output.
+	template<typename ImpedanceType>
+	TFloat radiateFromMouth(TFloat dampingFactor, ImpedanceType& impedance) {
+		return radiate(oropharynx_.back(), dampingFactor, impedance);
+	}
+	template<typename ImpedanceType>
+	TFloat radiateFromNose(TFloat dampingFactor, ImpedanceType& impedance) {
+		return radiate(nasal_.back(), dampingFactor, impedance);
+	}
+private:
+	Tube(const Tube&) = delete;
+	Tube& operator=(const Tube&) = delete;
+	Tube(Tube&&) = delete;
+	Tube& operator=(Tube&&) = delete;
+
+	template<std::size_t... I>
+	void propagateOropharynx(TFloat dampingFactor, const TFloat* fricationTap, TFloat frication, std::index_sequence<I...>) {
+		(propagateOropharynxBoundary<I>(dampingFactor, fricationTap, frication), ...);
+	}
+	template<std::size_t... I>
+	void propagateNasal(TFloat dampingFactor, std::index_sequence<I...>) {
+		(propagateNasalBoundary<I>(dampingFactor), ...);
+	}
+
+	template<std::size_t I>
+	void propagateOropharynxBoundary(TFloat dampingFactor, const TFloat* fricationTap, TFloat frication) {
+		constexpr TubeBoundary boundary = Topology::oropharynxBoundaries[I];
+		Section& left  = oropharynx_[I];
+		Section& right = oropharynx_[I + 1];
+
+		if constexpr (boundary.type == TubeBoundary::COPY) {
+			static_assert(boundary.fricationTap == TubeBoundary::NO_FRICATION, "Invalid frication tap.");
+			right.top[  inPtr_] = left.top[    outPtr_];
+			left.bottom[inPtr_] = right.bottom[outPtr_];
+		} else if constexpr (boundary.type == TubeBoundary::DELAY) {
+			if constexpr (boundary.fricationTap == TubeBoundary::NO_FRICATION) {
+				right.top[  inPtr_] = left.top[    outPtr_] * dampingFactor;
+			} else {
+				right.top[  inPtr_] = left.top[    outPtr_] * dampingFactor + fricationTap[boundary.fricationTap] * frication;
+			}
+			left.bottom[inPtr_] = right.bottom[outPtr_] * dampingFactor;
+		} else if constexpr (boundary.type == TubeBoundary::JUNCTION) {
+			if constexpr (boundary.fricationTap == TubeBoundary::NO_FRICATION) {
+				oropharynxJunction_[boundary.junctionIndex].propagate(left, right, inPtr_, outPtr_, dampingFactor);
+			} else {
+				oropharynxJunction_[boundary.junctionIndex].propagate(left, right, inPtr_, outPtr_, dampingFactor,
+											fricationTap[boundary.fricationTap], frication);
+			}
+		} else {
+			if constexpr (boundary.fricationTap == TubeBoundary::NO_FRICATION) {
+				velumJunction_.propagate(left, right, nasal_[0], inPtr_, outPtr_, dampingFactor);
+			} else {
+				velumJunction_.propagate(left, right, nasal_[0], inPtr_, outPtr_, dampingFactor,
+								fricationTap[boundary.fricationTap], frication);
+			}
+		}
+	}
+	template<std::size_t I>
+	void propagateNasalBoundary(TFloat dampingFactor) {
+		constexpr TubeBoundary boundary = Topology::nasalBoundaries[I];
+		static_assert(boundary.fricationTap == TubeBoundary::NO_FRICATION, "Invalid frication tap.");
+		static_assert(boundary.type != TubeBoundary::VELUM_JUNCTION, "Invalid boundary type.");
+		Section& left  = nasal_[I];
+		Section& right = nasal_[I + 1];
+
+		if constexpr (boundary.type == TubeBoundary::COPY) {
+			right.top[  inPtr_] = left.top[    outPtr_];
+			left.bottom[inPtr_] = right.bottom[outPtr_];
+		} else if constexpr (boundary.type == TubeBoundary::DELAY) {
+			right.top[  inPtr_] = left.top[    outPtr_] * dampingFactor;
+			left.bottom[inPtr_] = right.bottom[outPtr_] * dampingFactor;
+		} else {
+			nasalJunction_[boundary.junctionIndex].propagate(left, right, inPtr_, outPtr_, dampingFactor);
+		}
+	}
+
+	template<typename ReflectionFilterType, typename RadiationFilterType>
+	TFloat radiate(Section& section, TFloat apertureCoeff, TFloat dampingFactor,
+			ReflectionFilterType& reflectionFilter, RadiationFilterType& radiationFilter) {
+		// Reflected signal goes through a lowpass filter.
+		section.bottom[inPtr_] = dampingFactor * reflectionFilter.filter(apertureCoeff * section.top[outPtr_]);
+
+		// Output goes through a highpass filter.
+		return radiationFilter.filter((1.0f + apertureCoeff) * section.top[outPtr_]);
+	}
+	template<typename ImpedanceType>
+	TFloat radiate(Section& section, TFloat dampingFactor, ImpedanceType& impedance) {
+		TFloat outputFlow;
+		impedance.process(section.top[outPtr_], outputFlow, section.bottom[inPtr_]);
+		section.bottom[inPtr_] *= dampingFactor;
+		return outputFlow;
+	}
+
+	std::array<Section, Topology::TOTAL_SECTIONS> oropharynx_;
+	std::array<Junction2, Topology::TOTAL_JUNCTIONS> oropharynxJunction_;
+	std::array<Section, Topology::TOTAL_NASAL_SECTIONS> nasal_;
+	std::array<Junction2, Topology::TOTAL_NASAL_JUNCTIONS> nasalJunction_;
+	Junction3 velumJunction_;
+	unsigned int inPtr_;
+	unsigned int outPtr_;
+};
+
+} /* namespace VTM */
+} /* namespace GS */
+
+#endif /* VTM_TUBE_H_ */
@@ -32,8 +32,41 @@
 namespace GS {
 namespace VTM {
 
+void
+VocalTractModel::execSynthesisSteps(const float* frames, std::size_t numFrames, std::size_t numParameters) noexcept
+{
+	for (std::size_t i = 0; i < numFrames; ++i, frames += numParameters) {
+		setAllParameters(frames, numParameters);
+		execSynthesisStep();
+	}
+}
+
+void
+VocalTractModel::saveState(std::vector<unsigned char>& /*state*/) const
+{
+	THROW_EXCEPTION(InvalidCallException, "[VocalTractModel::saveState] This vocal tract model does not support state snapshots.");
+}
+
+void
+VocalTractModel::loadState(const std::vector<unsigned char>& /*state*/)
+{
+	THROW_EXCEPTION(InvalidCallException, "[VocalTractModel::loadState] This vocal tract model does not support state snapshots.");
+}
+
+void
+VocalTractModel::setTubeLengthAndTemperature(double /*length*/, double /*temperature*/)
+{
+	THROW_EXCEPTION(InvalidCallException, "[VocalTractModel::setTubeLengthAndTemperature] This vocal tract model does not support changing the tube length.");
+}
+
+void
+VocalTractModel::setOutputSampleRate(double /*outputRate*/)
+{
+	THROW_EXCEPTION(InvalidCallException, "[VocalTractModel::setOutputSampleRate] This vocal tract model does not support changing the output sample rate.");
+}
+
 std::unique_ptr<VocalTractModel>
-VocalTractModel::getInstance(const ConfigurationData& data, bool interactive)
+VocalTractModel::getInstance(const ConfigurationData& data, bool interactive, bool draft)
 {
 	const unsigned int modelNumber = data.value<unsigned int>("model");
 	switch (modelNumber) {
@@ -46,8 +79,14 @@ VocalTractModel::getInstance(const ConfigurationData& data, bool interactive)
 	case 3:
 		return std::make_unique<VocalTractModel2<double, 3>>(data, interactive);
 	case 4:
+		if (draft) {
+			return std::make_unique<VocalTractModel4<double, 1, true>>(data, interactive);
+		}
 		return std::make_unique<VocalTractModel4<double, 1>>(data, interactive);
 	case 5:
+		if (draft) {
+			return std::make_unique<VocalTractModel5<double, 1, true>>(data, interactive);
+		}
 		return std::make_unique<VocalTractModel5<double, 1>>(data, interactive);
 #ifdef ENABLE_VTM_PLUGINS
 	case 2000:
@@ -29,6 +29,7 @@
 #ifndef VTM_VOCAL_TRACT_MODEL_H_
 #define VTM_VOCAL_TRACT_MODEL_H_
 
+#include <cstddef> /* std::size_t */
 #include <memory>
 #include <vector>
 
@@ -40,6 +41,8 @@ class ConfigurationData;
 
 namespace VTM {
 
+// The plugins that use the ABI version 1 implement this class, so new
+// virtual functions must be added after the existing ones.
 class VocalTractModel {
 public:
 	VocalTractModel() = default;
@@ -51,14 +54,51 @@ public:
 	virtual double outputSampleRate() const noexcept = 0;
 
 	virtual void setParameter(int parameter, float value) noexcept = 0;
-	virtual void setAllParameters(const std::vector<float>& parameters) noexcept = 0;
+	virtual void setAllParameters(const float* parameters, std::size_t numParameters) noexcept = 0;
+	void setAllParameters(const std::vector<float>& parameters) noexcept {
+		setAllParameters(parameters.data(), parameters.size());
+	}
 
 	virtual void execSynthesisStep() noexcept = 0;
 	virtual void finishSynthesis() noexcept = 0;
 
 	virtual std::vector<float>& outputBuffer() noexcept = 0;
 
-	static std::unique_ptr<VocalTractModel> getInstance(const ConfigurationData& data, bool interactive = false);
+	// Executes one synthesis step for each frame. frames contains numFrames
+	// consecutive sets of numParameters parameters.
+	// The default implementation calls setAllParameters() and execSynthesisStep()
+	// for each frame.
+	virtual void execSynthesisSteps(const float* frames, std::size_t numFrames, std::size_t numParameters) noexcept;
+
+	// Saves the complete DSP state of the model (delay lines, filters,
+	// oscillators, noise generators and the pending output samples).
+	// The state can only be restored in a model created with the same
+	// configuration, by the same build of the program.
+	// The default implementation throws InvalidCallException.
+	virtual void saveState(std::vector<unsigned char>& state) const;
+
+	// Restores a state saved by saveState().
+	// Throws InvalidValueException if the state is not compatible.
+	// If an exception is thrown, the model must be reset before being used.
+	virtual void loadState(const std::vector<unsigned char>& state);
+
+	// Changes the nominal tube length (cm, including the offset) and the
+	// tube temperature (degrees Celsius) without recreating the model.
+	// Only the components that depend on the internal sample rate are
+	// updated, and the model is reset, so this must be called between
+	// utterances. The length is limited to the range supported by the model.
+	// The default implementation throws InvalidCallException.
+	virtual void setTubeLengthAndTemperature(double length, double temperature);
+
+	// Changes the output sample rate without recreating the model.
+	// The model is reset, so this must be called between utterances.
+	// The default implementation throws InvalidCallException.
+	virtual void setOutputSampleRate(double outputRate);
+
+	// If draft is true, the models with 30 oral sections (4 and 5) use a
+	// tube with 10 sections, which is about 3 times faster, with lower
+	// quality. The other models ignore this flag.
+	static std::unique_ptr<VocalTractModel> getInstance(const ConfigurationData& data, bool interactive = false, bool draft = false);
 protected:
 	enum {
 		OUTPUT_BUFFER_RESERVE = 1024
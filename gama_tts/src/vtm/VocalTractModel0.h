@@ -21,22 +21,25 @@
 #ifndef VTM_VOCAL_TRACT_MODEL_0_H_
 #define VTM_VOCAL_TRACT_MODEL_0_H_
 
-#include <algorithm> /* max */
+#include <algorithm> /* clamp, max */
 #include <array>
 #include <cstddef> /* std::size_t */
-#include <cstring> /* memset */
 #include <memory>
 #include <vector>
 
 #include "BandpassFilter.h"
 #include "ConfigurationData.h"
+#include "DSPState.h"
+#include "Exception.h"
 #include "Log.h"
 #include "NoiseFilter.h"
 #include "NoiseSource.h"
 #include "RadiationFilter.h"
 #include "ReflectionFilter.h"
 #include "SampleRateConverter.h"
+#include "SilenceDetector.h"
 #include "Throat.h"
+#include "Tube.h"
 #include "VocalTractModel.h"
 #include "VTMUtil.h"
 #include "WavetableGlottalSource.h"
@@ -65,16 +68,24 @@ public:
 	virtual double outputSampleRate() const noexcept { return config_.outputRate; }
 
 	virtual void setParameter(int parameter, float value) noexcept;
-	virtual void setAllParameters(const std::vector<float>& parameters) noexcept;
+	virtual void setAllParameters(const float* parameters, std::size_t numParameters) noexcept;
+	using VocalTractModel::setAllParameters;
 
 	virtual void execSynthesisStep() noexcept;
 	virtual void finishSynthesis() noexcept;
 
 	virtual std::vector<float>& outputBuffer() noexcept { return outputBuffer_; }
 
+	virtual void saveState(std::vector<unsigned char>& state) const;
+	virtual void loadState(const std::vector<unsigned char>& state);
+
+	virtual void setTubeLengthAndTemperature(double length, double temperature);
+	virtual void setOutputSampleRate(double outputRate);
+
 private:
 	static constexpr TFloat MIN_VOCAL_TRACT_LENGTH = 3.0;
 	static constexpr TFloat MAX_VOCAL_TRACT_LENGTH = 30.0;
+	static constexpr std::size_t NOISE_BLOCK_SIZE = 64;
 
 	enum { /*  OROPHARYNX REGIONS  */
 		R1 = 0, /*  S1  */
@@ -136,12 +147,6 @@ private:
 		NC6 = N6, /*  N6-AIR  */
 		TOTAL_NASAL_COEFFICIENTS = TOTAL_NASAL_SECTIONS
 	};
-	enum { /*  THREE-WAY JUNCTION ALPHA COEFFICIENTS  */
-		LEFT  = 0,
-		RIGHT = 1,
-		UPPER = 2,
-		TOTAL_ALPHA_COEFFICIENTS = 3
-	};
 	enum { /*  FRICATION INJECTION COEFFICIENTS  */
 		FC1 = 0, /*  S3  */
 		FC2 = 1, /*  S4  */
@@ -153,10 +158,6 @@ private:
 		FC8 = 7, /*  S10  */
 		TOTAL_FRIC_COEFFICIENTS = 8
 	};
-	enum { /*  BI-DIRECTIONAL TRANSMISSION LINE POINTERS  */
-		TOP    = 0,
-		BOTTOM = 1
-	};
 	enum ParameterIndex {
 		PARAM_GLOT_PITCH = 0,
 		PARAM_GLOT_VOL   = 1,
@@ -183,6 +184,7 @@ private:
 		TFloat tp;                          /*  % glottal pulse rise time  */
 		TFloat tnMin;                       /*  % glottal pulse fall time minimum  */
 		TFloat tnMax;                       /*  % glottal pulse fall time maximum  */
+		int    tableBankSize;               /*  number of precomputed glottal pulse tables (0=one per closure point)  */
 		TFloat breathiness;                 /*  % glottal source breathiness  */
 		TFloat length;                      /*  nominal tube length (10 - 20 cm)  */
 		TFloat temperature;                 /*  tube temperature (25 - 40 C)  */
@@ -195,10 +197,38 @@ private:
 		TFloat throatCutoff;                /*  throat lp cutoff (50 - nyquist Hz)  */
 		TFloat throatVol;                   /*  throat volume (0 - 48 dB) */
 		int    modulation;                  /*  pulse mod. of noise (0=OFF, 1=ON)  */
+		int    noiseGenerator;              /*  NoiseSource::Generator  */
 		TFloat mixOffset;                   /*  noise crossmix offset (30 - 60 dB)  */
 		std::array<TFloat, TOTAL_REGIONS> radiusCoef;
 	};
 
+	struct Topology {
+		enum {
+			TOTAL_SECTIONS        = VocalTractModel0::TOTAL_SECTIONS,
+			TOTAL_JUNCTIONS       = TOTAL_COEFFICIENTS,
+			TOTAL_NASAL_SECTIONS  = VocalTractModel0::TOTAL_NASAL_SECTIONS,
+			TOTAL_NASAL_JUNCTIONS = TOTAL_NASAL_COEFFICIENTS
+		};
+		static constexpr std::array<TubeBoundary, TOTAL_SECTIONS - 1> oropharynxBoundaries = {{
+			TubeBoundary::junction(C1),      /*  S1-S2  */
+			TubeBoundary::junction(C2, FC1), /*  S2-S3  */
+			TubeBoundary::junction(C3, FC2), /*  S3-S4  */
+			TubeBoundary::velumJunction(FC3),/*  S4-S5  */
+			TubeBoundary::junction(C4, FC4), /*  S5-S6  */
+			TubeBoundary::delay(FC5),        /*  S6-S7  */
+			TubeBoundary::junction(C5, FC6), /*  S7-S8  */
+			TubeBoundary::junction(C6, FC7), /*  S8-S9  */
+			TubeBoundary::junction(C7, FC8)  /*  S9-S10  */
+		}};
+		static constexpr std::array<TubeBoundary, TOTAL_NASAL_SECTIONS - 1> nasalBoundaries = {{
+			TubeBoundary::junction(NC1),     /*  N1-N2  */
+			TubeBoundary::junction(NC2),     /*  N2-N3  */
+			TubeBoundary::junction(NC3),     /*  N3-N4  */
+			TubeBoundary::junction(NC4),     /*  N4-N5  */
+			TubeBoundary::junction(NC5)      /*  N5-N6  */
+		}};
+	};
+
 	VocalTractModel0(const VocalTractModel0&) = delete;
 	VocalTractModel0& operator=(const VocalTractModel0&) = delete;
 	VocalTractModel0(VocalTractModel0&&) = delete;
@@ -206,10 +236,12 @@ private:
 
 	void loadConfiguration(const ConfigurationData& data);
 	void initializeSynthesizer();
+	void initializeSampleRate();
 	void calculateTubeCoefficients();
 	void initializeNasalCavity();
 	void setFricationTaps();
 	TFloat vocalTract(TFloat input, TFloat frication);
+	TFloat nextLowpassNoise();
 
 	bool interactive_;
 	Configuration config_;
@@ -218,15 +250,7 @@ private:
 	int sampleRate_;
 
 	/*  MEMORY FOR TUBE AND TUBE COEFFICIENTS  */
-	TFloat oropharynx_[TOTAL_SECTIONS][2][2];
-	TFloat oropharynxCoeff_[TOTAL_COEFFICIENTS];
-
-	TFloat nasal_[TOTAL_NASAL_SECTIONS][2][2];
-	TFloat nasalCoeff_[TOTAL_NASAL_COEFFICIENTS];
-
-	TFloat alpha_[TOTAL_ALPHA_COEFFICIENTS];
-	int currentPtr_;
-	int prevPtr_;
+	Tube<TFloat, 1, Topology, TubePressureJunctions> tube_;
 
 	/*  MEMORY FOR FRICATION TAPS  */
 	TFloat fricationTap_[TOTAL_FRIC_COEFFICIENTS];
@@ -247,6 +271,9 @@ private:
 	std::unique_ptr<BandpassFilter<TFloat>>          bandpassFilter_;
 	std::unique_ptr<NoiseFilter<TFloat>>             noiseFilter_;
 	std::unique_ptr<NoiseSource>                     noiseSource_;
+	std::array<TFloat, NOISE_BLOCK_SIZE>             noiseBlock_;
+	std::size_t                                      noiseBlockIndex_;
+	SilenceDetector<TFloat>                          silenceDetector_;
 };
 
 
@@ -270,6 +297,7 @@ VocalTractModel0<TFloat>::loadConfiguration(const ConfigurationData& data)
 	config_.tp             = data.value<TFloat>("glottal_pulse_tp");
 	config_.tnMin          = data.value<TFloat>("glottal_pulse_tn_min");
 	config_.tnMax          = data.value<TFloat>("glottal_pulse_tn_max");
+	config_.tableBankSize  = data.value<int>("glottal_pulse_table_bank_size", 0, 1024);
 	config_.breathiness    = data.value<TFloat>("breathiness");
 	config_.length         = data.value<TFloat>("vocal_tract_length_offset") + data.value<TFloat>("vocal_tract_length");
 	if (config_.length < MIN_VOCAL_TRACT_LENGTH) {
@@ -284,6 +312,7 @@ VocalTractModel0<TFloat>::loadConfiguration(const ConfigurationData& data)
 	config_.throatCutoff   = data.value<TFloat>("throat_cutoff");
 	config_.throatVol      = data.value<TFloat>("throat_volume");
 	config_.modulation     = data.value<int>("noise_modulation");
+	config_.noiseGenerator = data.value<int>("noise_generator");
 	config_.mixOffset      = data.value<TFloat>("mix_offset");
 	const TFloat globalRadiusCoef      = data.value<TFloat>("global_radius_coef");
 	const TFloat globalNasalRadiusCoef = data.value<TFloat>("global_nasal_radius_coef");
@@ -308,10 +337,7 @@ template<typename TFloat>
 void
 VocalTractModel0<TFloat>::reset() noexcept
 {
-	memset(&oropharynx_[0][0][0], 0, sizeof(TFloat) * TOTAL_SECTIONS * 2 * 2);
-	memset(&nasal_[0][0][0],      0, sizeof(TFloat) * TOTAL_NASAL_SECTIONS * 2 * 2);
-	currentPtr_ = 1;
-	prevPtr_    = 0;
+	tube_.reset();
 	outputBuffer_.clear();
 	if (srConv_)                srConv_->reset();
 	if (mouthRadiationFilter_)  mouthRadiationFilter_->reset();
@@ -323,6 +349,8 @@ VocalTractModel0<TFloat>::reset() noexcept
 	if (bandpassFilter_)        bandpassFilter_->reset();
 	if (noiseFilter_)           noiseFilter_->reset();
 	if (noiseSource_)           noiseSource_->reset();
+	noiseBlockIndex_ = NOISE_BLOCK_SIZE;
+	silenceDetector_.reset();
 }
 
 /******************************************************************************
@@ -337,13 +365,7 @@ template<typename TFloat>
 void
 VocalTractModel0<TFloat>::initializeSynthesizer()
 {
-	TFloat nyquist;
-
-	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
-	const TFloat c = Util::speedOfSound(config_.temperature);
-	sampleRate_ = static_cast<int>((c * TOTAL_SECTIONS * 100.0f) / config_.length);
-	nyquist = sampleRate_ / 2.0f;
-	if (!interactive_) LOG_DEBUG("[VocalTractModel0] Internal sample rate: " << sampleRate_);
+	initializeSampleRate();
 
 	/*  CALCULATE THE BREATHINESS FACTOR  */
 	breathinessFactor_ = config_.breathiness / 100.0f;
@@ -360,7 +382,45 @@ VocalTractModel0<TFloat>::initializeSynthesizer()
 							WavetableGlottalSource<TFloat>::Type::pulse :
 							WavetableGlottalSource<TFloat>::Type::sine,
 						sampleRate_,
-						config_.tp, config_.tnMin, config_.tnMax);
+						config_.tp, config_.tnMin, config_.tnMax,
+						config_.tableBankSize);
+
+	/*  INITIALIZE NASAL CAVITY FIXED SCATTERING COEFFICIENTS  */
+	initializeNasalCavity();
+
+	/*  INITIALIZE THE SAMPLE RATE CONVERSION ROUTINES  */
+	srConv_ = std::make_unique<SampleRateConverter<TFloat>>(
+					sampleRate_,
+					config_.outputRate,
+					[&](float sample) {
+						outputBuffer_.push_back(sample);
+					});
+
+	bandpassFilter_ = std::make_unique<BandpassFilter<TFloat>>();
+	noiseFilter_    = std::make_unique<NoiseFilter<TFloat>>();
+	noiseSource_    = std::make_unique<NoiseSource>(config_.noiseGenerator);
+}
+
+/******************************************************************************
+*
+*  function:  initializeSampleRate
+*
+*  purpose:   Calculates the sample rate, and creates the filters
+*             whose coefficients depend on it.
+*
+******************************************************************************/
+template<typename TFloat>
+void
+VocalTractModel0<TFloat>::initializeSampleRate()
+{
+	TFloat nyquist;
+
+	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
+	const TFloat c = Util::speedOfSound(config_.temperature);
+	sampleRate_ = static_cast<int>((c * TOTAL_SECTIONS * 100.0f) / config_.length);
+	silenceDetector_.setSampleRate(sampleRate_);
+	nyquist = sampleRate_ / 2.0f;
+	if (!interactive_) LOG_DEBUG("[VocalTractModel0] Internal sample rate: " << sampleRate_);
 
 	/*  INITIALIZE REFLECTION AND RADIATION FILTER COEFFICIENTS FOR MOUTH  */
 	TFloat mouthApertureCoeff = (nyquist - config_.mouthCoef) / nyquist;
@@ -372,23 +432,33 @@ VocalTractModel0<TFloat>::initializeSynthesizer()
 	nasalRadiationFilter_  = std::make_unique<RadiationFilter<TFloat>>(nasalApertureCoeff);
 	nasalReflectionFilter_ = std::make_unique<ReflectionFilter<TFloat>>(nasalApertureCoeff);
 
-	/*  INITIALIZE NASAL CAVITY FIXED SCATTERING COEFFICIENTS  */
-	initializeNasalCavity();
-
 	/*  INITIALIZE THE THROAT LOWPASS FILTER  */
 	throat_ = std::make_unique<Throat<TFloat>>(sampleRate_, config_.throatCutoff, Util::amplitude60dB(config_.throatVol));
+}
 
-	/*  INITIALIZE THE SAMPLE RATE CONVERSION ROUTINES  */
-	srConv_ = std::make_unique<SampleRateConverter<TFloat>>(
-					sampleRate_,
-					config_.outputRate,
-					[&](float sample) {
-						outputBuffer_.push_back(sample);
-					});
+template<typename TFloat>
+void
+VocalTractModel0<TFloat>::setTubeLengthAndTemperature(double length, double temperature)
+{
+	config_.length      = std::clamp(static_cast<TFloat>(length), MIN_VOCAL_TRACT_LENGTH, MAX_VOCAL_TRACT_LENGTH);
+	config_.temperature = temperature;
+
+	const int prevSampleRate = sampleRate_;
+	initializeSampleRate();
+	if (sampleRate_ != prevSampleRate) {
+		glottalSource_->setSampleRate(sampleRate_);
+		srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	}
+	reset();
+}
 
-	bandpassFilter_ = std::make_unique<BandpassFilter<TFloat>>();
-	noiseFilter_    = std::make_unique<NoiseFilter<TFloat>>();
-	noiseSource_    = std::make_unique<NoiseSource>();
+template<typename TFloat>
+void
+VocalTractModel0<TFloat>::setOutputSampleRate(double outputRate)
+{
+	config_.outputRate = outputRate;
+	srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	reset();
 }
 
 template<typename TFloat>
@@ -399,13 +469,29 @@ VocalTractModel0<TFloat>::execSynthesisStep() noexcept
 	TFloat f0 = Util::frequency(currentParameter_[PARAM_GLOT_PITCH]);
 	TFloat ax = Util::amplitude60dB(currentParameter_[PARAM_GLOT_VOL]);
 	TFloat ah1 = Util::amplitude60dB(currentParameter_[PARAM_ASP_VOL]);
+
+	const bool inputsSilent = ax == 0.0f && ah1 == 0.0f &&
+					Util::amplitude60dB(currentParameter_[PARAM_FRIC_VOL]) == 0.0f;
+
+	/*  SKIP THE TRACT WHILE SILENT, BUT KEEP THE SOURCES RUNNING  */
+	if (silenceDetector_.silent(inputsSilent)) {
+		bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
+		bandpassFilter_->filter(nextLowpassNoise());
+		if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
+			glottalSource_->setup(ax);
+		}
+		glottalSource_->getSample(f0);
+		srConv_->dataFill(0.0);
+		return;
+	}
+
 	calculateTubeCoefficients();
 	setFricationTaps();
 	bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
 
 	/*  DO SYNTHESIS HERE  */
 	/*  CREATE LOW-PASS FILTERED NOISE  */
-	TFloat lpNoise = noiseFilter_->filter(noiseSource_->getSample());
+	TFloat lpNoise = nextLowpassNoise();
 
 	/*  UPDATE THE SHAPE OF THE GLOTTAL PULSE, IF NECESSARY  */
 	if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
@@ -441,6 +527,7 @@ VocalTractModel0<TFloat>::execSynthesisStep() noexcept
 	signal += throat_->process(pulse * TFloat{GS_VTM0_VT_SCALE});
 
 	/*  OUTPUT SAMPLE HERE  */
+	if (inputsSilent) silenceDetector_.update(tube_.level());
 	srConv_->dataFill(signal);
 }
 
@@ -458,15 +545,11 @@ VocalTractModel0<TFloat>::initializeNasalCavity()
 {
 	/*  CALCULATE COEFFICIENTS FOR INTERNAL FIXED SECTIONS OF NASAL CAVITY  */
 	for (int i = N2, j = NC2; i < N6; i++, j++) {
-		const TFloat radA2 = config_.nasalRadius[i]     * config_.nasalRadius[i];
-		const TFloat radB2 = config_.nasalRadius[i + 1] * config_.nasalRadius[i + 1];
-		nasalCoeff_[j] = (radA2 - radB2) / (radA2 + radB2);
+		tube_.nasalJunction(j).configure(config_.nasalRadius[i], config_.nasalRadius[i + 1]);
 	}
 
 	/*  CALCULATE THE FIXED COEFFICIENT FOR THE NOSE APERTURE  */
-	const TFloat radA2 = config_.nasalRadius[N6] * config_.nasalRadius[N6];
-	const TFloat radB2 = config_.apertureRadius * config_.apertureRadius;
-	nasalCoeff_[NC6] = (radA2 - radB2) / (radA2 + radB2);
+	tube_.nasalJunction(NC6).configure(config_.nasalRadius[N6], config_.apertureRadius);
 }
 
 /******************************************************************************
@@ -485,30 +568,18 @@ VocalTractModel0<TFloat>::calculateTubeCoefficients()
 {
 	/*  CALCULATE COEFFICIENTS FOR THE OROPHARYNX  */
 	for (int i = 0; i < (TOTAL_REGIONS - 1); i++) {
-		const TFloat radA2 = currentParameter_[PARAM_R1 + i]     * currentParameter_[PARAM_R1 + i];
-		const TFloat radB2 = currentParameter_[PARAM_R1 + i + 1] * currentParameter_[PARAM_R1 + i + 1];
-		oropharynxCoeff_[i] = (radA2 - radB2) / (radA2 + radB2);
+		tube_.oropharynxJunction(i).configure(currentParameter_[PARAM_R1 + i], currentParameter_[PARAM_R1 + i + 1]);
 	}
 
 	/*  CALCULATE THE COEFFICIENT FOR THE MOUTH APERTURE  */
-	TFloat radA2 = currentParameter_[PARAM_R8] * currentParameter_[PARAM_R8];
-	TFloat radB2 = config_.apertureRadius * config_.apertureRadius;
-	oropharynxCoeff_[C8] = (radA2 - radB2) / (radA2 + radB2);
+	tube_.oropharynxJunction(C8).configure(currentParameter_[PARAM_R8], config_.apertureRadius);
 
 	/*  CALCULATE ALPHA COEFFICIENTS FOR 3-WAY JUNCTION  */
 	/*  NOTE:  SINCE JUNCTION IS IN MIDDLE OF REGION 4, r0_2 = r1_2  */
-	const TFloat r1_2 = currentParameter_[PARAM_R4] * currentParameter_[PARAM_R4];
-	const TFloat r0_2 = r1_2;
-	const TFloat r2_2 = currentParameter_[PARAM_VELUM] * currentParameter_[PARAM_VELUM];
-	const TFloat sum = 2.0f / (r0_2 + r1_2 + r2_2);
-	alpha_[LEFT]  = sum * r0_2;
-	alpha_[RIGHT] = sum * r1_2;
-	alpha_[UPPER] = sum * r2_2;
+	tube_.velumJunction().configure(currentParameter_[PARAM_R4], currentParameter_[PARAM_R4], currentParameter_[PARAM_VELUM]);
 
 	/*  AND 1ST NASAL PASSAGE COEFFICIENT  */
-	radA2 = r2_2;
-	radB2 = config_.nasalRadius[N2] * config_.nasalRadius[N2];
-	nasalCoeff_[NC1] = (radA2 - radB2) / (radA2 + radB2);
+	tube_.nasalJunction(NC1).configure(currentParameter_[PARAM_VELUM], config_.nasalRadius[N2]);
 }
 
 /******************************************************************************
@@ -564,102 +635,48 @@ template<typename TFloat>
 TFloat
 VocalTractModel0<TFloat>::vocalTract(TFloat input, TFloat frication)
 {
-	TFloat delta;
-	std::swap(prevPtr_, currentPtr_);
+	tube_.movePointers();
 
 	/*  UPDATE OROPHARYNX  */
 	/*  INPUT TO TOP OF TUBE  */
-	oropharynx_[S1][TOP][currentPtr_] =
-			(oropharynx_[S1][BOTTOM][prevPtr_] * dampingFactor_) + input;
-
-	/*  CALCULATE THE SCATTERING JUNCTIONS FOR S1-S2  */
-	delta = oropharynxCoeff_[C1] *
-			(oropharynx_[S1][TOP][prevPtr_] - oropharynx_[S2][BOTTOM][prevPtr_]);
-	oropharynx_[S2][TOP][currentPtr_] =
-			(oropharynx_[S1][TOP][prevPtr_] + delta) * dampingFactor_;
-	oropharynx_[S1][BOTTOM][currentPtr_] =
-			(oropharynx_[S2][BOTTOM][prevPtr_] + delta) * dampingFactor_;
-
-	/*  CALCULATE THE SCATTERING JUNCTIONS FOR S2-S3 AND S3-S4  */
-	for (int i = S2, j = C2, k = FC1; i < S4; i++, j++, k++) {
-		delta = oropharynxCoeff_[j] *
-				(oropharynx_[i][TOP][prevPtr_] - oropharynx_[i + 1][BOTTOM][prevPtr_]);
-		oropharynx_[i + 1][TOP][currentPtr_] =
-				((oropharynx_[i][TOP][prevPtr_] + delta) * dampingFactor_) +
-				(fricationTap_[k] * frication);
-		oropharynx_[i][BOTTOM][currentPtr_] =
-				(oropharynx_[i + 1][BOTTOM][prevPtr_] + delta) * dampingFactor_;
-	}
-
-	/*  UPDATE 3-WAY JUNCTION BETWEEN THE MIDDLE OF R4 AND NASAL CAVITY  */
-	const TFloat junctionPressure = (alpha_[LEFT] * oropharynx_[S4][TOP][prevPtr_])+
-			(alpha_[RIGHT] * oropharynx_[S5][BOTTOM][prevPtr_]) +
-			(alpha_[UPPER] * nasal_[VELUM][BOTTOM][prevPtr_]);
-	oropharynx_[S4][BOTTOM][currentPtr_] =
-			(junctionPressure - oropharynx_[S4][TOP][prevPtr_]) * dampingFactor_;
-	oropharynx_[S5][TOP][currentPtr_] =
-			((junctionPressure - oropharynx_[S5][BOTTOM][prevPtr_]) * dampingFactor_)
-			+ (fricationTap_[FC3] * frication);
-	nasal_[VELUM][TOP][currentPtr_] =
-			(junctionPressure - nasal_[VELUM][BOTTOM][prevPtr_]) * dampingFactor_;
-
-	/*  CALCULATE JUNCTION BETWEEN R4 AND R5 (S5-S6)  */
-	delta = oropharynxCoeff_[C4] *
-			(oropharynx_[S5][TOP][prevPtr_] - oropharynx_[S6][BOTTOM][prevPtr_]);
-	oropharynx_[S6][TOP][currentPtr_] =
-			((oropharynx_[S5][TOP][prevPtr_] + delta) * dampingFactor_) +
-			(fricationTap_[FC4] * frication);
-	oropharynx_[S5][BOTTOM][currentPtr_] =
-			(oropharynx_[S6][BOTTOM][prevPtr_] + delta) * dampingFactor_;
-
-	/*  CALCULATE JUNCTION INSIDE R5 (S6-S7) (PURE DELAY WITH DAMPING)  */
-	oropharynx_[S7][TOP][currentPtr_] =
-			(oropharynx_[S6][TOP][prevPtr_] * dampingFactor_) +
-			(fricationTap_[FC5] * frication);
-	oropharynx_[S6][BOTTOM][currentPtr_] =
-			oropharynx_[S7][BOTTOM][prevPtr_] * dampingFactor_;
-
-	/*  CALCULATE LAST 3 INTERNAL JUNCTIONS (S7-S8, S8-S9, S9-S10)  */
-	for (int i = S7, j = C5, k = FC6; i < S10; i++, j++, k++) {
-		delta = oropharynxCoeff_[j] *
-				(oropharynx_[i][TOP][prevPtr_] - oropharynx_[i + 1][BOTTOM][prevPtr_]);
-		oropharynx_[i + 1][TOP][currentPtr_] =
-				((oropharynx_[i][TOP][prevPtr_] + delta) * dampingFactor_) +
-				(fricationTap_[k] * frication);
-		oropharynx_[i][BOTTOM][currentPtr_] =
-				(oropharynx_[i + 1][BOTTOM][prevPtr_] + delta) * dampingFactor_;
-	}
+	tube_.setInput(input, dampingFactor_);
 
-	/*  REFLECTED SIGNAL AT MOUTH GOES THROUGH A LOWPASS FILTER  */
-	oropharynx_[S10][BOTTOM][currentPtr_] =  dampingFactor_ *
-			mouthReflectionFilter_->filter(oropharynxCoeff_[C8] *
-							oropharynx_[S10][TOP][prevPtr_]);
+	/*  CALCULATE THE SCATTERING JUNCTIONS  */
+	tube_.propagateOropharynx(dampingFactor_, fricationTap_, frication);
 
-	/*  OUTPUT FROM MOUTH GOES THROUGH A HIGHPASS FILTER  */
-	TFloat output = mouthRadiationFilter_->filter((1.0f + oropharynxCoeff_[C8]) *
-						oropharynx_[S10][TOP][prevPtr_]);
+	/*  OUTPUT FROM MOUTH  */
+	TFloat output = tube_.radiateFromMouth(dampingFactor_, *mouthReflectionFilter_, *mouthRadiationFilter_);
 
 	/*  UPDATE NASAL CAVITY  */
-	for (int i = VELUM, j = NC1; i < N6; i++, j++) {
-		delta = nasalCoeff_[j] *
-				(nasal_[i][TOP][prevPtr_] - nasal_[i + 1][BOTTOM][prevPtr_]);
-		nasal_[i+1][TOP][currentPtr_] =
-				(nasal_[i][TOP][prevPtr_] + delta) * dampingFactor_;
-		nasal_[i][BOTTOM][currentPtr_] =
-				(nasal_[i + 1][BOTTOM][prevPtr_] + delta) * dampingFactor_;
-	}
+	tube_.propagateNasal(dampingFactor_);
 
-	/*  REFLECTED SIGNAL AT NOSE GOES THROUGH A LOWPASS FILTER  */
-	nasal_[N6][BOTTOM][currentPtr_] = dampingFactor_ *
-			nasalReflectionFilter_->filter(nasalCoeff_[NC6] * nasal_[N6][TOP][prevPtr_]);
+	/*  OUTPUT FROM NOSE  */
+	output += tube_.radiateFromNose(dampingFactor_, *nasalReflectionFilter_, *nasalRadiationFilter_);
 
-	/*  OUTPUT FROM NOSE GOES THROUGH A HIGHPASS FILTER  */
-	output += nasalRadiationFilter_->filter((1.0f + nasalCoeff_[NC6]) *
-						nasal_[N6][TOP][prevPtr_]);
 	/*  RETURN SUMMED OUTPUT FROM MOUTH AND NOSE  */
 	return output;
 }
 
+/******************************************************************************
+*
+*  function:  nextLowpassNoise
+*
+*  purpose:   Returns the next sample of lowpass filtered noise.
+*             The noise is generated and filtered in blocks.
+*
+******************************************************************************/
+template<typename TFloat>
+TFloat
+VocalTractModel0<TFloat>::nextLowpassNoise()
+{
+	if (noiseBlockIndex_ == NOISE_BLOCK_SIZE) {
+		noiseSource_->getBlock(noiseBlock_.data(), NOISE_BLOCK_SIZE);
+		noiseFilter_->filter(noiseBlock_.data(), noiseBlock_.data(), NOISE_BLOCK_SIZE);
+		noiseBlockIndex_ = 0;
+	}
+	return noiseBlock_[noiseBlockIndex_++];
+}
+
 template<typename TFloat>
 void
 VocalTractModel0<TFloat>::setParameter(int parameter, float value) noexcept
@@ -695,9 +712,9 @@ VocalTractModel0<TFloat>::setParameter(int parameter, float value) noexcept
 
 template<typename TFloat>
 void
-VocalTractModel0<TFloat>::setAllParameters(const std::vector<float>& parameters) noexcept
+VocalTractModel0<TFloat>::setAllParameters(const float* parameters, std::size_t numParameters) noexcept
 {
-	if (parameters.size() != TOTAL_PARAMETERS) {
+	if (numParameters != TOTAL_PARAMETERS) {
 		// Wrong number of parameters.
 		return; // fail silently
 	}
@@ -722,6 +739,70 @@ VocalTractModel0<TFloat>::finishSynthesis() noexcept
 	srConv_->flushBuffer();
 }
 
+template<typename TFloat>
+void
+VocalTractModel0<TFloat>::saveState(std::vector<unsigned char>& state) const
+{
+	state.clear();
+	DSPStateWriter w(state);
+	w.writeTag("VocalTractModel0");
+	w.write(static_cast<unsigned int>(sizeof(TFloat)));
+	w.write(sampleRate_);
+
+	w.write(currentParameter_);
+	w.write(fricationTap_);
+	w.writeVector(outputBuffer_);
+	tube_.saveState(w);
+	srConv_->saveState(w);
+	mouthRadiationFilter_->saveState(w);
+	mouthReflectionFilter_->saveState(w);
+	nasalRadiationFilter_->saveState(w);
+	nasalReflectionFilter_->saveState(w);
+	throat_->saveState(w);
+	glottalSource_->saveState(w);
+	bandpassFilter_->saveState(w);
+	noiseFilter_->saveState(w);
+	noiseSource_->saveState(w);
+	w.write(noiseBlock_);
+	w.write(noiseBlockIndex_);
+	silenceDetector_.saveState(w);
+}
+
+template<typename TFloat>
+void
+VocalTractModel0<TFloat>::loadState(const std::vector<unsigned char>& state)
+{
+	DSPStateReader r(state);
+	r.readTag("VocalTractModel0");
+	r.expect(static_cast<unsigned int>(sizeof(TFloat)), "floating-point type");
+	r.expect(sampleRate_, "sample rate");
+
+	r.read(currentParameter_);
+	r.read(fricationTap_);
+	r.readVector(outputBuffer_, true);
+	tube_.loadState(r);
+	srConv_->loadState(r);
+	mouthRadiationFilter_->loadState(r);
+	mouthReflectionFilter_->loadState(r);
+	nasalRadiationFilter_->loadState(r);
+	nasalReflectionFilter_->loadState(r);
+	throat_->loadState(r);
+	glottalSource_->loadState(r);
+	bandpassFilter_->loadState(r);
+	noiseFilter_->loadState(r);
+	noiseSource_->loadState(r);
+	r.read(noiseBlock_);
+	r.read(noiseBlockIndex_);
+	silenceDetector_.loadState(r);
+
+	if (noiseBlockIndex_ > NOISE_BLOCK_SIZE) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel0] Invalid noise block index in state: " << noiseBlockIndex_ << '.');
+	}
+	if (!r.atEnd()) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel0] Unexpected data at the end of the state.");
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
@@ -38,14 +38,17 @@
 #ifndef VTM_VOCAL_TRACT_MODEL_2_H_
 #define VTM_VOCAL_TRACT_MODEL_2_H_
 
-#include <algorithm> /* max */
+#include <algorithm> /* clamp, max */
 #include <array>
 #include <cstddef> /* std::size_t */
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "BandpassFilter.h"
 #include "ConfigurationData.h"
+#include "DSPState.h"
+#include "Exception.h"
 #include "Log.h"
 #include "NoiseFilter.h"
 #include "NoiseSource.h"
@@ -53,7 +56,9 @@
 #include "RadiationFilter.h"
 #include "ReflectionFilter.h"
 #include "SampleRateConverter.h"
+#include "SilenceDetector.h"
 #include "Throat.h"
+#include "Tube.h"
 #include "VocalTractModel.h"
 #include "VTMUtil.h"
 #include "WavetableGlottalSource.h"
@@ -82,16 +87,24 @@ public:
 	virtual double outputSampleRate() const noexcept { return config_.outputRate; }
 
 	virtual void setParameter(int parameter, float value) noexcept;
-	virtual void setAllParameters(const std::vector<float>& parameters) noexcept;
+	virtual void setAllParameters(const float* parameters, std::size_t numParameters) noexcept;
+	using VocalTractModel::setAllParameters;
 
 	virtual void execSynthesisStep() noexcept;
 	virtual void finishSynthesis() noexcept;
 
 	virtual std::vector<float>& outputBuffer() noexcept { return outputBuffer_; }
 
+	virtual void saveState(std::vector<unsigned char>& state) const;
+	virtual void loadState(const std::vector<unsigned char>& state);
+
+	virtual void setTubeLengthAndTemperature(double length, double temperature);
+	virtual void setOutputSampleRate(double outputRate);
+
 private:
 	static constexpr TFloat MIN_VOCAL_TRACT_LENGTH = 3.0;
 	static constexpr TFloat MAX_VOCAL_TRACT_LENGTH = 30.0;
+	static constexpr std::size_t NOISE_BLOCK_SIZE = 64;
 
 	enum { /*  OROPHARYNX REGIONS  */
 		R1 = 0, /*  S1  */
@@ -183,8 +196,10 @@ private:
 		PARAM_VELUM      = 15,
 		TOTAL_PARAMETERS = 16
 	};
-	enum LogParameters {
-		log_param_vtm2_pitch
+	enum LogParameter {
+		LOG_PARAM_PITCH      = 0,
+		LOG_PARAM_OUTPUT     = 1,
+		TOTAL_LOG_PARAMETERS = 2
 	};
 
 	struct Configuration {
@@ -193,6 +208,7 @@ private:
 		TFloat tp;                          /*  % glottal pulse rise time  */
 		TFloat tnMin;                       /*  % glottal pulse fall time minimum  */
 		TFloat tnMax;                       /*  % glottal pulse fall time maximum  */
+		int    tableBankSize;               /*  number of precomputed glottal pulse tables (0=one per closure point)  */
 		TFloat breathiness;                 /*  % glottal source breathiness  */
 		TFloat length;                      /*  nominal tube length (10 - 20 cm)  */
 		TFloat temperature;                 /*  tube temperature (25 - 40 C)  */
@@ -205,68 +221,40 @@ private:
 		TFloat throatCutoff;                /*  throat lp cutoff (50 - nyquist Hz)  */
 		TFloat throatVol;                   /*  throat volume (0 - 48 dB) */
 		int    modulation;                  /*  pulse mod. of noise (0=OFF, 1=ON)  */
+		int    noiseGenerator;              /*  NoiseSource::Generator  */
 		TFloat mixOffset;                   /*  noise crossmix offset (30 - 60 dB)  */
 		std::array<TFloat, TOTAL_REGIONS> radiusCoef;
+		std::string logFile;                /*  binary parameter log file  */
+		int    logDecimation;               /*  log one of each N samples  */
 	};
 
-	struct Junction2 {
-		TFloat coeff{};
-		void configure(TFloat leftRadius, TFloat rightRadius) {
-			const TFloat r0_2 = leftRadius * leftRadius;
-			const TFloat r1_2 = rightRadius * rightRadius;
-			coeff = (r0_2 - r1_2) / (r0_2 + r1_2);
-		}
-	};
-	struct Junction3 {
-		TFloat leftAlpha{};
-		TFloat rightAlpha{};
-		TFloat upperAlpha{};
-		void configure(TFloat leftRadius, TFloat rightRadius, TFloat upperRadius) {
-			const TFloat r0_2 = leftRadius * leftRadius;
-			const TFloat r1_2 = rightRadius * rightRadius;
-			const TFloat r2_2 = upperRadius * upperRadius;
-			const TFloat sum = 2.0f / (r0_2 + r1_2 + r2_2);
-			leftAlpha  = sum * r0_2;
-			rightAlpha = sum * r1_2;
-			upperAlpha = sum * r2_2;
-		}
-	};
-	struct Section {
-		std::array<TFloat, SectionDelay + 1> top{};
-		std::array<TFloat, SectionDelay + 1> bottom{};
-		void reset() {
-			top.fill(0.0);
-			bottom.fill(0.0);
-		}
-		static void movePointers(unsigned int& in, unsigned int& out) {
-			in = out;
-			if (out == SectionDelay) {
-				out = 0;
-			} else {
-				++out;
-			}
-		}
+	struct Topology {
+		enum {
+			TOTAL_SECTIONS        = VocalTractModel2::TOTAL_SECTIONS,
+			TOTAL_JUNCTIONS       = VocalTractModel2::TOTAL_JUNCTIONS,
+			TOTAL_NASAL_SECTIONS  = VocalTractModel2::TOTAL_NASAL_SECTIONS,
+			TOTAL_NASAL_JUNCTIONS = VocalTractModel2::TOTAL_NASAL_JUNCTIONS
+		};
+		static constexpr std::array<TubeBoundary, TOTAL_SECTIONS - 1> oropharynxBoundaries = {{
+			TubeBoundary::junction(J1),       // S1-S2
+			TubeBoundary::junction(J2, FC1),  // S2-S3
+			TubeBoundary::junction(J3, FC2),  // S3-S4
+			TubeBoundary::velumJunction(FC3), // S4-S5
+			TubeBoundary::junction(J4, FC4),  // S5-S6
+			TubeBoundary::delay(FC5),         // S6-S7
+			TubeBoundary::junction(J5, FC6),  // S7-S8
+			TubeBoundary::junction(J6, FC7),  // S8-S9
+			TubeBoundary::junction(J7, FC8)   // S9-S10
+		}};
+		static constexpr std::array<TubeBoundary, TOTAL_NASAL_SECTIONS - 1> nasalBoundaries = {{
+			TubeBoundary::junction(NJ1),      // N1-N2
+			TubeBoundary::junction(NJ2),      // N2-N3
+			TubeBoundary::junction(NJ3),      // N3-N4
+			TubeBoundary::junction(NJ4),      // N4-N5
+			TubeBoundary::junction(NJ5)       // N5-N6
+		}};
 	};
 
-	void propagate(Section& left, Section& right, TFloat fricNoise) {
-		right.top[  inPtr_] = left.top[    outPtr_] * dampingFactor_ + fricNoise;
-		left.bottom[inPtr_] = right.bottom[outPtr_] * dampingFactor_;
-	}
-	void propagateJunction(Section& left, Junction2& junction, Section& right, TFloat fricNoise = 0.0) {
-		const TFloat delta = junction.coeff * (left.top[outPtr_] - right.bottom[outPtr_]);
-		right.top[  inPtr_] = (left.top[    outPtr_] + delta) * dampingFactor_ + fricNoise;
-		left.bottom[inPtr_] = (right.bottom[outPtr_] + delta) * dampingFactor_;
-	}
-	void propagateJunction(Section& left, Junction3& junction, Section& right, Section& upper, TFloat fricNoise) {
-		const TFloat junctionPressure =
-				junction.leftAlpha  *  left.top[   outPtr_] +
-				junction.rightAlpha * right.bottom[outPtr_] +
-				junction.upperAlpha * upper.bottom[outPtr_];
-		left.bottom[inPtr_] = (junctionPressure -  left.top[   outPtr_]) * dampingFactor_;
-		right.top[  inPtr_] = (junctionPressure - right.bottom[outPtr_]) * dampingFactor_ + fricNoise;
-		upper.top[  inPtr_] = (junctionPressure - upper.bottom[outPtr_]) * dampingFactor_;
-	}
-
 	VocalTractModel2(const VocalTractModel2&) = delete;
 	VocalTractModel2& operator=(const VocalTractModel2&) = delete;
 	VocalTractModel2(VocalTractModel2&&) = delete;
@@ -274,10 +262,13 @@ private:
 
 	void loadConfiguration(const ConfigurationData& data);
 	void initializeSynthesizer();
+	void initializeSampleRate();
 	void calculateTubeCoefficients();
 	void initializeNasalCavity();
 	void setFricationTaps();
 	TFloat vocalTract(TFloat input, TFloat frication);
+	TFloat nextLowpassNoise();
+	void logParameters(TFloat output);
 
 	bool interactive_;
 	bool logParameters_;
@@ -287,13 +278,7 @@ private:
 	int sampleRate_;
 
 	/*  MEMORY FOR TUBE AND TUBE COEFFICIENTS  */
-	std::array<Section, TOTAL_SECTIONS> oropharynx_;
-	Junction2 oropharynxJunction_[TOTAL_JUNCTIONS];
-	std::array<Section, TOTAL_NASAL_SECTIONS> nasal_;
-	Junction2 nasalJunction_[TOTAL_NASAL_JUNCTIONS];
-	Junction3 velumJunction_;
-	unsigned int inPtr_;
-	unsigned int outPtr_;
+	Tube<TFloat, SectionDelay, Topology, TubePressureJunctions> tube_;
 
 	/*  MEMORY FOR FRICATION TAPS  */
 	std::array<TFloat, TOTAL_FRIC_COEFFICIENTS> fricationTap_;
@@ -314,6 +299,9 @@ private:
 	std::unique_ptr<BandpassFilter<TFloat>>          bandpassFilter_;
 	std::unique_ptr<NoiseFilter<TFloat>>             noiseFilter_;
 	std::unique_ptr<NoiseSource>                     noiseSource_;
+	std::array<TFloat, NOISE_BLOCK_SIZE>             noiseBlock_;
+	std::size_t                                      noiseBlockIndex_;
+	SilenceDetector<TFloat>                          silenceDetector_;
 	ParameterLogger<TFloat>                          paramLogger_;
 };
 
@@ -339,6 +327,7 @@ VocalTractModel2<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	config_.tp             = data.value<TFloat>("glottal_pulse_tp");
 	config_.tnMin          = data.value<TFloat>("glottal_pulse_tn_min");
 	config_.tnMax          = data.value<TFloat>("glottal_pulse_tn_max");
+	config_.tableBankSize  = data.value<int>("glottal_pulse_table_bank_size", 0, 1024);
 	config_.breathiness    = data.value<TFloat>("breathiness");
 	config_.length         = data.value<TFloat>("vocal_tract_length_offset") + data.value<TFloat>("vocal_tract_length");
 	if (config_.length < MIN_VOCAL_TRACT_LENGTH) {
@@ -353,6 +342,7 @@ VocalTractModel2<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	config_.throatCutoff   = data.value<TFloat>("throat_cutoff");
 	config_.throatVol      = data.value<TFloat>("throat_volume");
 	config_.modulation     = data.value<int>("noise_modulation");
+	config_.noiseGenerator = data.value<int>("noise_generator");
 	config_.mixOffset      = data.value<TFloat>("mix_offset");
 	const TFloat globalRadiusCoef      = data.value<TFloat>("global_radius_coef");
 	const TFloat globalNasalRadiusCoef = data.value<TFloat>("global_nasal_radius_coef");
@@ -373,20 +363,17 @@ VocalTractModel2<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	config_.radiusCoef[7]  = data.value<TFloat>("radius_8_coef") * globalRadiusCoef;
 
 	logParameters_ = interactive_ ? false : data.value<bool>("log_parameters");
+	if (logParameters_) {
+		config_.logFile       = data.value<std::string>("log_parameters_file");
+		config_.logDecimation = data.value<int>("log_parameters_decimation", 1, 1000000);
+	}
 }
 
 template<typename TFloat, unsigned int SectionDelay>
 void
 VocalTractModel2<TFloat, SectionDelay>::reset() noexcept
 {
-	for (auto& elem : oropharynx_) {
-		elem.reset();
-	}
-	for (auto& elem : nasal_) {
-		elem.reset();
-	}
-	inPtr_  = 0;
-	outPtr_ = 1;
+	tube_.reset();
 	outputBuffer_.clear();
 	if (srConv_)                srConv_->reset();
 	if (mouthRadiationFilter_)  mouthRadiationFilter_->reset();
@@ -398,6 +385,8 @@ VocalTractModel2<TFloat, SectionDelay>::reset() noexcept
 	if (bandpassFilter_)        bandpassFilter_->reset();
 	if (noiseFilter_)           noiseFilter_->reset();
 	if (noiseSource_)           noiseSource_->reset();
+	noiseBlockIndex_ = NOISE_BLOCK_SIZE;
+	silenceDetector_.reset();
 }
 
 /******************************************************************************
@@ -412,13 +401,7 @@ template<typename TFloat, unsigned int SectionDelay>
 void
 VocalTractModel2<TFloat, SectionDelay>::initializeSynthesizer()
 {
-	TFloat nyquist;
-
-	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
-	const TFloat c = Util::speedOfSound(config_.temperature);
-	sampleRate_ = static_cast<int>((c * (TOTAL_SECTIONS * SectionDelay) * 100.0f) / config_.length);
-	nyquist = sampleRate_ / 2.0f;
-	if (!interactive_) LOG_DEBUG("[VocalTractModel2] Internal sample rate: " << sampleRate_);
+	initializeSampleRate();
 
 	/*  CALCULATE THE BREATHINESS FACTOR  */
 	breathinessFactor_ = config_.breathiness / 100.0f;
@@ -435,7 +418,50 @@ VocalTractModel2<TFloat, SectionDelay>::initializeSynthesizer()
 							WavetableGlottalSource<TFloat>::Type::pulse :
 							WavetableGlottalSource<TFloat>::Type::sine,
 						sampleRate_,
-						config_.tp, config_.tnMin, config_.tnMax);
+						config_.tp, config_.tnMin, config_.tnMax,
+						config_.tableBankSize);
+
+	/*  INITIALIZE NASAL CAVITY FIXED SCATTERING COEFFICIENTS  */
+	initializeNasalCavity();
+
+	/*  INITIALIZE THE SAMPLE RATE CONVERSION ROUTINES  */
+	srConv_ = std::make_unique<SampleRateConverter<TFloat>>(
+					sampleRate_,
+					config_.outputRate,
+					[&](float sample) {
+						outputBuffer_.push_back(sample);
+					});
+
+	bandpassFilter_ = std::make_unique<BandpassFilter<TFloat>>();
+	noiseFilter_    = std::make_unique<NoiseFilter<TFloat>>();
+	noiseSource_    = std::make_unique<NoiseSource>(config_.noiseGenerator);
+
+	if (logParameters_) {
+		paramLogger_.open(config_.logFile, {"log_param_vtm2_pitch", "log_param_vtm2_output"},
+					sampleRate_, config_.logDecimation);
+	}
+}
+
+/******************************************************************************
+*
+*  function:  initializeSampleRate
+*
+*  purpose:   Calculates the sample rate, and creates the filters
+*             whose coefficients depend on it.
+*
+******************************************************************************/
+template<typename TFloat, unsigned int SectionDelay>
+void
+VocalTractModel2<TFloat, SectionDelay>::initializeSampleRate()
+{
+	TFloat nyquist;
+
+	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
+	const TFloat c = Util::speedOfSound(config_.temperature);
+	sampleRate_ = static_cast<int>((c * (TOTAL_SECTIONS * SectionDelay) * 100.0f) / config_.length);
+	silenceDetector_.setSampleRate(sampleRate_);
+	nyquist = sampleRate_ / 2.0f;
+	if (!interactive_) LOG_DEBUG("[VocalTractModel2] Internal sample rate: " << sampleRate_);
 
 	/*  INITIALIZE REFLECTION AND RADIATION FILTER COEFFICIENTS FOR MOUTH  */
 	TFloat mouthApertureCoeff = (nyquist - config_.mouthCoef) / nyquist;
@@ -447,23 +473,33 @@ VocalTractModel2<TFloat, SectionDelay>::initializeSynthesizer()
 	nasalRadiationFilter_  = std::make_unique<RadiationFilter<TFloat>>(nasalApertureCoeff);
 	nasalReflectionFilter_ = std::make_unique<ReflectionFilter<TFloat>>(nasalApertureCoeff);
 
-	/*  INITIALIZE NASAL CAVITY FIXED SCATTERING COEFFICIENTS  */
-	initializeNasalCavity();
-
 	/*  INITIALIZE THE THROAT LOWPASS FILTER  */
 	throat_ = std::make_unique<Throat<TFloat>>(sampleRate_, config_.throatCutoff, Util::amplitude60dB(config_.throatVol));
+}
 
-	/*  INITIALIZE THE SAMPLE RATE CONVERSION ROUTINES  */
-	srConv_ = std::make_unique<SampleRateConverter<TFloat>>(
-					sampleRate_,
-					config_.outputRate,
-					[&](float sample) {
-						outputBuffer_.push_back(sample);
-					});
+template<typename TFloat, unsigned int SectionDelay>
+void
+VocalTractModel2<TFloat, SectionDelay>::setTubeLengthAndTemperature(double length, double temperature)
+{
+	config_.length      = std::clamp(static_cast<TFloat>(length), MIN_VOCAL_TRACT_LENGTH, MAX_VOCAL_TRACT_LENGTH);
+	config_.temperature = temperature;
+
+	const int prevSampleRate = sampleRate_;
+	initializeSampleRate();
+	if (sampleRate_ != prevSampleRate) {
+		glottalSource_->setSampleRate(sampleRate_);
+		srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	}
+	reset();
+}
 
-	bandpassFilter_ = std::make_unique<BandpassFilter<TFloat>>();
-	noiseFilter_    = std::make_unique<NoiseFilter<TFloat>>();
-	noiseSource_    = std::make_unique<NoiseSource>();
+template<typename TFloat, unsigned int SectionDelay>
+void
+VocalTractModel2<TFloat, SectionDelay>::setOutputSampleRate(double outputRate)
+{
+	config_.outputRate = outputRate;
+	srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	reset();
 }
 
 template<typename TFloat, unsigned int SectionDelay>
@@ -474,13 +510,30 @@ VocalTractModel2<TFloat, SectionDelay>::execSynthesisStep() noexcept
 	TFloat f0 = Util::frequency(currentParameter_[PARAM_GLOT_PITCH]);
 	TFloat ax = Util::amplitude60dB(currentParameter_[PARAM_GLOT_VOL]);
 	TFloat ah1 = Util::amplitude60dB(currentParameter_[PARAM_ASP_VOL]);
+
+	const bool inputsSilent = ax == 0.0f && ah1 == 0.0f &&
+					Util::amplitude60dB(currentParameter_[PARAM_FRIC_VOL]) == 0.0f;
+
+	/*  SKIP THE TRACT WHILE SILENT, BUT KEEP THE SOURCES RUNNING  */
+	if (silenceDetector_.silent(inputsSilent)) {
+		bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
+		bandpassFilter_->filter(nextLowpassNoise());
+		if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
+			glottalSource_->setup(ax);
+		}
+		glottalSource_->getSample(f0);
+		srConv_->dataFill(0.0);
+		if (logParameters_) logParameters(0.0);
+		return;
+	}
+
 	calculateTubeCoefficients();
 	setFricationTaps();
 	bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
 
 	/*  DO SYNTHESIS HERE  */
 	/*  CREATE LOW-PASS FILTERED NOISE  */
-	TFloat lpNoise = noiseFilter_->filter(noiseSource_->getSample());
+	TFloat lpNoise = nextLowpassNoise();
 
 	/*  UPDATE THE SHAPE OF THE GLOTTAL PULSE, IF NECESSARY  */
 	if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
@@ -516,9 +569,19 @@ VocalTractModel2<TFloat, SectionDelay>::execSynthesisStep() noexcept
 	signal += throat_->process(pulse * TFloat{GS_VTM2_VT_SCALE});
 
 	/*  OUTPUT SAMPLE HERE  */
+	if (inputsSilent) silenceDetector_.update(tube_.level());
 	srConv_->dataFill(signal);
 
-	if (logParameters_) GS_LOG_PARAMETER(paramLogger_, log_param_vtm2_pitch, currentParameter_[PARAM_GLOT_PITCH]);
+	if (logParameters_) logParameters(signal);
+}
+
+template<typename TFloat, unsigned int SectionDelay>
+void
+VocalTractModel2<TFloat, SectionDelay>::logParameters(TFloat output)
+{
+	paramLogger_.put(LOG_PARAM_PITCH, currentParameter_[PARAM_GLOT_PITCH]);
+	paramLogger_.put(LOG_PARAM_OUTPUT, output);
+	paramLogger_.nextFrame();
 }
 
 /******************************************************************************
@@ -535,11 +598,11 @@ VocalTractModel2<TFloat, SectionDelay>::initializeNasalCavity()
 {
 	// Configure junctions for fixed nasal sections.
 	for (int i = NJ2, j = N2; i < NJ6; ++i, ++j) {
-		nasalJunction_[i].configure(config_.nasalRadius[j], config_.nasalRadius[j + 1]);
+		tube_.nasalJunction(i).configure(config_.nasalRadius[j], config_.nasalRadius[j + 1]);
 	}
 
 	// Configure junction for the nose aperture.
-	nasalJunction_[NJ6].configure(config_.nasalRadius[N6], config_.apertureRadius);
+	tube_.nasalJunction(NJ6).configure(config_.nasalRadius[N6], config_.apertureRadius);
 }
 
 /******************************************************************************
@@ -558,18 +621,18 @@ VocalTractModel2<TFloat, SectionDelay>::calculateTubeCoefficients()
 {
 	// Configure oropharynx junctions.
 	for (int i = J1, j = PARAM_R1; i < J8; ++i, ++j) {
-		oropharynxJunction_[i].configure(currentParameter_[j], currentParameter_[j + 1]);
+		tube_.oropharynxJunction(i).configure(currentParameter_[j], currentParameter_[j + 1]);
 	}
 
 	// Configure junction for the mouth aperture.
-	oropharynxJunction_[J8].configure(currentParameter_[PARAM_R8], config_.apertureRadius);
+	tube_.oropharynxJunction(J8).configure(currentParameter_[PARAM_R8], config_.apertureRadius);
 
 	// Configure 3-way junction.
 	// Note: Since junction is in middle of region 4, leftRadius = rightRadius.
-	velumJunction_.configure(currentParameter_[PARAM_R4], currentParameter_[PARAM_R4], currentParameter_[PARAM_VELUM]);
+	tube_.velumJunction().configure(currentParameter_[PARAM_R4], currentParameter_[PARAM_R4], currentParameter_[PARAM_VELUM]);
 
 	// Configure 1st nasal junction.
-	nasalJunction_[NJ1].configure(currentParameter_[PARAM_VELUM], config_.nasalRadius[N2]);
+	tube_.nasalJunction(NJ1).configure(currentParameter_[PARAM_VELUM], config_.nasalRadius[N2]);
 }
 
 /******************************************************************************
@@ -625,49 +688,47 @@ template<typename TFloat, unsigned int SectionDelay>
 TFloat
 VocalTractModel2<TFloat, SectionDelay>::vocalTract(TFloat input, TFloat frication)
 {
-	Section::movePointers(inPtr_, outPtr_);
+	tube_.movePointers();
 
 	// Input to the tube.
-	oropharynx_[S1].top[inPtr_] = oropharynx_[S1].bottom[outPtr_] * dampingFactor_ + input;
-
-	propagateJunction(oropharynx_[S1], oropharynxJunction_[J1], oropharynx_[S2]);
-
-	for (int i = S2, j = J2, k = FC1; i < S4; ++i, ++j, ++k) {
-		propagateJunction(oropharynx_[i], oropharynxJunction_[j], oropharynx_[i + 1], fricationTap_[k] * frication);
-	}
+	tube_.setInput(input, dampingFactor_);
 
-	// 3-way junction between the middle of R4 and the nasal cavity.
-	propagateJunction(oropharynx_[S4], velumJunction_, oropharynx_[S5], nasal_[VELUM], fricationTap_[FC3] * frication);
-
-	propagateJunction(oropharynx_[S5], oropharynxJunction_[J4], oropharynx_[S6], fricationTap_[FC4] * frication);
-
-	// Pure delay with damping.
-	propagate(oropharynx_[S6], oropharynx_[S7], fricationTap_[FC5] * frication);
-
-	for (int i = S7, j = J5, k = FC6; i < S10; ++i, ++j, ++k) {
-		propagateJunction(oropharynx_[i], oropharynxJunction_[j], oropharynx_[i + 1] , fricationTap_[k] * frication);
-	}
+	tube_.propagateOropharynx(dampingFactor_, fricationTap_.data(), frication);
 
 	// Reflected signal at the mouth goes through a lowpass filter.
-	oropharynx_[S10].bottom[inPtr_] = dampingFactor_ * mouthReflectionFilter_->filter(oropharynxJunction_[J8].coeff * oropharynx_[S10].top[outPtr_]);
-
 	// Output from mouth goes through a highpass filter.
-	TFloat output = mouthRadiationFilter_->filter((1.0f + oropharynxJunction_[J8].coeff) * oropharynx_[S10].top[outPtr_]);
+	TFloat output = tube_.radiateFromMouth(dampingFactor_, *mouthReflectionFilter_, *mouthRadiationFilter_);
 
-	for (int i = N1, j = NJ1; i < N6; ++i, ++j) {
-		propagateJunction(nasal_[i], nasalJunction_[j], nasal_[i + 1]);
-	}
+	tube_.propagateNasal(dampingFactor_);
 
 	// Reflected signal at the nose goes through a lowpass filter.
-	nasal_[N6].bottom[inPtr_] = dampingFactor_ * nasalReflectionFilter_->filter(nasalJunction_[NJ6].coeff * nasal_[N6].top[outPtr_]);
-
 	// Output from nose goes through a highpass filter.
-	output += nasalRadiationFilter_->filter((1.0f + nasalJunction_[NJ6].coeff) * nasal_[N6].top[outPtr_]);
+	output += tube_.radiateFromNose(dampingFactor_, *nasalReflectionFilter_, *nasalRadiationFilter_);
 
 	// Return summed output from mouth and nose.
 	return output;
 }
 
+/******************************************************************************
+*
+*  function:  nextLowpassNoise
+*
+*  purpose:   Returns the next sample of lowpass filtered noise.
+*             The noise is generated and filtered in blocks.
+*
+******************************************************************************/
+template<typename TFloat, unsigned int SectionDelay>
+TFloat
+VocalTractModel2<TFloat, SectionDelay>::nextLowpassNoise()
+{
+	if (noiseBlockIndex_ == NOISE_BLOCK_SIZE) {
+		noiseSource_->getBlock(noiseBlock_.data(), NOISE_BLOCK_SIZE);
+		noiseFilter_->filter(noiseBlock_.data(), noiseBlock_.data(), NOISE_BLOCK_SIZE);
+		noiseBlockIndex_ = 0;
+	}
+	return noiseBlock_[noiseBlockIndex_++];
+}
+
 template<typename TFloat, unsigned int SectionDelay>
 void
 VocalTractModel2<TFloat, SectionDelay>::setParameter(int parameter, float value) noexcept
@@ -703,9 +764,9 @@ VocalTractModel2<TFloat, SectionDelay>::setParameter(int parameter, float value)
 
 template<typename TFloat, unsigned int SectionDelay>
 void
-VocalTractModel2<TFloat, SectionDelay>::setAllParameters(const std::vector<float>& parameters) noexcept
+VocalTractModel2<TFloat, SectionDelay>::setAllParameters(const float* parameters, std::size_t numParameters) noexcept
 {
-	if (parameters.size() != TOTAL_PARAMETERS) {
+	if (numParameters != TOTAL_PARAMETERS) {
 		// Wrong number of parameters.
 		return; // fail silently
 	}
@@ -730,6 +791,72 @@ VocalTractModel2<TFloat, SectionDelay>::finishSynthesis() noexcept
 	srConv_->flushBuffer();
 }
 
+template<typename TFloat, unsigned int SectionDelay>
+void
+VocalTractModel2<TFloat, SectionDelay>::saveState(std::vector<unsigned char>& state) const
+{
+	state.clear();
+	DSPStateWriter w(state);
+	w.writeTag("VocalTractModel2");
+	w.write(static_cast<unsigned int>(sizeof(TFloat)));
+	w.write(SectionDelay);
+	w.write(sampleRate_);
+
+	w.write(currentParameter_);
+	w.write(fricationTap_);
+	w.writeVector(outputBuffer_);
+	tube_.saveState(w);
+	srConv_->saveState(w);
+	mouthRadiationFilter_->saveState(w);
+	mouthReflectionFilter_->saveState(w);
+	nasalRadiationFilter_->saveState(w);
+	nasalReflectionFilter_->saveState(w);
+	throat_->saveState(w);
+	glottalSource_->saveState(w);
+	bandpassFilter_->saveState(w);
+	noiseFilter_->saveState(w);
+	noiseSource_->saveState(w);
+	w.write(noiseBlock_);
+	w.write(noiseBlockIndex_);
+	silenceDetector_.saveState(w);
+}
+
+template<typename TFloat, unsigned int SectionDelay>
+void
+VocalTractModel2<TFloat, SectionDelay>::loadState(const std::vector<unsigned char>& state)
+{
+	DSPStateReader r(state);
+	r.readTag("VocalTractModel2");
+	r.expect(static_cast<unsigned int>(sizeof(TFloat)), "floating-point type");
+	r.expect(SectionDelay, "section delay");
+	r.expect(sampleRate_, "sample rate");
+
+	r.read(currentParameter_);
+	r.read(fricationTap_);
+	r.readVector(outputBuffer_, true);
+	tube_.loadState(r);
+	srConv_->loadState(r);
+	mouthRadiationFilter_->loadState(r);
+	mouthReflectionFilter_->loadState(r);
+	nasalRadiationFilter_->loadState(r);
+	nasalReflectionFilter_->loadState(r);
+	throat_->loadState(r);
+	glottalSource_->loadState(r);
+	bandpassFilter_->loadState(r);
+	noiseFilter_->loadState(r);
+	noiseSource_->loadState(r);
+	r.read(noiseBlock_);
+	r.read(noiseBlockIndex_);
+	silenceDetector_.loadState(r);
+
+	if (noiseBlockIndex_ > NOISE_BLOCK_SIZE) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel2] Invalid noise block index in state: " << noiseBlockIndex_ << '.');
+	}
+	if (!r.atEnd()) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel2] Unexpected data at the end of the state.");
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
@@ -32,27 +32,42 @@
 //                     J1      J2              J3          |           J4          |           J5              J6      J7          J8
 //                             FC1             FC2         FC3         FC4         FC5         FC6             FC7     FC8
 
+// Draft mode (Draft = true):
+// The radii are applied to a tube with 10 oral and 6 nasal sections, with the
+// layout of the model 2 (see VocalTractModel2.h), and the internal sample rate
+// is divided by 3.
+// Quality trade-off:
+// - The bandwidth of the tube is reduced to about 1/3 (10 kHz for a tube
+//   length of 17.5 cm).
+// - The relative lengths of the regions are rounded to whole sections, so the
+//   formant frequencies are a bit different.
+
 // Note:
 // - NoiseFilter has not been adapted for the increased samplerate.
 
 #ifndef VTM_VOCAL_TRACT_MODEL_4_H_
 #define VTM_VOCAL_TRACT_MODEL_4_H_
 
-#include <algorithm> /* max */
+#include <algorithm> /* clamp, max */
 #include <array>
 #include <cstddef> /* std::size_t */
 #include <memory>
+#include <type_traits> /* conditional_t */
 #include <vector>
 
 #include "BandpassFilter.h"
 #include "ConfigurationData.h"
+#include "DSPState.h"
+#include "Exception.h"
 #include "Log.h"
 #include "NoiseFilter.h"
 #include "NoiseSource.h"
 #include "RadiationFilter.h"
 #include "ReflectionFilter.h"
 #include "SampleRateConverter.h"
+#include "SilenceDetector.h"
 #include "Throat.h"
+#include "Tube.h"
 #include "VocalTractModel.h"
 #include "VTMUtil.h"
 #include "WavetableGlottalSource.h"
@@ -69,7 +84,7 @@
 namespace GS {
 namespace VTM {
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft = false>
 class VocalTractModel4 : public VocalTractModel {
 public:
 	explicit VocalTractModel4(const ConfigurationData& data, bool interactive=false);
@@ -81,16 +96,24 @@ public:
 	virtual double outputSampleRate() const noexcept { return config_.outputRate; }
 
 	virtual void setParameter(int parameter, float value) noexcept;
-	virtual void setAllParameters(const std::vector<float>& parameters) noexcept;
+	virtual void setAllParameters(const float* parameters, std::size_t numParameters) noexcept;
+	using VocalTractModel::setAllParameters;
 
 	virtual void execSynthesisStep() noexcept;
 	virtual void finishSynthesis() noexcept;
 
 	virtual std::vector<float>& outputBuffer() noexcept { return outputBuffer_; }
 
+	virtual void saveState(std::vector<unsigned char>& state) const;
+	virtual void loadState(const std::vector<unsigned char>& state);
+
+	virtual void setTubeLengthAndTemperature(double length, double temperature);
+	virtual void setOutputSampleRate(double outputRate);
+
 private:
 	static constexpr TFloat MIN_VOCAL_TRACT_LENGTH = 3.0;
 	static constexpr TFloat MAX_VOCAL_TRACT_LENGTH = 30.0;
+	static constexpr std::size_t NOISE_BLOCK_SIZE = 64;
 
 	enum { /*  OROPHARYNX REGIONS  */
 		R1 = 0, /*  S1  - S3   */
@@ -238,6 +261,7 @@ private:
 		TFloat tp;                          /*  % glottal pulse rise time  */
 		TFloat tnMin;                       /*  % glottal pulse fall time minimum  */
 		TFloat tnMax;                       /*  % glottal pulse fall time maximum  */
+		int    tableBankSize;               /*  number of precomputed glottal pulse tables (0=one per closure point)  */
 		TFloat breathiness;                 /*  % glottal source breathiness  */
 		TFloat length;                      /*  nominal tube length (10 - 20 cm)  */
 		TFloat temperature;                 /*  tube temperature (25 - 40 C)  */
@@ -250,75 +274,96 @@ private:
 		TFloat throatCutoff;                /*  throat lp cutoff (50 - nyquist Hz)  */
 		TFloat throatVol;                   /*  throat volume (0 - 48 dB) */
 		int    modulation;                  /*  pulse mod. of noise (0=OFF, 1=ON)  */
+		int    noiseGenerator;              /*  NoiseSource::Generator  */
 		TFloat mixOffset;                   /*  noise crossmix offset (30 - 60 dB)  */
 		std::array<TFloat, TOTAL_REGIONS> radiusCoef;
 	};
 
-	struct Junction2 {
-		TFloat coeff{};
-		void configure(TFloat leftRadius, TFloat rightRadius) {
-			const TFloat r0_2 = leftRadius * leftRadius;
-			const TFloat r1_2 = rightRadius * rightRadius;
-			coeff = (r0_2 - r1_2) / (r0_2 + r1_2);
-		}
+	struct FullTopology {
+		enum {
+			TOTAL_SECTIONS        = VocalTractModel4::TOTAL_SECTIONS,
+			TOTAL_JUNCTIONS       = VocalTractModel4::TOTAL_JUNCTIONS,
+			TOTAL_NASAL_SECTIONS  = VocalTractModel4::TOTAL_NASAL_SECTIONS,
+			TOTAL_NASAL_JUNCTIONS = VocalTractModel4::TOTAL_NASAL_JUNCTIONS
+		};
+		static constexpr std::array<TubeBoundary, TOTAL_SECTIONS - 1> oropharynxBoundaries = {{
+			TubeBoundary::copy(),             // S1-S2
+			TubeBoundary::copy(),             // S2-S3
+			TubeBoundary::junction(J1),       // S3-S4
+			TubeBoundary::copy(),             // S4-S5
+			TubeBoundary::junction(J2, FC1),  // S5-S6
+			TubeBoundary::copy(),             // S6-S7
+			TubeBoundary::copy(),             // S7-S8
+			TubeBoundary::copy(),             // S8-S9
+			TubeBoundary::junction(J3, FC2),  // S9-S10
+			TubeBoundary::copy(),             // S10-S11
+			TubeBoundary::copy(),             // S11-S12
+			TubeBoundary::velumJunction(FC3), // S12-S13
+			TubeBoundary::copy(),             // S13-S14
+			TubeBoundary::copy(),             // S14-S15
+			TubeBoundary::junction(J4, FC4),  // S15-S16
+			TubeBoundary::copy(),             // S16-S17
+			TubeBoundary::copy(),             // S17-S18
+			TubeBoundary::delay(FC5),         // S18-S19
+			TubeBoundary::copy(),             // S19-S20
+			TubeBoundary::copy(),             // S20-S21
+			TubeBoundary::junction(J5, FC6),  // S21-S22
+			TubeBoundary::copy(),             // S22-S23
+			TubeBoundary::copy(),             // S23-S24
+			TubeBoundary::copy(),             // S24-S25
+			TubeBoundary::junction(J6, FC7),  // S25-S26
+			TubeBoundary::copy(),             // S26-S27
+			TubeBoundary::junction(J7, FC8),  // S27-S28
+			TubeBoundary::copy(),             // S28-S29
+			TubeBoundary::copy()              // S29-S30
+		}};
+		static constexpr std::array<TubeBoundary, TOTAL_NASAL_SECTIONS - 1> nasalBoundaries = {{
+			TubeBoundary::copy(),             // N1-N2
+			TubeBoundary::copy(),             // N2-N3
+			TubeBoundary::junction(NJ1),      // N3-N4
+			TubeBoundary::copy(),             // N4-N5
+			TubeBoundary::copy(),             // N5-N6
+			TubeBoundary::junction(NJ2),      // N6-N7
+			TubeBoundary::copy(),             // N7-N8
+			TubeBoundary::copy(),             // N8-N9
+			TubeBoundary::junction(NJ3),      // N9-N10
+			TubeBoundary::copy(),             // N10-N11
+			TubeBoundary::copy(),             // N11-N12
+			TubeBoundary::junction(NJ4),      // N12-N13
+			TubeBoundary::copy(),             // N13-N14
+			TubeBoundary::copy(),             // N14-N15
+			TubeBoundary::junction(NJ5),      // N15-N16
+			TubeBoundary::copy(),             // N16-N17
+			TubeBoundary::copy()              // N17-N18
+		}};
 	};
-	struct Junction3 {
-		TFloat leftAlpha{};
-		TFloat rightAlpha{};
-		TFloat upperAlpha{};
-		void configure(TFloat leftRadius, TFloat rightRadius, TFloat upperRadius) {
-			const TFloat r0_2 = leftRadius * leftRadius;
-			const TFloat r1_2 = rightRadius * rightRadius;
-			const TFloat r2_2 = upperRadius * upperRadius;
-			const TFloat sum = 2.0f / (r0_2 + r1_2 + r2_2);
-			leftAlpha  = sum * r0_2;
-			rightAlpha = sum * r1_2;
-			upperAlpha = sum * r2_2;
-		}
-	};
-	struct Section {
-		std::array<TFloat, SectionDelay + 1> top{};
-		std::array<TFloat, SectionDelay + 1> bottom{};
-		void reset() {
-			top.fill(0.0);
-			bottom.fill(0.0);
-		}
-		static void movePointers(unsigned int& in, unsigned int& out) {
-			in = out;
-			if (out == SectionDelay) {
-				out = 0;
-			} else {
-				++out;
-			}
-		}
+	struct DraftTopology {
+		enum {
+			TOTAL_SECTIONS        = 10,
+			TOTAL_JUNCTIONS       = VocalTractModel4::TOTAL_JUNCTIONS,
+			TOTAL_NASAL_SECTIONS  = 6,
+			TOTAL_NASAL_JUNCTIONS = VocalTractModel4::TOTAL_NASAL_JUNCTIONS
+		};
+		static constexpr std::array<TubeBoundary, TOTAL_SECTIONS - 1> oropharynxBoundaries = {{
+			TubeBoundary::junction(J1),       // S1-S2
+			TubeBoundary::junction(J2, FC1),  // S2-S3
+			TubeBoundary::junction(J3, FC2),  // S3-S4
+			TubeBoundary::velumJunction(FC3), // S4-S5
+			TubeBoundary::junction(J4, FC4),  // S5-S6
+			TubeBoundary::delay(FC5),         // S6-S7
+			TubeBoundary::junction(J5, FC6),  // S7-S8
+			TubeBoundary::junction(J6, FC7),  // S8-S9
+			TubeBoundary::junction(J7, FC8)   // S9-S10
+		}};
+		static constexpr std::array<TubeBoundary, TOTAL_NASAL_SECTIONS - 1> nasalBoundaries = {{
+			TubeBoundary::junction(NJ1),      // N1-N2
+			TubeBoundary::junction(NJ2),      // N2-N3
+			TubeBoundary::junction(NJ3),      // N3-N4
+			TubeBoundary::junction(NJ4),      // N4-N5
+			TubeBoundary::junction(NJ5)       // N5-N6
+		}};
 	};
-
-	void propagate(Section& left, Section& right) {
-		// Simple copy.
-		right.top[  inPtr_] = left.top[    outPtr_];
-		left.bottom[inPtr_] = right.bottom[outPtr_];
-	}
-	void propagate(Section& left, Section& right, TFloat fricNoise) {
-		// With frication and damping.
-		right.top[  inPtr_] = left.top[    outPtr_] * dampingFactor_ + fricNoise;
-		left.bottom[inPtr_] = right.bottom[outPtr_] * dampingFactor_;
-	}
-	void propagateJunction(Section& left, Junction2& junction, Section& right, TFloat fricNoise = 0.0) {
-		// With frication and damping.
-		const TFloat delta = junction.coeff * (left.top[outPtr_] - right.bottom[outPtr_]);
-		right.top[  inPtr_] = (left.top[    outPtr_] + delta) * dampingFactor_ + fricNoise;
-		left.bottom[inPtr_] = (right.bottom[outPtr_] + delta) * dampingFactor_;
-	}
-	void propagateJunction(Section& left, Junction3& junction, Section& right, Section& upper, TFloat fricNoise) {
-		// With frication and damping.
-		const TFloat junctionPressure =
-				junction.leftAlpha  *  left.top[   outPtr_] +
-				junction.rightAlpha * right.bottom[outPtr_] +
-				junction.upperAlpha * upper.bottom[outPtr_];
-		left.bottom[inPtr_] = (junctionPressure -  left.top[   outPtr_]) * dampingFactor_;
-		right.top[  inPtr_] = (junctionPressure - right.bottom[outPtr_]) * dampingFactor_ + fricNoise;
-		upper.top[  inPtr_] = (junctionPressure - upper.bottom[outPtr_]) * dampingFactor_;
-	}
+	using Topology = std::conditional_t<Draft, DraftTopology, FullTopology>;
 
 	VocalTractModel4(const VocalTractModel4&) = delete;
 	VocalTractModel4& operator=(const VocalTractModel4&) = delete;
@@ -327,10 +372,12 @@ private:
 
 	void loadConfiguration(const ConfigurationData& data);
 	void initializeSynthesizer();
+	void initializeSampleRate();
 	void calculateTubeCoefficients();
 	void initializeNasalCavity();
 	void setFricationTaps();
 	TFloat vocalTract(TFloat input, TFloat frication);
+	TFloat nextLowpassNoise();
 
 	bool interactive_;
 	Configuration config_;
@@ -339,13 +386,7 @@ private:
 	int sampleRate_;
 
 	/*  MEMORY FOR TUBE AND TUBE COEFFICIENTS  */
-	std::array<Section, TOTAL_SECTIONS> oropharynx_;
-	Junction2 oropharynxJunction_[TOTAL_JUNCTIONS];
-	std::array<Section, TOTAL_NASAL_SECTIONS> nasal_;
-	Junction2 nasalJunction_[TOTAL_NASAL_JUNCTIONS];
-	Junction3 velumJunction_;
-	unsigned int inPtr_;
-	unsigned int outPtr_;
+	Tube<TFloat, SectionDelay, Topology, TubePressureJunctions> tube_;
 
 	/*  MEMORY FOR FRICATION TAPS  */
 	std::array<TFloat, TOTAL_FRIC_COEFFICIENTS> fricationTap_;
@@ -366,12 +407,15 @@ private:
 	std::unique_ptr<BandpassFilter<TFloat>>          bandpassFilter_;
 	std::unique_ptr<NoiseFilter<TFloat>>             noiseFilter_;
 	std::unique_ptr<NoiseSource>                     noiseSource_;
+	std::array<TFloat, NOISE_BLOCK_SIZE>             noiseBlock_;
+	std::size_t                                      noiseBlockIndex_;
+	SilenceDetector<TFloat>                          silenceDetector_;
 };
 
 
 
-template<typename TFloat, unsigned int SectionDelay>
-VocalTractModel4<TFloat, SectionDelay>::VocalTractModel4(const ConfigurationData& data, bool interactive)
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+VocalTractModel4<TFloat, SectionDelay, Draft>::VocalTractModel4(const ConfigurationData& data, bool interactive)
 		: interactive_(interactive)
 {
 	loadConfiguration(data);
@@ -380,15 +424,16 @@ VocalTractModel4<TFloat, SectionDelay>::VocalTractModel4(const ConfigurationData
 	outputBuffer_.reserve(OUTPUT_BUFFER_RESERVE);
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::loadConfiguration(const ConfigurationData& data)
+VocalTractModel4<TFloat, SectionDelay, Draft>::loadConfiguration(const ConfigurationData& data)
 {
 	config_.outputRate     = data.value<TFloat>("output_rate");
 	config_.waveform       = data.value<int>("waveform");
 	config_.tp             = data.value<TFloat>("glottal_pulse_tp");
 	config_.tnMin          = data.value<TFloat>("glottal_pulse_tn_min");
 	config_.tnMax          = data.value<TFloat>("glottal_pulse_tn_max");
+	config_.tableBankSize  = data.value<int>("glottal_pulse_table_bank_size", 0, 1024);
 	config_.breathiness    = data.value<TFloat>("breathiness");
 	config_.length         = data.value<TFloat>("vocal_tract_length_offset") + data.value<TFloat>("vocal_tract_length");
 	if (config_.length < MIN_VOCAL_TRACT_LENGTH) {
@@ -403,6 +448,7 @@ VocalTractModel4<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	config_.throatCutoff   = data.value<TFloat>("throat_cutoff");
 	config_.throatVol      = data.value<TFloat>("throat_volume");
 	config_.modulation     = data.value<int>("noise_modulation");
+	config_.noiseGenerator = data.value<int>("noise_generator");
 	config_.mixOffset      = data.value<TFloat>("mix_offset");
 	const TFloat globalRadiusCoef      = data.value<TFloat>("global_radius_coef");
 	const TFloat globalNasalRadiusCoef = data.value<TFloat>("global_nasal_radius_coef");
@@ -423,18 +469,11 @@ VocalTractModel4<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	config_.radiusCoef[7]  = data.value<TFloat>("radius_8_coef") * globalRadiusCoef;
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::reset() noexcept
+VocalTractModel4<TFloat, SectionDelay, Draft>::reset() noexcept
 {
-	for (auto& elem : oropharynx_) {
-		elem.reset();
-	}
-	for (auto& elem : nasal_) {
-		elem.reset();
-	}
-	inPtr_  = 0;
-	outPtr_ = 1;
+	tube_.reset();
 	outputBuffer_.clear();
 	if (srConv_)                srConv_->reset();
 	if (mouthRadiationFilter_)  mouthRadiationFilter_->reset();
@@ -446,6 +485,8 @@ VocalTractModel4<TFloat, SectionDelay>::reset() noexcept
 	if (bandpassFilter_)        bandpassFilter_->reset();
 	if (noiseFilter_)           noiseFilter_->reset();
 	if (noiseSource_)           noiseSource_->reset();
+	noiseBlockIndex_ = NOISE_BLOCK_SIZE;
+	silenceDetector_.reset();
 }
 
 /******************************************************************************
@@ -456,17 +497,11 @@ VocalTractModel4<TFloat, SectionDelay>::reset() noexcept
 *             be run.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::initializeSynthesizer()
+VocalTractModel4<TFloat, SectionDelay, Draft>::initializeSynthesizer()
 {
-	TFloat nyquist;
-
-	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
-	const TFloat c = Util::speedOfSound(config_.temperature);
-	sampleRate_ = static_cast<int>((c * (TOTAL_SECTIONS * SectionDelay) * 100.0f) / config_.length);
-	nyquist = sampleRate_ / 2.0f;
-	if (!interactive_) LOG_DEBUG("[VocalTractModel4] Internal sample rate: " << sampleRate_);
+	initializeSampleRate();
 
 	/*  CALCULATE THE BREATHINESS FACTOR  */
 	breathinessFactor_ = config_.breathiness / 100.0f;
@@ -483,7 +518,45 @@ VocalTractModel4<TFloat, SectionDelay>::initializeSynthesizer()
 							WavetableGlottalSource<TFloat>::Type::pulse :
 							WavetableGlottalSource<TFloat>::Type::sine,
 						sampleRate_,
-						config_.tp, config_.tnMin, config_.tnMax);
+						config_.tp, config_.tnMin, config_.tnMax,
+						config_.tableBankSize);
+
+	/*  INITIALIZE NASAL CAVITY FIXED SCATTERING COEFFICIENTS  */
+	initializeNasalCavity();
+
+	/*  INITIALIZE THE SAMPLE RATE CONVERSION ROUTINES  */
+	srConv_ = std::make_unique<SampleRateConverter<TFloat>>(
+					sampleRate_,
+					config_.outputRate,
+					[&](float sample) {
+						outputBuffer_.push_back(sample);
+					});
+
+	bandpassFilter_ = std::make_unique<BandpassFilter<TFloat>>();
+	noiseFilter_    = std::make_unique<NoiseFilter<TFloat>>();
+	noiseSource_    = std::make_unique<NoiseSource>(config_.noiseGenerator);
+}
+
+/******************************************************************************
+*
+*  function:  initializeSampleRate
+*
+*  purpose:   Calculates the sample rate, and creates the filters
+*             whose coefficients depend on it.
+*
+******************************************************************************/
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel4<TFloat, SectionDelay, Draft>::initializeSampleRate()
+{
+	TFloat nyquist;
+
+	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
+	const TFloat c = Util::speedOfSound(config_.temperature);
+	sampleRate_ = static_cast<int>((c * (Topology::TOTAL_SECTIONS * SectionDelay) * 100.0f) / config_.length);
+	silenceDetector_.setSampleRate(sampleRate_);
+	nyquist = sampleRate_ / 2.0f;
+	if (!interactive_) LOG_DEBUG("[VocalTractModel4] Internal sample rate: " << sampleRate_);
 
 	/*  INITIALIZE REFLECTION AND RADIATION FILTER COEFFICIENTS FOR MOUTH  */
 	TFloat mouthApertureCoeff = (nyquist - config_.mouthCoef) / nyquist;
@@ -495,40 +568,66 @@ VocalTractModel4<TFloat, SectionDelay>::initializeSynthesizer()
 	nasalRadiationFilter_  = std::make_unique<RadiationFilter<TFloat>>(nasalApertureCoeff);
 	nasalReflectionFilter_ = std::make_unique<ReflectionFilter<TFloat>>(nasalApertureCoeff);
 
-	/*  INITIALIZE NASAL CAVITY FIXED SCATTERING COEFFICIENTS  */
-	initializeNasalCavity();
-
 	/*  INITIALIZE THE THROAT LOWPASS FILTER  */
 	throat_ = std::make_unique<Throat<TFloat>>(sampleRate_, config_.throatCutoff, Util::amplitude60dB(config_.throatVol));
+}
 
-	/*  INITIALIZE THE SAMPLE RATE CONVERSION ROUTINES  */
-	srConv_ = std::make_unique<SampleRateConverter<TFloat>>(
-					sampleRate_,
-					config_.outputRate,
-					[&](float sample) {
-						outputBuffer_.push_back(sample);
-					});
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel4<TFloat, SectionDelay, Draft>::setTubeLengthAndTemperature(double length, double temperature)
+{
+	config_.length      = std::clamp(static_cast<TFloat>(length), MIN_VOCAL_TRACT_LENGTH, MAX_VOCAL_TRACT_LENGTH);
+	config_.temperature = temperature;
+
+	const int prevSampleRate = sampleRate_;
+	initializeSampleRate();
+	if (sampleRate_ != prevSampleRate) {
+		glottalSource_->setSampleRate(sampleRate_);
+		srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	}
+	reset();
+}
 
-	bandpassFilter_ = std::make_unique<BandpassFilter<TFloat>>();
-	noiseFilter_    = std::make_unique<NoiseFilter<TFloat>>();
-	noiseSource_    = std::make_unique<NoiseSource>();
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel4<TFloat, SectionDelay, Draft>::setOutputSampleRate(double outputRate)
+{
+	config_.outputRate = outputRate;
+	srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	reset();
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::execSynthesisStep() noexcept
+VocalTractModel4<TFloat, SectionDelay, Draft>::execSynthesisStep() noexcept
 {
 	/*  CONVERT PARAMETERS HERE  */
 	TFloat f0 = Util::frequency(currentParameter_[PARAM_GLOT_PITCH]);
 	TFloat ax = Util::amplitude60dB(currentParameter_[PARAM_GLOT_VOL]);
 	TFloat ah1 = Util::amplitude60dB(currentParameter_[PARAM_ASP_VOL]);
+
+	const bool inputsSilent = ax == 0.0f && ah1 == 0.0f &&
+					Util::amplitude60dB(currentParameter_[PARAM_FRIC_VOL]) == 0.0f;
+
+	/*  SKIP THE TRACT WHILE SILENT, BUT KEEP THE SOURCES RUNNING  */
+	if (silenceDetector_.silent(inputsSilent)) {
+		bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
+		bandpassFilter_->filter(nextLowpassNoise());
+		if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
+			glottalSource_->setup(ax);
+		}
+		glottalSource_->getSample(f0);
+		srConv_->dataFill(0.0);
+		return;
+	}
+
 	calculateTubeCoefficients();
 	setFricationTaps();
 	bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
 
 	/*  DO SYNTHESIS HERE  */
 	/*  CREATE LOW-PASS FILTERED NOISE  */
-	TFloat lpNoise = noiseFilter_->filter(noiseSource_->getSample());
+	TFloat lpNoise = nextLowpassNoise();
 
 	/*  UPDATE THE SHAPE OF THE GLOTTAL PULSE, IF NECESSARY  */
 	if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
@@ -564,6 +663,7 @@ VocalTractModel4<TFloat, SectionDelay>::execSynthesisStep() noexcept
 	signal += throat_->process(pulse * TFloat{GS_VTM4_VT_SCALE});
 
 	/*  OUTPUT SAMPLE HERE  */
+	if (inputsSilent) silenceDetector_.update(tube_.level());
 	srConv_->dataFill(signal);
 }
 
@@ -575,17 +675,17 @@ VocalTractModel4<TFloat, SectionDelay>::execSynthesisStep() noexcept
 *             sections of the nasal cavity.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::initializeNasalCavity()
+VocalTractModel4<TFloat, SectionDelay, Draft>::initializeNasalCavity()
 {
 	// Configure junctions for fixed nasal sections.
 	for (int i = NJ2, j = NR2; i < NJ6; ++i, ++j) {
-		nasalJunction_[i].configure(config_.nasalRadius[j], config_.nasalRadius[j + 1]);
+		tube_.nasalJunction(i).configure(config_.nasalRadius[j], config_.nasalRadius[j + 1]);
 	}
 
 	// Configure junction for the nose aperture.
-	nasalJunction_[NJ6].configure(config_.nasalRadius[NR6], config_.apertureRadius);
+	tube_.nasalJunction(NJ6).configure(config_.nasalRadius[NR6], config_.apertureRadius);
 }
 
 /******************************************************************************
@@ -598,24 +698,24 @@ VocalTractModel4<TFloat, SectionDelay>::initializeNasalCavity()
 *             pair for the mouth and nose.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::calculateTubeCoefficients()
+VocalTractModel4<TFloat, SectionDelay, Draft>::calculateTubeCoefficients()
 {
 	// Configure oropharynx junctions.
 	for (int i = J1, j = PARAM_R1; i < J8; ++i, ++j) {
-		oropharynxJunction_[i].configure(currentParameter_[j], currentParameter_[j + 1]);
+		tube_.oropharynxJunction(i).configure(currentParameter_[j], currentParameter_[j + 1]);
 	}
 
 	// Configure junction for the mouth aperture.
-	oropharynxJunction_[J8].configure(currentParameter_[PARAM_R8], config_.apertureRadius);
+	tube_.oropharynxJunction(J8).configure(currentParameter_[PARAM_R8], config_.apertureRadius);
 
 	// Configure 3-way junction.
 	// Note: Since junction is in middle of region 4, leftRadius = rightRadius.
-	velumJunction_.configure(currentParameter_[PARAM_R4], currentParameter_[PARAM_R4], currentParameter_[PARAM_VELUM]);
+	tube_.velumJunction().configure(currentParameter_[PARAM_R4], currentParameter_[PARAM_R4], currentParameter_[PARAM_VELUM]);
 
 	// Configure 1st nasal junction.
-	nasalJunction_[NJ1].configure(currentParameter_[PARAM_VELUM], config_.nasalRadius[NR2]);
+	tube_.nasalJunction(NJ1).configure(currentParameter_[PARAM_VELUM], config_.nasalRadius[NR2]);
 }
 
 /******************************************************************************
@@ -626,9 +726,9 @@ VocalTractModel4<TFloat, SectionDelay>::calculateTubeCoefficients()
 *             position and amplitude of frication.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::setFricationTaps()
+VocalTractModel4<TFloat, SectionDelay, Draft>::setFricationTaps()
 {
 	const TFloat fricationAmplitude = Util::amplitude60dB(currentParameter_[PARAM_FRIC_VOL]);
 
@@ -667,85 +767,54 @@ VocalTractModel4<TFloat, SectionDelay>::setFricationTaps()
 *             cavities.  Also injects frication appropriately.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 TFloat
-VocalTractModel4<TFloat, SectionDelay>::vocalTract(TFloat input, TFloat frication)
+VocalTractModel4<TFloat, SectionDelay, Draft>::vocalTract(TFloat input, TFloat frication)
 {
-	Section::movePointers(inPtr_, outPtr_);
+	tube_.movePointers();
 
 	// Input to the tube.
-	oropharynx_[S1].top[inPtr_] = oropharynx_[S1].bottom[outPtr_] * dampingFactor_ + input;
-
-	propagate(oropharynx_[S1], oropharynx_[S2]);
-	propagate(oropharynx_[S2], oropharynx_[S3]);
-	propagateJunction(oropharynx_[S3], oropharynxJunction_[J1], oropharynx_[S4]);
-	propagate(oropharynx_[S4], oropharynx_[S5]);
-	propagateJunction(oropharynx_[S5], oropharynxJunction_[J2], oropharynx_[S6], fricationTap_[FC1] * frication);
-	propagate(oropharynx_[S6], oropharynx_[S7]);
-	propagate(oropharynx_[S7], oropharynx_[S8]);
-	propagate(oropharynx_[S8], oropharynx_[S9]);
-	propagateJunction(oropharynx_[S9], oropharynxJunction_[J3], oropharynx_[S10], fricationTap_[FC2] * frication);
-	propagate(oropharynx_[S10], oropharynx_[S11]);
-	propagate(oropharynx_[S11], oropharynx_[S12]);
-
-	// 3-way junction between the middle of R4 and the nasal cavity.
-	propagateJunction(oropharynx_[S12], velumJunction_, oropharynx_[S13], nasal_[VELUM], fricationTap_[FC3] * frication);
-
-	propagate(oropharynx_[S13], oropharynx_[S14]);
-	propagate(oropharynx_[S14], oropharynx_[S15]);
-	propagateJunction(oropharynx_[S15], oropharynxJunction_[J4], oropharynx_[S16], fricationTap_[FC4] * frication);
-	propagate(oropharynx_[S16], oropharynx_[S17]);
-	propagate(oropharynx_[S17], oropharynx_[S18]);
-	propagate(oropharynx_[S18], oropharynx_[S19], fricationTap_[FC5] * frication);
-	propagate(oropharynx_[S19], oropharynx_[S20]);
-	propagate(oropharynx_[S20], oropharynx_[S21]);
-	propagateJunction(oropharynx_[S21], oropharynxJunction_[J5], oropharynx_[S22] , fricationTap_[FC6] * frication);
-	propagate(oropharynx_[S22], oropharynx_[S23]);
-	propagate(oropharynx_[S23], oropharynx_[S24]);
-	propagate(oropharynx_[S24], oropharynx_[S25]);
-	propagateJunction(oropharynx_[S25], oropharynxJunction_[J6], oropharynx_[S26] , fricationTap_[FC7] * frication);
-	propagate(oropharynx_[S26], oropharynx_[S27]);
-	propagateJunction(oropharynx_[S27], oropharynxJunction_[J7], oropharynx_[S28] , fricationTap_[FC8] * frication);
-	propagate(oropharynx_[S28], oropharynx_[S29]);
-	propagate(oropharynx_[S29], oropharynx_[S30]);
+	tube_.setInput(input, dampingFactor_);
 
-	// Reflected signal at the mouth goes through a lowpass filter.
-	oropharynx_[S30].bottom[inPtr_] = dampingFactor_ * mouthReflectionFilter_->filter(oropharynxJunction_[J8].coeff * oropharynx_[S30].top[outPtr_]);
+	tube_.propagateOropharynx(dampingFactor_, fricationTap_.data(), frication);
 
+	// Reflected signal at the mouth goes through a lowpass filter.
 	// Output from mouth goes through a highpass filter.
-	TFloat output = mouthRadiationFilter_->filter((1.0f + oropharynxJunction_[J8].coeff) * oropharynx_[S30].top[outPtr_]);
-
-	propagate(nasal_[N1], nasal_[N2]);
-	propagate(nasal_[N2], nasal_[N3]);
-	propagateJunction(nasal_[N3], nasalJunction_[NJ1], nasal_[N4]);
-	propagate(nasal_[N4], nasal_[N5]);
-	propagate(nasal_[N5], nasal_[N6]);
-	propagateJunction(nasal_[N6], nasalJunction_[NJ2], nasal_[N7]);
-	propagate(nasal_[N7], nasal_[N8]);
-	propagate(nasal_[N8], nasal_[N9]);
-	propagateJunction(nasal_[N9], nasalJunction_[NJ3], nasal_[N10]);
-	propagate(nasal_[N10], nasal_[N11]);
-	propagate(nasal_[N11], nasal_[N12]);
-	propagateJunction(nasal_[N12], nasalJunction_[NJ4], nasal_[N13]);
-	propagate(nasal_[N13], nasal_[N14]);
-	propagate(nasal_[N14], nasal_[N15]);
-	propagateJunction(nasal_[N15], nasalJunction_[NJ5], nasal_[N16]);
-	propagate(nasal_[N16], nasal_[N17]);
-	propagate(nasal_[N17], nasal_[N18]);
+	TFloat output = tube_.radiateFromMouth(dampingFactor_, *mouthReflectionFilter_, *mouthRadiationFilter_);
 
-	// Reflected signal at the nose goes through a lowpass filter.
-	nasal_[N18].bottom[inPtr_] = dampingFactor_ * nasalReflectionFilter_->filter(nasalJunction_[NJ6].coeff * nasal_[N18].top[outPtr_]);
+	tube_.propagateNasal(dampingFactor_);
 
+	// Reflected signal at the nose goes through a lowpass filter.
 	// Output from nose goes through a highpass filter.
-	output += nasalRadiationFilter_->filter((1.0f + nasalJunction_[NJ6].coeff) * nasal_[N18].top[outPtr_]);
+	output += tube_.radiateFromNose(dampingFactor_, *nasalReflectionFilter_, *nasalRadiationFilter_);
 
 	// Return summed output from mouth and nose.
 	return output;
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+/******************************************************************************
+*
+*  function:  nextLowpassNoise
+*
+*  purpose:   Returns the next sample of lowpass filtered noise.
+*             The noise is generated and filtered in blocks.
+*
+******************************************************************************/
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+TFloat
+VocalTractModel4<TFloat, SectionDelay, Draft>::nextLowpassNoise()
+{
+	if (noiseBlockIndex_ == NOISE_BLOCK_SIZE) {
+		noiseSource_->getBlock(noiseBlock_.data(), NOISE_BLOCK_SIZE);
+		noiseFilter_->filter(noiseBlock_.data(), noiseBlock_.data(), NOISE_BLOCK_SIZE);
+		noiseBlockIndex_ = 0;
+	}
+	return noiseBlock_[noiseBlockIndex_++];
+}
+
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::setParameter(int parameter, float value) noexcept
+VocalTractModel4<TFloat, SectionDelay, Draft>::setParameter(int parameter, float value) noexcept
 {
 	switch (parameter) {
 	case PARAM_GLOT_PITCH:
@@ -776,11 +845,11 @@ VocalTractModel4<TFloat, SectionDelay>::setParameter(int parameter, float value)
 	}
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::setAllParameters(const std::vector<float>& parameters) noexcept
+VocalTractModel4<TFloat, SectionDelay, Draft>::setAllParameters(const float* parameters, std::size_t numParameters) noexcept
 {
-	if (parameters.size() != TOTAL_PARAMETERS) {
+	if (numParameters != TOTAL_PARAMETERS) {
 		// Wrong number of parameters.
 		return; // fail silently
 	}
@@ -798,13 +867,81 @@ VocalTractModel4<TFloat, SectionDelay>::setAllParameters(const std::vector<float
 	currentParameter_[PARAM_VELUM] = parameters[PARAM_VELUM];
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel4<TFloat, SectionDelay>::finishSynthesis() noexcept
+VocalTractModel4<TFloat, SectionDelay, Draft>::finishSynthesis() noexcept
 {
 	srConv_->flushBuffer();
 }
 
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel4<TFloat, SectionDelay, Draft>::saveState(std::vector<unsigned char>& state) const
+{
+	state.clear();
+	DSPStateWriter w(state);
+	w.writeTag("VocalTractModel4");
+	w.write(static_cast<unsigned int>(sizeof(TFloat)));
+	w.write(SectionDelay);
+	w.write(Draft);
+	w.write(sampleRate_);
+
+	w.write(currentParameter_);
+	w.write(fricationTap_);
+	w.writeVector(outputBuffer_);
+	tube_.saveState(w);
+	srConv_->saveState(w);
+	mouthRadiationFilter_->saveState(w);
+	mouthReflectionFilter_->saveState(w);
+	nasalRadiationFilter_->saveState(w);
+	nasalReflectionFilter_->saveState(w);
+	throat_->saveState(w);
+	glottalSource_->saveState(w);
+	bandpassFilter_->saveState(w);
+	noiseFilter_->saveState(w);
+	noiseSource_->saveState(w);
+	w.write(noiseBlock_);
+	w.write(noiseBlockIndex_);
+	silenceDetector_.saveState(w);
+}
+
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel4<TFloat, SectionDelay, Draft>::loadState(const std::vector<unsigned char>& state)
+{
+	DSPStateReader r(state);
+	r.readTag("VocalTractModel4");
+	r.expect(static_cast<unsigned int>(sizeof(TFloat)), "floating-point type");
+	r.expect(SectionDelay, "section delay");
+	r.expect(Draft, "tube resolution");
+	r.expect(sampleRate_, "sample rate");
+
+	r.read(currentParameter_);
+	r.read(fricationTap_);
+	r.readVector(outputBuffer_, true);
+	tube_.loadState(r);
+	srConv_->loadState(r);
+	mouthRadiationFilter_->loadState(r);
+	mouthReflectionFilter_->loadState(r);
+	nasalRadiationFilter_->loadState(r);
+	nasalReflectionFilter_->loadState(r);
+	throat_->loadState(r);
+	glottalSource_->loadState(r);
+	bandpassFilter_->loadState(r);
+	noiseFilter_->loadState(r);
+	noiseSource_->loadState(r);
+	r.read(noiseBlock_);
+	r.read(noiseBlockIndex_);
+	silenceDetector_.loadState(r);
+
+	if (noiseBlockIndex_ > NOISE_BLOCK_SIZE) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel4] Invalid noise block index in state: " << noiseBlockIndex_ << '.');
+	}
+	if (!r.atEnd()) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel4] Unexpected data at the end of the state.");
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
@@ -31,15 +31,44 @@
 //           R1        | R2    | R3            | R4        | R4        | R5        | R5        | R6            | R7    | R8        |
 //                     J1      J2              J3          |           J4          |           J5              J6      J7          J8
 //                             FRIC 0.0                                                                                FRIC 7.0
+//
+// Draft mode (Draft = true):
+//
+//                              NJ1 NJ2 NJ3 NJ4 NJ5 NJ6 NJ7
+//                               |   |   |   |   |   |   |
+//                         nasal -------------------------
+//                            ___|N1 |N2 |N3 |N4 |N5 |N6 |N7 | nose
+//                           |   -------------------------
+//         oropharynx        |
+//         -----------------------------------------
+// vocal   |S1 |S2 |S3 |S4 |S5 |S6 |S7 |S8 |S9 |S10| mouth
+// folds   -----------------------------------------
+//             |   |   |   |   |   |   |   |   |   |
+//           R1| R2| R3| R4| R4| R5| R5| R6| R7| R8|
+//             J1  J2  J3  |   J4  |   J5  J6  J7  J8
+//                 FRIC 0.0                FRIC 7.0
+//
+// The radii are applied to a tube with one third of the sections, like in the
+// models 0 and 2, and the internal sample rate is divided by 3.
+// Quality trade-off:
+// - The bandwidth of the tube is reduced to about 1/3 (10 kHz for a tube
+//   length of 17.5 cm).
+// - The relative lengths of the regions are rounded to whole sections, so the
+//   formant frequencies are a bit different.
+// - The frication position has 7 steps instead of 22.
+// - The transition frequency of the radiation impedance is limited (see
+//   PoleZeroRadiationImpedance.h).
 
 #ifndef VTM_VOCAL_TRACT_MODEL_5_H_
 #define VTM_VOCAL_TRACT_MODEL_5_H_
 
-#include <algorithm> /* max */
+#include <algorithm> /* clamp, max */
 #include <array>
 #include <cmath> /* sqrt */
 #include <cstddef> /* std::size_t */
 #include <memory>
+#include <string>
+#include <type_traits> /* conditional_t */
 #include <vector>
 
 #include "BandpassFilter.h"
@@ -47,12 +76,16 @@
 #include "Butterworth2LowpassFilter.h"
 #include "ConfigurationData.h"
 #include "DifferenceFilter.h"
+#include "DSPState.h"
+#include "Exception.h"
 #include "Log.h"
 #include "NoiseSource.h"
 #include "ParameterLogger.h"
 #include "PoleZeroRadiationImpedance.h"
 #include "RosenbergBGlottalSource.h"
 #include "SampleRateConverter.h"
+#include "SilenceDetector.h"
+#include "Tube.h"
 #include "VocalTractModel.h"
 #include "VTMUtil.h"
 
@@ -65,7 +98,7 @@
 namespace GS {
 namespace VTM {
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft = false>
 class VocalTractModel5 : public VocalTractModel {
 public:
 	explicit VocalTractModel5(const ConfigurationData& data, bool interactive=false);
@@ -77,16 +110,24 @@ public:
 	virtual double outputSampleRate() const noexcept { return config_.outputRate; }
 
 	virtual void setParameter(int parameter, float value) noexcept;
-	virtual void setAllParameters(const std::vector<float>& parameters) noexcept;
+	virtual void setAllParameters(const float* parameters, std::size_t numParameters) noexcept;
+	using VocalTractModel::setAllParameters;
 
 	virtual void execSynthesisStep() noexcept;
 	virtual void finishSynthesis() noexcept;
 
 	virtual std::vector<float>& outputBuffer() noexcept { return outputBuffer_; }
 
+	virtual void saveState(std::vector<unsigned char>& state) const;
+	virtual void loadState(const std::vector<unsigned char>& state);
+
+	virtual void setTubeLengthAndTemperature(double length, double temperature);
+	virtual void setOutputSampleRate(double outputRate);
+
 private:
 	static constexpr TFloat MIN_VOCAL_TRACT_LENGTH = 3.0;
 	static constexpr TFloat MAX_VOCAL_TRACT_LENGTH = 30.0;
+	static constexpr std::size_t NOISE_BLOCK_SIZE = 64;
 
 	enum { /*  OROPHARYNX REGIONS  */
 		R1 = 0, /*  S1  - S3   */
@@ -221,8 +262,10 @@ private:
 		PARAM_VELUM      = 15,
 		TOTAL_PARAMETERS = 16
 	};
-	enum LogParameters {
-		log_param_vtm5_pitch
+	enum LogParameter {
+		LOG_PARAM_PITCH      = 0,
+		LOG_PARAM_OUTPUT     = 1,
+		TOTAL_LOG_PARAMETERS = 2
 	};
 
 	struct Configuration {
@@ -238,8 +281,11 @@ private:
 		// Set nasalRadius[N1] to 0.0, because it is not used.
 		std::array<TFloat, TOTAL_NASAL_SECTIONS> nasalRadius; // fixed nasal radii (0 - 3 cm)
 		int    modulation;                  // pulse mod. of noise (0=OFF, 1=ON)
+		int    noiseGenerator;              // NoiseSource::Generator
 		TFloat mixOffset;                   // noise crossmix offset (30 - 60 dB)
 		std::array<TFloat, TOTAL_REGIONS> radiusCoef;
+		std::string logFile;                // binary parameter log file
+		int    logDecimation;               // log one of each N samples
 		TFloat glottalNoiseCutoff;          // glottal noise lowpass cutoff frequency (Hz)
 		TFloat fricationNoiseCutoff;        // frication noise lowpass cutoff frequency (Hz)
 		TFloat fricationFactor;
@@ -248,63 +294,101 @@ private:
 		TFloat glottalLowpassCutoff;        // glottal wave lowpass cutoff frequency (Hz)
 		int    bypass;
 	};
-	struct Junction2 {
-		TFloat coeff{};
-		void configure(TFloat leftRadius, TFloat rightRadius) {
-			const TFloat r0_2 =  leftRadius *  leftRadius;
-			const TFloat r1_2 = rightRadius * rightRadius;
-			coeff = (r0_2 - r1_2) / (r0_2 + r1_2);
-		}
-	};
-	struct Junction3 {
-		TFloat leftCoeff{};
-		TFloat rightCoeff{};
-		TFloat upperCoeff{};
-		void configure(TFloat leftRadius, TFloat rightRadius, TFloat upperRadius) {
-			// Flow equations.
-			const TFloat r0_2 =  leftRadius *  leftRadius;
-			const TFloat r1_2 = rightRadius * rightRadius;
-			const TFloat r2_2 = upperRadius * upperRadius;
-			const TFloat c = 1.0f / (r0_2 + r1_2 + r2_2);
-			leftCoeff  = c * (r0_2 - r1_2 - r2_2);
-			rightCoeff = c * (r1_2 - r0_2 - r2_2);
-			upperCoeff = c * (r2_2 - r0_2 - r1_2);
-		}
+
+	struct FullTopology {
+		enum {
+			TOTAL_SECTIONS        = VocalTractModel5::TOTAL_SECTIONS,
+			TOTAL_JUNCTIONS       = VocalTractModel5::TOTAL_JUNCTIONS,
+			TOTAL_NASAL_SECTIONS  = VocalTractModel5::TOTAL_NASAL_SECTIONS,
+			TOTAL_NASAL_JUNCTIONS = VocalTractModel5::TOTAL_NASAL_JUNCTIONS,
+			FIRST_FRIC_SECTION    = S6,
+			LAST_FRIC_SECTION     = S28
+		};
+		// Frication is injected by the model after the propagation.
+		static constexpr std::array<TubeBoundary, TOTAL_SECTIONS - 1> oropharynxBoundaries = {{
+			TubeBoundary::delay(),          // S1-S2
+			TubeBoundary::delay(),          // S2-S3
+			TubeBoundary::junction(J1),     // S3-S4
+			TubeBoundary::delay(),          // S4-S5
+			TubeBoundary::junction(J2),     // S5-S6
+			TubeBoundary::delay(),          // S6-S7
+			TubeBoundary::delay(),          // S7-S8
+			TubeBoundary::delay(),          // S8-S9
+			TubeBoundary::junction(J3),     // S9-S10
+			TubeBoundary::delay(),          // S10-S11
+			TubeBoundary::delay(),          // S11-S12
+			TubeBoundary::velumJunction(),  // S12-S13
+			TubeBoundary::delay(),          // S13-S14
+			TubeBoundary::delay(),          // S14-S15
+			TubeBoundary::junction(J4),     // S15-S16
+			TubeBoundary::delay(),          // S16-S17
+			TubeBoundary::delay(),          // S17-S18
+			TubeBoundary::delay(),          // S18-S19
+			TubeBoundary::delay(),          // S19-S20
+			TubeBoundary::delay(),          // S20-S21
+			TubeBoundary::junction(J5),     // S21-S22
+			TubeBoundary::delay(),          // S22-S23
+			TubeBoundary::delay(),          // S23-S24
+			TubeBoundary::delay(),          // S24-S25
+			TubeBoundary::junction(J6),     // S25-S26
+			TubeBoundary::delay(),          // S26-S27
+			TubeBoundary::junction(J7),     // S27-S28
+			TubeBoundary::delay(),          // S28-S29
+			TubeBoundary::delay()           // S29-S30
+		}};
+		static constexpr std::array<TubeBoundary, TOTAL_NASAL_SECTIONS - 1> nasalBoundaries = {{
+			TubeBoundary::delay(),          // N1-N2
+			TubeBoundary::delay(),          // N2-N3
+			TubeBoundary::junction(NJ1),    // N3-N4
+			TubeBoundary::delay(),          // N4-N5
+			TubeBoundary::delay(),          // N5-N6
+			TubeBoundary::junction(NJ2),    // N6-N7
+			TubeBoundary::delay(),          // N7-N8
+			TubeBoundary::delay(),          // N8-N9
+			TubeBoundary::junction(NJ3),    // N9-N10
+			TubeBoundary::delay(),          // N10-N11
+			TubeBoundary::delay(),          // N11-N12
+			TubeBoundary::junction(NJ4),    // N12-N13
+			TubeBoundary::delay(),          // N13-N14
+			TubeBoundary::delay(),          // N14-N15
+			TubeBoundary::junction(NJ5),    // N15-N16
+			TubeBoundary::delay(),          // N16-N17
+			TubeBoundary::delay(),          // N17-N18
+			TubeBoundary::junction(NJ6),    // N18-N19
+			TubeBoundary::delay(),          // N19-N20
+			TubeBoundary::delay()           // N20-N21
+		}};
 	};
-	struct Section {
-		std::array<TFloat, SectionDelay + 1> top{};
-		std::array<TFloat, SectionDelay + 1> bottom{};
-		void reset() {
-			top.fill(0.0);
-			bottom.fill(0.0);
-		}
-		static void movePointers(unsigned int& in, unsigned int& out) {
-			in = out;
-			if (out == SectionDelay) {
-				out = 0;
-			} else {
-				++out;
-			}
-		}
+	struct DraftTopology {
+		enum {
+			TOTAL_SECTIONS        = 10,
+			TOTAL_JUNCTIONS       = VocalTractModel5::TOTAL_JUNCTIONS,
+			TOTAL_NASAL_SECTIONS  = 7,
+			TOTAL_NASAL_JUNCTIONS = VocalTractModel5::TOTAL_NASAL_JUNCTIONS,
+			FIRST_FRIC_SECTION    = 2, // S3
+			LAST_FRIC_SECTION     = 9  // S10
+		};
+		static constexpr std::array<TubeBoundary, TOTAL_SECTIONS - 1> oropharynxBoundaries = {{
+			TubeBoundary::junction(J1),     // S1-S2
+			TubeBoundary::junction(J2),     // S2-S3
+			TubeBoundary::junction(J3),     // S3-S4
+			TubeBoundary::velumJunction(),  // S4-S5
+			TubeBoundary::junction(J4),     // S5-S6
+			TubeBoundary::delay(),          // S6-S7
+			TubeBoundary::junction(J5),     // S7-S8
+			TubeBoundary::junction(J6),     // S8-S9
+			TubeBoundary::junction(J7)      // S9-S10
+		}};
+		static constexpr std::array<TubeBoundary, TOTAL_NASAL_SECTIONS - 1> nasalBoundaries = {{
+			TubeBoundary::junction(NJ1),    // N1-N2
+			TubeBoundary::junction(NJ2),    // N2-N3
+			TubeBoundary::junction(NJ3),    // N3-N4
+			TubeBoundary::junction(NJ4),    // N4-N5
+			TubeBoundary::junction(NJ5),    // N5-N6
+			TubeBoundary::junction(NJ6)     // N6-N7
+		}};
 	};
-
-	void propagate(Section& left, Section& right) {
-		right.top[  inPtr_] = left.top[    outPtr_] * dampingFactor_;
-		left.bottom[inPtr_] = right.bottom[outPtr_] * dampingFactor_;
-	}
-	void propagateJunction(Section& left, Junction2& junction, Section& right) {
-		// Flow equations.
-		const TFloat delta = junction.coeff * (left.top[outPtr_] + right.bottom[outPtr_]);
-		right.top[  inPtr_] = (left.top[    outPtr_] - delta) * dampingFactor_;
-		left.bottom[inPtr_] = (right.bottom[outPtr_] + delta) * dampingFactor_;
-	}
-	void propagateJunction(Section& left, Junction3& junction, Section& right, Section& upper) {
-		// Flow equations.
-		const TFloat partialInflux = left.top[outPtr_] + right.bottom[outPtr_] + upper.bottom[outPtr_];
-		left.bottom[inPtr_] = (right.bottom[outPtr_] + upper.bottom[outPtr_] + junction.leftCoeff  * partialInflux) * dampingFactor_;
-		right.top[  inPtr_] = ( left.top[   outPtr_] + upper.bottom[outPtr_] + junction.rightCoeff * partialInflux) * dampingFactor_;
-		upper.top[  inPtr_] = ( left.top[   outPtr_] + right.bottom[outPtr_] + junction.upperCoeff * partialInflux) * dampingFactor_;
-	}
+	using Topology = std::conditional_t<Draft, DraftTopology, FullTopology>;
 
 	VocalTractModel5(const VocalTractModel5&) = delete;
 	VocalTractModel5& operator=(const VocalTractModel5&) = delete;
@@ -313,9 +397,12 @@ private:
 
 	void loadConfiguration(const ConfigurationData& data);
 	void initializeSynthesizer();
+	void initializeSampleRate();
 	void calculateTubeCoefficients();
 	void initializeNasalCavity();
 	TFloat vocalTract(TFloat input, TFloat frication, TFloat glottalLossFactor);
+	void nextNoise(TFloat& glottalNoise, TFloat& fricationNoise);
+	void logParameters(TFloat output);
 
 	bool interactive_;
 	bool logParameters_;
@@ -325,13 +412,7 @@ private:
 	TFloat sampleRate_;
 
 	/*  MEMORY FOR TUBE AND TUBE COEFFICIENTS  */
-	std::array<Section, TOTAL_SECTIONS> oropharynx_;
-	Junction2 oropharynxJunction_[TOTAL_JUNCTIONS];
-	std::array<Section, TOTAL_NASAL_SECTIONS> nasal_;
-	Junction2 nasalJunction_[TOTAL_NASAL_JUNCTIONS];
-	Junction3 velumJunction_;
-	unsigned int inPtr_;
-	unsigned int outPtr_;
+	Tube<TFloat, SectionDelay, Topology, TubeFlowJunctions> tube_;
 
 	TFloat dampingFactor_;               /*  calculated damping factor  */
 	TFloat crossmixFactor_;              /*  calculated crossmix factor  */
@@ -347,6 +428,10 @@ private:
 	std::unique_ptr<Butterworth1LowPassFilter<TFloat>>  glottalNoiseFilter_;
 	std::unique_ptr<Butterworth2LowPassFilter<TFloat>>  fricationNoiseFilter_;
 	std::unique_ptr<NoiseSource>                        noiseSource_;
+	std::array<TFloat, NOISE_BLOCK_SIZE>                glottalNoiseBlock_;
+	std::array<TFloat, NOISE_BLOCK_SIZE>                fricationNoiseBlock_;
+	std::size_t                                         noiseBlockIndex_;
+	SilenceDetector<TFloat>                             silenceDetector_;
 	std::unique_ptr<Butterworth1LowPassFilter<TFloat>>  glottalFilter_;
 	DifferenceFilter<float>                             outputDiffFilter_;
 	ParameterLogger<TFloat>                             paramLogger_;
@@ -357,8 +442,8 @@ private:
 
 
 
-template<typename TFloat, unsigned int SectionDelay>
-VocalTractModel5<TFloat, SectionDelay>::VocalTractModel5(const ConfigurationData& data, bool interactive)
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+VocalTractModel5<TFloat, SectionDelay, Draft>::VocalTractModel5(const ConfigurationData& data, bool interactive)
 		: interactive_(interactive)
 		, logParameters_()
 		, constantRadiusMouthImpedance_()
@@ -370,9 +455,9 @@ VocalTractModel5<TFloat, SectionDelay>::VocalTractModel5(const ConfigurationData
 	outputBuffer_.reserve(OUTPUT_BUFFER_RESERVE);
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::loadConfiguration(const ConfigurationData& data)
+VocalTractModel5<TFloat, SectionDelay, Draft>::loadConfiguration(const ConfigurationData& data)
 {
 	config_.outputRate           = data.value<TFloat>("output_rate");
 	config_.waveform             = data.value<int>("waveform");
@@ -389,6 +474,7 @@ VocalTractModel5<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	config_.temperature          = data.value<TFloat>("temperature");
 	config_.lossFactor           = data.value<TFloat>("loss_factor");
 	config_.modulation           = data.value<int>("noise_modulation");
+	config_.noiseGenerator       = data.value<int>("noise_generator");
 	config_.mixOffset            = data.value<TFloat>("mix_offset");
 	const TFloat globalRadiusCoef      = data.value<TFloat>("global_radius_coef");
 	const TFloat globalNasalRadiusCoef = data.value<TFloat>("global_nasal_radius_coef");
@@ -416,6 +502,10 @@ VocalTractModel5<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	config_.bypass               = data.value<int>("bypass");
 
 	logParameters_ = interactive_ ? false : data.value<bool>("log_parameters");
+	if (logParameters_) {
+		config_.logFile       = data.value<std::string>("log_parameters_file");
+		config_.logDecimation = data.value<int>("log_parameters_decimation", 1, 1000000);
+	}
 
 	constantRadiusMouthImpedance_ = data.value<bool>("constant_radius_mouth_impedance");
 	if (constantRadiusMouthImpedance_) {
@@ -423,18 +513,11 @@ VocalTractModel5<TFloat, SectionDelay>::loadConfiguration(const ConfigurationDat
 	}
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::reset() noexcept
+VocalTractModel5<TFloat, SectionDelay, Draft>::reset() noexcept
 {
-	for (auto& elem : oropharynx_) {
-		elem.reset();
-	}
-	for (auto& elem : nasal_) {
-		elem.reset();
-	}
-	inPtr_  = 0;
-	outPtr_ = 1;
+	tube_.reset();
 	currentParameter_.fill(0.0);
 	outputBuffer_.clear();
 	if (srConv_)                  srConv_->reset();
@@ -445,6 +528,8 @@ VocalTractModel5<TFloat, SectionDelay>::reset() noexcept
 	if (glottalNoiseFilter_)      glottalNoiseFilter_->reset();
 	if (fricationNoiseFilter_)    fricationNoiseFilter_->reset();
 	if (noiseSource_)             noiseSource_->reset();
+	noiseBlockIndex_ = NOISE_BLOCK_SIZE;
+	silenceDetector_.reset();
 	outputDiffFilter_.reset();
 }
 
@@ -456,14 +541,17 @@ VocalTractModel5<TFloat, SectionDelay>::reset() noexcept
 *             be run.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::initializeSynthesizer()
+VocalTractModel5<TFloat, SectionDelay, Draft>::initializeSynthesizer()
 {
-	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
-	const TFloat c = Util::speedOfSound(config_.temperature);
-	sampleRate_ = (c * (TOTAL_SECTIONS * SectionDelay) * 100.0f) / config_.length;
-	if (!interactive_) LOG_DEBUG("[VocalTractModel5] Internal sample rate: " << sampleRate_);
+	bandpassFilter_       = std::make_unique<BandpassFilter<TFloat>>();
+	glottalNoiseFilter_   = std::make_unique<Butterworth1LowPassFilter<TFloat>>();
+	fricationNoiseFilter_ = std::make_unique<Butterworth2LowPassFilter<TFloat>>();
+	glottalFilter_        = std::make_unique<Butterworth1LowPassFilter<TFloat>>();
+	noiseSource_          = std::make_unique<NoiseSource>(config_.noiseGenerator);
+
+	initializeSampleRate();
 
 	/*  CALCULATE THE BREATHINESS FACTOR  */
 	breathinessFactor_ = config_.breathiness / 100.0f;
@@ -474,24 +562,6 @@ VocalTractModel5<TFloat, SectionDelay>::initializeSynthesizer()
 	/*  CALCULATE THE DAMPING FACTOR  */
 	dampingFactor_ = 1.0f - (config_.lossFactor / 100.0f);
 
-	/*  INITIALIZE THE WAVE TABLE  */
-	glottalSource_ = std::make_unique<RosenbergBGlottalSource<TFloat>>(
-						config_.waveform == GLOTTAL_SOURCE_PULSE ?
-							RosenbergBGlottalSource<TFloat>::Type::pulse :
-							RosenbergBGlottalSource<TFloat>::Type::sine,
-						sampleRate_,
-						config_.tp, config_.tnMin, config_.tnMax);
-
-	/*  INITIALIZE RADIATION IMPEDANCE FOR MOUTH  */
-	mouthRadiationImpedance_ = std::make_unique<PoleZeroRadiationImpedance<TFloat>>(sampleRate_);
-
-	if (constantRadiusMouthImpedance_) {
-		mouthRadiationImpedance_->update(mouthImpedanceRadius_ * 1.0e-2f /* cm --> m */);
-	}
-
-	/*  INITIALIZE RADIATION IMPEDANCE FOR NOSE  */
-	nasalRadiationImpedance_ = std::make_unique<PoleZeroRadiationImpedance<TFloat>>(sampleRate_);
-
 	/*  INITIALIZE NASAL CAVITY FIXED SCATTERING COEFFICIENTS  */
 	initializeNasalCavity();
 
@@ -513,32 +583,114 @@ VocalTractModel5<TFloat, SectionDelay>::initializeSynthesizer()
 						});
 	}
 
-	bandpassFilter_       = std::make_unique<BandpassFilter<TFloat>>();
-	glottalNoiseFilter_   = std::make_unique<Butterworth1LowPassFilter<TFloat>>();
+	if (logParameters_) {
+		paramLogger_.open(config_.logFile, {"log_param_vtm5_pitch", "log_param_vtm5_output"},
+					sampleRate_, config_.logDecimation);
+	}
+}
+
+/******************************************************************************
+*
+*  function:  initializeSampleRate
+*
+*  purpose:   Calculates the sample rate, and initializes the
+*             glottal source and the filters that depend on it.
+*
+******************************************************************************/
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel5<TFloat, SectionDelay, Draft>::initializeSampleRate()
+{
+	/*  CALCULATE THE SAMPLE RATE, BASED ON NOMINAL TUBE LENGTH AND SPEED OF SOUND  */
+	const TFloat c = Util::speedOfSound(config_.temperature);
+	sampleRate_ = (c * (Topology::TOTAL_SECTIONS * SectionDelay) * 100.0f) / config_.length;
+	silenceDetector_.setSampleRate(sampleRate_);
+	if (!interactive_) LOG_DEBUG("[VocalTractModel5] Internal sample rate: " << sampleRate_);
+
+	/*  INITIALIZE THE WAVE TABLE  */
+	glottalSource_ = std::make_unique<RosenbergBGlottalSource<TFloat>>(
+						config_.waveform == GLOTTAL_SOURCE_PULSE ?
+							RosenbergBGlottalSource<TFloat>::Type::pulse :
+							RosenbergBGlottalSource<TFloat>::Type::sine,
+						sampleRate_,
+						config_.tp, config_.tnMin, config_.tnMax);
+
+	/*  INITIALIZE RADIATION IMPEDANCE FOR MOUTH  */
+	mouthRadiationImpedance_ = std::make_unique<PoleZeroRadiationImpedance<TFloat>>(sampleRate_, Draft);
+
+	if (constantRadiusMouthImpedance_) {
+		mouthRadiationImpedance_->update(mouthImpedanceRadius_ * 1.0e-2f /* cm --> m */);
+	}
+
+	/*  INITIALIZE RADIATION IMPEDANCE FOR NOSE  */
+	nasalRadiationImpedance_ = std::make_unique<PoleZeroRadiationImpedance<TFloat>>(sampleRate_, Draft);
+
+	const TFloat r = std::sqrt(0.5f * config_.nasalRadius[NR7] * config_.nasalRadius[NR7]);
+	nasalRadiationImpedance_->update(r * 1.0e-2f /* cm --> m */);
+
 	glottalNoiseFilter_->update(sampleRate_, config_.glottalNoiseCutoff);
-	fricationNoiseFilter_ = std::make_unique<Butterworth2LowPassFilter<TFloat>>();
 	fricationNoiseFilter_->update(sampleRate_, config_.fricationNoiseCutoff);
-	noiseSource_          = std::make_unique<NoiseSource>();
-	glottalFilter_        = std::make_unique<Butterworth1LowPassFilter<TFloat>>();
 	glottalFilter_->update(sampleRate_, config_.glottalLowpassCutoff);
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::execSynthesisStep() noexcept
+VocalTractModel5<TFloat, SectionDelay, Draft>::setTubeLengthAndTemperature(double length, double temperature)
+{
+	config_.length      = std::clamp(static_cast<TFloat>(length), MIN_VOCAL_TRACT_LENGTH, MAX_VOCAL_TRACT_LENGTH);
+	config_.temperature = temperature;
+
+	const TFloat prevSampleRate = sampleRate_;
+	initializeSampleRate();
+	if (sampleRate_ != prevSampleRate) {
+		srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	}
+	reset();
+}
+
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel5<TFloat, SectionDelay, Draft>::setOutputSampleRate(double outputRate)
+{
+	config_.outputRate = outputRate;
+	srConv_->setSampleRates(sampleRate_, config_.outputRate);
+	reset();
+}
+
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel5<TFloat, SectionDelay, Draft>::execSynthesisStep() noexcept
 {
 	/*  CONVERT PARAMETERS HERE  */
 	const TFloat f0 = Util::frequency(currentParameter_[PARAM_GLOT_PITCH]);
 	const TFloat glotAmplitude = Util::amplitude60dB(currentParameter_[PARAM_GLOT_VOL]);
 	const TFloat aspAmplitude = Util::amplitude60dB(currentParameter_[PARAM_ASP_VOL]);
+
+	const bool inputsSilent = glotAmplitude == 0.0f && aspAmplitude == 0.0f &&
+					Util::amplitude60dB(currentParameter_[PARAM_FRIC_VOL]) == 0.0f;
+
+	// Skip the tract while silent, but keep the sources running.
+	if (silenceDetector_.silent(inputsSilent)) {
+		TFloat glottalNoise, fricationNoise;
+		nextNoise(glottalNoise, fricationNoise);
+		bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
+		bandpassFilter_->filter(fricationNoise);
+		if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
+			glottalSource_->setup(glotAmplitude);
+		}
+		glottalFilter_->filter(glottalSource_->getSample(f0));
+		srConv_->dataFill(0.0);
+		if (logParameters_) logParameters(0.0);
+		return;
+	}
+
 	calculateTubeCoefficients();
 	bandpassFilter_->update(sampleRate_, currentParameter_[PARAM_FRIC_BW], currentParameter_[PARAM_FRIC_CF]);
 
-	const TFloat noiseSample = noiseSource_->getSample();
-
 	/*  DO SYNTHESIS HERE  */
 	/*  CREATE LOW-PASS FILTERED NOISE  */
-	const TFloat glottalNoise = glottalNoiseFilter_->filter(noiseSample);
+	TFloat glottalNoise, fricationNoise;
+	nextNoise(glottalNoise, fricationNoise);
 
 	/*  UPDATE THE SHAPE OF THE GLOTTAL PULSE, IF NECESSARY  */
 	if (config_.waveform == GLOTTAL_SOURCE_PULSE) {
@@ -554,7 +706,6 @@ VocalTractModel5<TFloat, SectionDelay>::execSynthesisStep() noexcept
 	/*  CREATE NOISY GLOTTAL PULSE  */
 	const TFloat noisyPulse = glotAmplitude * (pulse * (1.0f - breathinessFactor_) + pulsedNoise * breathinessFactor_);
 
-	TFloat fricationNoise = fricationNoiseFilter_->filter(noiseSample);
 	/*  CROSS-MIX PURE NOISE WITH PULSED NOISE  */
 	if (config_.modulation) {
 		TFloat crossmix = glotAmplitude * crossmixFactor_;
@@ -576,9 +727,19 @@ VocalTractModel5<TFloat, SectionDelay>::execSynthesisStep() noexcept
 							glottalLossFactor);
 	}
 	// Send to output.
+	if (inputsSilent) silenceDetector_.update(tube_.level());
 	srConv_->dataFill(interactive_ ? signal / f0 : signal); // divide by f0 to compensate for the differentiation at the output
 
-	if (logParameters_) GS_LOG_PARAMETER(paramLogger_, log_param_vtm5_pitch, currentParameter_[PARAM_GLOT_PITCH]);
+	if (logParameters_) logParameters(signal);
+}
+
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel5<TFloat, SectionDelay, Draft>::logParameters(TFloat output)
+{
+	paramLogger_.put(LOG_PARAM_PITCH, currentParameter_[PARAM_GLOT_PITCH]);
+	paramLogger_.put(LOG_PARAM_OUTPUT, output);
+	paramLogger_.nextFrame();
 }
 
 /******************************************************************************
@@ -589,17 +750,14 @@ VocalTractModel5<TFloat, SectionDelay>::execSynthesisStep() noexcept
 *             sections of the nasal cavity.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::initializeNasalCavity()
+VocalTractModel5<TFloat, SectionDelay, Draft>::initializeNasalCavity()
 {
 	// Configure junctions for fixed nasal sections.
 	for (int i = NJ2, j = NR2; i < NJ7; ++i, ++j) {
-		nasalJunction_[i].configure(config_.nasalRadius[j], config_.nasalRadius[j + 1]);
+		tube_.nasalJunction(i).configure(config_.nasalRadius[j], config_.nasalRadius[j + 1]);
 	}
-
-	const TFloat r = std::sqrt(0.5f * config_.nasalRadius[NR7] * config_.nasalRadius[NR7]);
-	nasalRadiationImpedance_->update(r * 1.0e-2f /* cm --> m */);
 }
 
 /******************************************************************************
@@ -612,13 +770,13 @@ VocalTractModel5<TFloat, SectionDelay>::initializeNasalCavity()
 *             pair for the mouth and nose.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::calculateTubeCoefficients()
+VocalTractModel5<TFloat, SectionDelay, Draft>::calculateTubeCoefficients()
 {
 	// Configure oropharynx junctions.
 	for (int i = J1, j = PARAM_R1; i < J8; ++i, ++j) {
-		oropharynxJunction_[i].configure(currentParameter_[j], currentParameter_[j + 1]);
+		tube_.oropharynxJunction(i).configure(currentParameter_[j], currentParameter_[j + 1]);
 	}
 
 	if (!constantRadiusMouthImpedance_) {
@@ -627,10 +785,10 @@ VocalTractModel5<TFloat, SectionDelay>::calculateTubeCoefficients()
 
 	// Configure 3-way junction.
 	// Note: Since junction is in middle of region 4, leftRadius = rightRadius.
-	velumJunction_.configure(currentParameter_[PARAM_R4], currentParameter_[PARAM_R4], currentParameter_[PARAM_VELUM]);
+	tube_.velumJunction().configure(currentParameter_[PARAM_R4], currentParameter_[PARAM_R4], currentParameter_[PARAM_VELUM]);
 
 	// Configure 1st nasal junction.
-	nasalJunction_[NJ1].configure(currentParameter_[PARAM_VELUM], config_.nasalRadius[NR2]);
+	tube_.nasalJunction(NJ1).configure(currentParameter_[PARAM_VELUM], config_.nasalRadius[NR2]);
 }
 
 /******************************************************************************
@@ -642,96 +800,65 @@ VocalTractModel5<TFloat, SectionDelay>::calculateTubeCoefficients()
 *             cavities.  Also injects frication appropriately.
 *
 ******************************************************************************/
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 TFloat
-VocalTractModel5<TFloat, SectionDelay>::vocalTract(TFloat input, TFloat frication, TFloat glottalLossFactor)
+VocalTractModel5<TFloat, SectionDelay, Draft>::vocalTract(TFloat input, TFloat frication, TFloat glottalLossFactor)
 {
-	Section::movePointers(inPtr_, outPtr_);
+	tube_.movePointers();
 
 	// Input to the tube.
-	oropharynx_[S1].top[inPtr_] = oropharynx_[S1].bottom[outPtr_] * glottalLossFactor + input;
-
-	propagate(oropharynx_[S1], oropharynx_[S2]);
-	propagate(oropharynx_[S2], oropharynx_[S3]);
-	propagateJunction(oropharynx_[S3], oropharynxJunction_[J1], oropharynx_[S4]);
-	propagate(oropharynx_[S4], oropharynx_[S5]);
-	propagateJunction(oropharynx_[S5], oropharynxJunction_[J2], oropharynx_[S6]);
-	propagate(oropharynx_[S6], oropharynx_[S7]);
-	propagate(oropharynx_[S7], oropharynx_[S8]);
-	propagate(oropharynx_[S8], oropharynx_[S9]);
-	propagateJunction(oropharynx_[S9], oropharynxJunction_[J3], oropharynx_[S10]);
-	propagate(oropharynx_[S10], oropharynx_[S11]);
-	propagate(oropharynx_[S11], oropharynx_[S12]);
-
-	// 3-way junction between the middle of R4 and the nasal cavity.
-	propagateJunction(oropharynx_[S12], velumJunction_, oropharynx_[S13], nasal_[VELUM]);
-
-	propagate(oropharynx_[S13], oropharynx_[S14]);
-	propagate(oropharynx_[S14], oropharynx_[S15]);
-	propagateJunction(oropharynx_[S15], oropharynxJunction_[J4], oropharynx_[S16]);
-	propagate(oropharynx_[S16], oropharynx_[S17]);
-	propagate(oropharynx_[S17], oropharynx_[S18]);
-	propagate(oropharynx_[S18], oropharynx_[S19]);
-	propagate(oropharynx_[S19], oropharynx_[S20]);
-	propagate(oropharynx_[S20], oropharynx_[S21]);
-	propagateJunction(oropharynx_[S21], oropharynxJunction_[J5], oropharynx_[S22]);
-	propagate(oropharynx_[S22], oropharynx_[S23]);
-	propagate(oropharynx_[S23], oropharynx_[S24]);
-	propagate(oropharynx_[S24], oropharynx_[S25]);
-	propagateJunction(oropharynx_[S25], oropharynxJunction_[J6], oropharynx_[S26]);
-	propagate(oropharynx_[S26], oropharynx_[S27]);
-	propagateJunction(oropharynx_[S27], oropharynxJunction_[J7], oropharynx_[S28]);
-	propagate(oropharynx_[S28], oropharynx_[S29]);
-	propagate(oropharynx_[S29], oropharynx_[S30]);
-
-	TFloat mouthOutputFlow;
-	mouthRadiationImpedance_->process(oropharynx_[S30].top[outPtr_], mouthOutputFlow, oropharynx_[S30].bottom[inPtr_]);
-	oropharynx_[S30].bottom[inPtr_] *= dampingFactor_;
-
-	propagate(nasal_[N1], nasal_[N2]);
-	propagate(nasal_[N2], nasal_[N3]);
-	propagateJunction(nasal_[N3], nasalJunction_[NJ1], nasal_[N4]);
-	propagate(nasal_[N4], nasal_[N5]);
-	propagate(nasal_[N5], nasal_[N6]);
-	propagateJunction(nasal_[N6], nasalJunction_[NJ2], nasal_[N7]);
-	propagate(nasal_[N7], nasal_[N8]);
-	propagate(nasal_[N8], nasal_[N9]);
-	propagateJunction(nasal_[N9], nasalJunction_[NJ3], nasal_[N10]);
-	propagate(nasal_[N10], nasal_[N11]);
-	propagate(nasal_[N11], nasal_[N12]);
-	propagateJunction(nasal_[N12], nasalJunction_[NJ4], nasal_[N13]);
-	propagate(nasal_[N13], nasal_[N14]);
-	propagate(nasal_[N14], nasal_[N15]);
-	propagateJunction(nasal_[N15], nasalJunction_[NJ5], nasal_[N16]);
-	propagate(nasal_[N16], nasal_[N17]);
-	propagate(nasal_[N17], nasal_[N18]);
-	propagateJunction(nasal_[N18], nasalJunction_[NJ6], nasal_[N19]);
-	propagate(nasal_[N19], nasal_[N20]);
-	propagate(nasal_[N20], nasal_[N21]);
-
-	TFloat nasalOutputFlow;
-	nasalRadiationImpedance_->process(nasal_[N21].top[outPtr_], nasalOutputFlow, nasal_[N21].bottom[inPtr_]);
-	nasal_[N21].bottom[inPtr_] *= dampingFactor_;
+	tube_.setInput(input, glottalLossFactor);
+
+	tube_.propagateOropharynx(dampingFactor_);
+
+	const TFloat mouthOutputFlow = tube_.radiateFromMouth(dampingFactor_, *mouthRadiationImpedance_);
+
+	tube_.propagateNasal(dampingFactor_);
+
+	const TFloat nasalOutputFlow = tube_.radiateFromNose(dampingFactor_, *nasalRadiationImpedance_);
 
 	// Add frication noise.
-	const TFloat fricOffset = (S28 - S6) * (currentParameter_[PARAM_FRIC_POS] / TFloat{GS_VTM5_MAX_FRIC_POS - GS_VTM5_MIN_FRIC_POS});
+	const TFloat fricOffset = (Topology::LAST_FRIC_SECTION - Topology::FIRST_FRIC_SECTION) * (currentParameter_[PARAM_FRIC_POS] / TFloat{GS_VTM5_MAX_FRIC_POS - GS_VTM5_MIN_FRIC_POS});
 	const int fricOffsetInt = static_cast<int>(fricOffset);
 	const TFloat fricRight = fricOffset - fricOffsetInt;
 	const TFloat fricLeft = 1.0f - fricRight;
 	const TFloat fricationAmplitude = Util::amplitude60dB(currentParameter_[PARAM_FRIC_VOL]);
 	const TFloat fricValue = fricationAmplitude * frication;
-	oropharynx_[S6 + fricOffsetInt].top[inPtr_] += fricValue * fricLeft;
-	if (S6 + fricOffsetInt < S28) {
-		oropharynx_[S6 + fricOffsetInt + 1].top[inPtr_] += fricValue * fricRight;
+	tube_.addToOropharynx(Topology::FIRST_FRIC_SECTION + fricOffsetInt, fricValue * fricLeft);
+	if (Topology::FIRST_FRIC_SECTION + fricOffsetInt < Topology::LAST_FRIC_SECTION) {
+		tube_.addToOropharynx(Topology::FIRST_FRIC_SECTION + fricOffsetInt + 1, fricValue * fricRight);
 	}
 
 	// Return summed output from mouth and nose.
 	return mouthOutputFlow + nasalOutputFlow;
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+/******************************************************************************
+*
+*  function:  nextNoise
+*
+*  purpose:   Returns the next samples of lowpass filtered noise.
+*             The noise is generated and filtered in blocks.
+*
+******************************************************************************/
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel5<TFloat, SectionDelay, Draft>::nextNoise(TFloat& glottalNoise, TFloat& fricationNoise)
+{
+	if (noiseBlockIndex_ == NOISE_BLOCK_SIZE) {
+		noiseSource_->getBlock(fricationNoiseBlock_.data(), NOISE_BLOCK_SIZE);
+		glottalNoiseFilter_->filter(fricationNoiseBlock_.data(), glottalNoiseBlock_.data(), NOISE_BLOCK_SIZE);
+		fricationNoiseFilter_->filter(fricationNoiseBlock_.data(), fricationNoiseBlock_.data(), NOISE_BLOCK_SIZE);
+		noiseBlockIndex_ = 0;
+	}
+	glottalNoise = glottalNoiseBlock_[noiseBlockIndex_];
+	fricationNoise = fricationNoiseBlock_[noiseBlockIndex_];
+	++noiseBlockIndex_;
+}
+
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::setParameter(int parameter, float value) noexcept
+VocalTractModel5<TFloat, SectionDelay, Draft>::setParameter(int parameter, float value) noexcept
 {
 	switch (parameter) {
 	case PARAM_GLOT_PITCH:
@@ -762,11 +889,11 @@ VocalTractModel5<TFloat, SectionDelay>::setParameter(int parameter, float value)
 	}
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::setAllParameters(const std::vector<float>& parameters) noexcept
+VocalTractModel5<TFloat, SectionDelay, Draft>::setAllParameters(const float* parameters, std::size_t numParameters) noexcept
 {
-	if (parameters.size() != TOTAL_PARAMETERS) {
+	if (numParameters != TOTAL_PARAMETERS) {
 		// Wrong number of parameters.
 		return; // fail silently
 	}
@@ -784,13 +911,81 @@ VocalTractModel5<TFloat, SectionDelay>::setAllParameters(const std::vector<float
 	currentParameter_[PARAM_VELUM] = parameters[PARAM_VELUM];
 }
 
-template<typename TFloat, unsigned int SectionDelay>
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
 void
-VocalTractModel5<TFloat, SectionDelay>::finishSynthesis() noexcept
+VocalTractModel5<TFloat, SectionDelay, Draft>::finishSynthesis() noexcept
 {
 	srConv_->flushBuffer();
 }
 
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel5<TFloat, SectionDelay, Draft>::saveState(std::vector<unsigned char>& state) const
+{
+	state.clear();
+	DSPStateWriter w(state);
+	w.writeTag("VocalTractModel5");
+	w.write(static_cast<unsigned int>(sizeof(TFloat)));
+	w.write(SectionDelay);
+	w.write(Draft);
+	w.write(sampleRate_);
+
+	w.write(currentParameter_);
+	w.writeVector(outputBuffer_);
+	tube_.saveState(w);
+	srConv_->saveState(w);
+	mouthRadiationImpedance_->saveState(w);
+	nasalRadiationImpedance_->saveState(w);
+	glottalSource_->saveState(w);
+	bandpassFilter_->saveState(w);
+	glottalNoiseFilter_->saveState(w);
+	fricationNoiseFilter_->saveState(w);
+	noiseSource_->saveState(w);
+	glottalFilter_->saveState(w);
+	w.write(glottalNoiseBlock_);
+	w.write(fricationNoiseBlock_);
+	w.write(noiseBlockIndex_);
+	silenceDetector_.saveState(w);
+	outputDiffFilter_.saveState(w);
+}
+
+template<typename TFloat, unsigned int SectionDelay, bool Draft>
+void
+VocalTractModel5<TFloat, SectionDelay, Draft>::loadState(const std::vector<unsigned char>& state)
+{
+	DSPStateReader r(state);
+	r.readTag("VocalTractModel5");
+	r.expect(static_cast<unsigned int>(sizeof(TFloat)), "floating-point type");
+	r.expect(SectionDelay, "section delay");
+	r.expect(Draft, "tube resolution");
+	r.expect(sampleRate_, "sample rate");
+
+	r.read(currentParameter_);
+	r.readVector(outputBuffer_, true);
+	tube_.loadState(r);
+	srConv_->loadState(r);
+	mouthRadiationImpedance_->loadState(r);
+	nasalRadiationImpedance_->loadState(r);
+	glottalSource_->loadState(r);
+	bandpassFilter_->loadState(r);
+	glottalNoiseFilter_->loadState(r);
+	fricationNoiseFilter_->loadState(r);
+	noiseSource_->loadState(r);
+	glottalFilter_->loadState(r);
+	r.read(glottalNoiseBlock_);
+	r.read(fricationNoiseBlock_);
+	r.read(noiseBlockIndex_);
+	silenceDetector_.loadState(r);
+	outputDiffFilter_.loadState(r);
+
+	if (noiseBlockIndex_ > NOISE_BLOCK_SIZE) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel5] Invalid noise block index in state: " << noiseBlockIndex_ << '.');
+	}
+	if (!r.atEnd()) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModel5] Unexpected data at the end of the state.");
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
 
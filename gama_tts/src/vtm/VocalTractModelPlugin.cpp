@@ -31,15 +31,19 @@
 // POSIX.1-2001
 #include <dlfcn.h> /* dlclose, dlerror, dlopen, dlsym */
 
+#include <algorithm> /* min */
 #include <iostream>
 #include <string>
 
 #include "ConfigurationData.h"
+#include "DSPState.h"
 #include "Exception.h"
 
 #define CONSTRUCT_VTM_SYMBOL "GAMA_TTS_construct_vocal_tract_model"
 #define  DESTRUCT_VTM_SYMBOL "GAMA_TTS_destruct_vocal_tract_model"
 
+#define VTM_PLUGIN_MAX_BLOCK_FRAMES 4096U
+
 
 
 extern "C" {
@@ -56,6 +60,10 @@ namespace VTM {
 
 VocalTractModelPlugin::VocalTractModelPlugin(const ConfigurationData& data, bool interactive)
 		: dll_(nullptr)
+		, destructVTM_(nullptr)
+		, vtm_(nullptr)
+		, interface_(nullptr)
+		, instance_(nullptr)
 {
 	const std::string dllPath = data.value<std::string>("dll_path");
 	dlerror(); // reset error
@@ -74,6 +82,38 @@ VocalTractModelPlugin::VocalTractModelPlugin(const ConfigurationData& data, bool
 		}
 	}
 
+	try {
+		auto getInterface = reinterpret_cast<GamaTTSVTMPluginGetInterface>(dlsym(dll_, GAMA_TTS_VTM_PLUGIN_INTERFACE_SYMBOL));
+		if (getInterface) {
+			loadVersion2(getInterface(GAMA_TTS_VTM_PLUGIN_ABI_VERSION), data, interactive);
+		} else {
+			loadVersion1(data, interactive);
+		}
+	} catch (...) {
+		dlclose(dll_);
+		throw;
+	}
+}
+
+VocalTractModelPlugin::~VocalTractModelPlugin() noexcept
+{
+	// Must be called before dlclose.
+	if (interface_) {
+		interface_->destroy(instance_);
+	} else {
+		(*reinterpret_cast<DestructVTM>(destructVTM_))(vtm_);
+	}
+
+	dlerror(); // reset error
+	int retVal = dlclose(dll_);
+	if (retVal != 0) {
+		std::cerr << "Error in dlclose: " << dlerror() << std::endl;
+	}
+}
+
+void
+VocalTractModelPlugin::loadVersion1(const ConfigurationData& data, bool interactive)
+{
 	ConstructVTM constructVTM = reinterpret_cast<ConstructVTM>(dlsym(dll_, CONSTRUCT_VTM_SYMBOL));
 	if (constructVTM == NULL) {
 		THROW_EXCEPTION(UnavailableResourceException, "Error: " << dlerror());
@@ -90,64 +130,191 @@ VocalTractModelPlugin::VocalTractModelPlugin(const ConfigurationData& data, bool
 	}
 }
 
-VocalTractModelPlugin::~VocalTractModelPlugin() noexcept
+void
+VocalTractModelPlugin::loadVersion2(const GamaTTSVTMPluginInterface* pluginInterface, const ConfigurationData& data, bool interactive)
 {
-	(*reinterpret_cast<DestructVTM>(destructVTM_))(vtm_); // must be called before dlclose
+	if (!pluginInterface) {
+		THROW_EXCEPTION(UnavailableResourceException, "[VocalTractModelPlugin] The plugin does not support the ABI version "
+				<< GAMA_TTS_VTM_PLUGIN_ABI_VERSION << '.');
+	}
+	if (pluginInterface->abi_version != GAMA_TTS_VTM_PLUGIN_ABI_VERSION || pluginInterface->struct_size < sizeof(GamaTTSVTMPluginInterface)) {
+		THROW_EXCEPTION(UnavailableResourceException, "[VocalTractModelPlugin] Incompatible plugin ABI version: "
+				<< pluginInterface->abi_version << '.');
+	}
+	if (!pluginInterface->create || !pluginInterface->destroy || !pluginInterface->reset ||
+			!pluginInterface->internal_sample_rate || !pluginInterface->output_sample_rate ||
+			!pluginInterface->max_output_samples || !pluginInterface->render || !pluginInterface->finish) {
+		THROW_EXCEPTION(UnavailableResourceException, "[VocalTractModelPlugin] Incomplete plugin pluginInterface.");
+	}
+	if ((pluginInterface->capabilities & GAMA_TTS_VTM_PLUGIN_CAP_STATE) &&
+			(!pluginInterface->state_size || !pluginInterface->save_state || !pluginInterface->load_state)) {
+		THROW_EXCEPTION(UnavailableResourceException, "[VocalTractModelPlugin] Incomplete plugin pluginInterface (state).");
+	}
 
-	dlerror(); // reset error
-	int retVal = dlclose(dll_);
-	if (retVal != 0) {
-		std::cerr << "Error in dlclose: " << dlerror() << std::endl;
+	instance_ = pluginInterface->create(&data, interactive);
+	if (!instance_) {
+		THROW_EXCEPTION(UnavailableResourceException, "Could not construct the vocal tract model.");
 	}
+	interface_ = pluginInterface;
+	outputBuffer_.reserve(OUTPUT_BUFFER_RESERVE);
 }
 
 void
 VocalTractModelPlugin::reset() noexcept
 {
+	if (interface_) {
+		interface_->reset(instance_);
+		outputBuffer_.clear();
+		return;
+	}
 	return vtm_->reset();
 }
 
 double
 VocalTractModelPlugin::internalSampleRate() const noexcept
 {
+	if (interface_) {
+		return interface_->internal_sample_rate(instance_);
+	}
 	return vtm_->internalSampleRate();
 }
 
 double
 VocalTractModelPlugin::outputSampleRate() const noexcept
 {
+	if (interface_) {
+		return interface_->output_sample_rate(instance_);
+	}
 	return vtm_->outputSampleRate();
 }
 
 void
 VocalTractModelPlugin::setParameter(int parameter, float value) noexcept
 {
+	if (interface_) {
+		if (parameter >= 0 && static_cast<std::size_t>(parameter) < currentParameter_.size()) {
+			currentParameter_[parameter] = value;
+		}
+		return;
+	}
 	return vtm_->setParameter(parameter, value);
 }
 
 void
-VocalTractModelPlugin::setAllParameters(const std::vector<float>& parameters) noexcept
+VocalTractModelPlugin::setAllParameters(const float* parameters, std::size_t numParameters) noexcept
 {
-	return vtm_->setAllParameters(parameters);
+	if (interface_) {
+		currentParameter_.assign(parameters, parameters + numParameters);
+		return;
+	}
+	return vtm_->setAllParameters(parameters, numParameters);
 }
 
 void
 VocalTractModelPlugin::execSynthesisStep() noexcept
 {
+	if (interface_) {
+		render(currentParameter_.data(), 1, currentParameter_.size());
+		return;
+	}
 	return vtm_->execSynthesisStep();
 }
 
+void
+VocalTractModelPlugin::execSynthesisSteps(const float* frames, std::size_t numFrames, std::size_t numParameters) noexcept
+{
+	if (interface_) {
+		render(frames, numFrames, numParameters);
+		if (numFrames > 0) {
+			const float* lastFrame = frames + (numFrames - 1U) * numParameters;
+			currentParameter_.assign(lastFrame, lastFrame + numParameters);
+		}
+		return;
+	}
+	// Do not call vtm_->execSynthesisSteps(), because the plugins
+	// of ABI version 1 may have been built without it.
+	VocalTractModel::execSynthesisSteps(frames, numFrames, numParameters);
+}
+
+void
+VocalTractModelPlugin::render(const float* frames, std::size_t numFrames, std::size_t numParameters) noexcept
+{
+	while (numFrames > 0) {
+		const uint32_t blockFrames = static_cast<uint32_t>(std::min<std::size_t>(numFrames, VTM_PLUGIN_MAX_BLOCK_FRAMES));
+
+		const std::size_t size = outputBuffer_.size();
+		outputBuffer_.resize(size + interface_->max_output_samples(instance_, blockFrames));
+		const uint32_t n = interface_->render(instance_, frames, blockFrames, numParameters, outputBuffer_.data() + size);
+		outputBuffer_.resize(size + n);
+
+		frames += blockFrames * numParameters;
+		numFrames -= blockFrames;
+	}
+}
+
 void
 VocalTractModelPlugin::finishSynthesis() noexcept
 {
+	if (interface_) {
+		const std::size_t size = outputBuffer_.size();
+		outputBuffer_.resize(size + interface_->max_output_samples(instance_, 0));
+		const uint32_t n = interface_->finish(instance_, outputBuffer_.data() + size);
+		outputBuffer_.resize(size + n);
+		return;
+	}
 	return vtm_->finishSynthesis();
 }
 
 std::vector<float>&
 VocalTractModelPlugin::outputBuffer() noexcept
 {
+	if (interface_) {
+		return outputBuffer_;
+	}
 	return vtm_->outputBuffer();
 }
 
+void
+VocalTractModelPlugin::saveState(std::vector<unsigned char>& state) const
+{
+	if (!interface_ || !(interface_->capabilities & GAMA_TTS_VTM_PLUGIN_CAP_STATE)) {
+		return VocalTractModel::saveState(state);
+	}
+
+	std::vector<unsigned char> pluginState(interface_->state_size(instance_));
+	if (interface_->save_state(instance_, pluginState.data(), pluginState.size()) != 0) {
+		THROW_EXCEPTION(VTMException, "[VocalTractModelPlugin] Could not save the state of the plugin.");
+	}
+
+	state.clear();
+	DSPStateWriter w(state);
+	w.writeTag("VocalTractModelPlugin");
+	w.writeVector(pluginState);
+	w.writeVector(currentParameter_);
+	w.writeVector(outputBuffer_);
+}
+
+void
+VocalTractModelPlugin::loadState(const std::vector<unsigned char>& state)
+{
+	if (!interface_ || !(interface_->capabilities & GAMA_TTS_VTM_PLUGIN_CAP_STATE)) {
+		return VocalTractModel::loadState(state);
+	}
+
+	std::vector<unsigned char> pluginState(interface_->state_size(instance_));
+	DSPStateReader r(state);
+	r.readTag("VocalTractModelPlugin");
+	r.readVector(pluginState);
+	r.readVector(currentParameter_, true);
+	r.readVector(outputBuffer_, true);
+	if (!r.atEnd()) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModelPlugin] Unexpected data at the end of the state.");
+	}
+
+	if (interface_->load_state(instance_, pluginState.data(), pluginState.size()) != 0) {
+		THROW_EXCEPTION(InvalidValueException, "[VocalTractModelPlugin] The plugin rejected the state.");
+	}
+}
+
 } /* namespace VTM */
 } /* namespace GS */
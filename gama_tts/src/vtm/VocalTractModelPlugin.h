@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "VocalTractModel.h"
+#include "VocalTractModelPluginABI.h"
 
 
 
@@ -41,6 +42,8 @@ class ConfigurationData;
 
 namespace VTM {
 
+// Loads a vocal tract model from a shared library.
+// The ABI versions 1 and 2 are supported (see VocalTractModelPluginABI.h).
 class VocalTractModelPlugin : public VocalTractModel {
 public:
 	explicit VocalTractModelPlugin(const ConfigurationData& data, bool interactive=false);
@@ -52,16 +55,42 @@ public:
 	virtual double outputSampleRate() const noexcept;
 
 	virtual void setParameter(int parameter, float value) noexcept;
-	virtual void setAllParameters(const std::vector<float>& parameters) noexcept;
+	virtual void setAllParameters(const float* parameters, std::size_t numParameters) noexcept;
+	using VocalTractModel::setAllParameters;
 
 	virtual void execSynthesisStep() noexcept;
 	virtual void finishSynthesis() noexcept;
 
 	virtual std::vector<float>& outputBuffer() noexcept;
+
+	virtual void execSynthesisSteps(const float* frames, std::size_t numFrames, std::size_t numParameters) noexcept;
+
+	// Only supported by the plugins of ABI version 2 with GAMA_TTS_VTM_PLUGIN_CAP_STATE.
+	virtual void saveState(std::vector<unsigned char>& state) const;
+	virtual void loadState(const std::vector<unsigned char>& state);
+
+	unsigned int abiVersion() const noexcept { return interface_ ? interface_->abi_version : 1U; }
 private:
+	VocalTractModelPlugin(const VocalTractModelPlugin&) = delete;
+	VocalTractModelPlugin& operator=(const VocalTractModelPlugin&) = delete;
+	VocalTractModelPlugin(VocalTractModelPlugin&&) = delete;
+	VocalTractModelPlugin& operator=(VocalTractModelPlugin&&) = delete;
+
+	void loadVersion1(const ConfigurationData& data, bool interactive);
+	void loadVersion2(const GamaTTSVTMPluginInterface* pluginInterface, const ConfigurationData& data, bool interactive);
+	void render(const float* frames, std::size_t numFrames, std::size_t numParameters) noexcept;
+
 	void* dll_;
+
+	// ABI version 1.
 	void* destructVTM_;
 	VocalTractModel* vtm_;
+
+	// ABI version 2.
+	const GamaTTSVTMPluginInterface* interface_;
+	void* instance_;
+	std::vector<float> currentParameter_; // used by setParameter() and execSynthesisStep()
+	std::vector<float> outputBuffer_;
 };
 
 } /* namespace VTM */
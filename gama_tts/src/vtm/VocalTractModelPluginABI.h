@@ -0,0 +1,115 @@
+/*
+ * Copyright 2026 Marcelo Y. Matuda
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*******************************************************************************
+ * Vocal tract model plugin ABI, version 2.
+ *
+ * The plugin exports the function GAMA_TTS_VTM_PLUGIN_INTERFACE_SYMBOL:
+ *
+ *   const GamaTTSVTMPluginInterface* GAMA_TTS_vocal_tract_model_plugin_interface(uint32_t host_abi_version);
+ *
+ * It must return the function table for the highest ABI version that is
+ * not greater than host_abi_version, or NULL if it does not support any
+ * of them. The table must remain valid while the plugin is loaded.
+ *
+ * The synthesis runs in blocks. render() executes one synthesis step for
+ * each parameter frame and writes the output samples to a buffer owned by
+ * the host, so the plugin boundary is crossed once per block, instead of
+ * several times per sample.
+ *
+ * The functions must not throw exceptions. The functions that receive an
+ * instance may be called by one thread at a time.
+ *
+ * Plugins that only export the version 1 symbols
+ * (GAMA_TTS_construct_vocal_tract_model and GAMA_TTS_destruct_vocal_tract_model)
+ * are still supported.
+ */
+
+#ifndef VTM_PLUGIN_ABI_H
+#define VTM_PLUGIN_ABI_H
+
+#include <stdint.h>
+
+#define GAMA_TTS_VTM_PLUGIN_ABI_VERSION 2U
+#define GAMA_TTS_VTM_PLUGIN_INTERFACE_SYMBOL "GAMA_TTS_vocal_tract_model_plugin_interface"
+
+/* Capabilities. */
+#define GAMA_TTS_VTM_PLUGIN_CAP_STATE 0x1U /* save_state and load_state are implemented */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GamaTTSVTMPluginInterface {
+	/* ABI version of this table. */
+	uint32_t abi_version;
+	/* sizeof(GamaTTSVTMPluginInterface) in the plugin. */
+	uint32_t struct_size;
+	/* GAMA_TTS_VTM_PLUGIN_CAP_* flags. */
+	uint32_t capabilities;
+
+	/* config_data points to a GS::ConfigurationData. Returns NULL on error. */
+	void* (*create)(const void* config_data, int is_interactive);
+	void (*destroy)(void* vtm);
+
+	void (*reset)(void* vtm);
+	double (*internal_sample_rate)(const void* vtm);
+	double (*output_sample_rate)(const void* vtm);
+
+	/* Maximum number of samples that render() may write for num_frames
+	   frames. With num_frames = 0, returns the maximum number of samples
+	   that finish() may write. */
+	uint32_t (*max_output_samples)(const void* vtm, uint32_t num_frames);
+
+	/* Executes one synthesis step for each frame. frames contains num_frames
+	   consecutive sets of num_parameters values. The output buffer must have
+	   space for max_output_samples(vtm, num_frames) samples.
+	   Returns the number of samples written to output. */
+	uint32_t (*render)(void* vtm, const float* frames, uint32_t num_frames, uint32_t num_parameters, float* output);
+
+	/* Flushes the internal buffers. The output buffer must have space for
+	   max_output_samples(vtm, 0) samples.
+	   Returns the number of samples written to output. */
+	uint32_t (*finish)(void* vtm, float* output);
+
+	/* Size in bytes of the synthesis state. It does not change during the
+	   life of the instance. Returns 0 if GAMA_TTS_VTM_PLUGIN_CAP_STATE is not set. */
+	uint32_t (*state_size)(const void* vtm);
+
+	/* size must be equal to state_size(vtm). Return 0 on success. */
+	int (*save_state)(const void* vtm, void* state, uint32_t size);
+	int (*load_state)(void* vtm, const void* state, uint32_t size);
+} GamaTTSVTMPluginInterface;
+
+typedef const GamaTTSVTMPluginInterface* (*GamaTTSVTMPluginGetInterface)(uint32_t host_abi_version);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* VTM_PLUGIN_ABI_H */
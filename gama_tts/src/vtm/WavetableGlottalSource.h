@@ -21,11 +21,13 @@
 #ifndef VTM_WAVETABLE_GLOTTAL_SOURCE_H_
 #define VTM_WAVETABLE_GLOTTAL_SOURCE_H_
 
-#include <algorithm> /* max */
+#include <algorithm> /* max, min */
 #include <cmath>
+#include <cstddef> /* std::size_t */
 #include <memory>
 #include <vector>
 
+#include "DSPState.h"
 #include "Exception.h"
 #include "WavetableGlottalSourceFIRFilter.h"
 
@@ -37,6 +39,13 @@
 namespace GS {
 namespace VTM {
 
+// The falling portion of the glottal pulse depends on the amplitude.
+// A bank of precomputed tables is used, so setup() only selects the tables.
+// If bankSize is 0, there is one table for each possible closure point,
+// and the result is the same as recalculating the table.
+// If bankSize is smaller than the number of closure points, the tables
+// are spaced evenly over the amplitude range, and the oscillator
+// interpolates between the two neighbouring tables.
 template<typename TFloat>
 class WavetableGlottalSource {
 public:
@@ -48,10 +57,16 @@ public:
 
 	WavetableGlottalSource(
 			Type type, TFloat sampleRate,
-			TFloat tp = 0.0, TFloat tnMin = 0.0, TFloat tnMax = 0.0);
+			TFloat tp = 0.0, TFloat tnMin = 0.0, TFloat tnMax = 0.0,
+			unsigned int bankSize = 0);
 	~WavetableGlottalSource() = default;
 
 	void reset();
+	// Only the oscillator increment depends on the sample rate,
+	// so the tables are not recalculated.
+	void setSampleRate(TFloat sampleRate);
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat getSample(TFloat frequency);
 	void setup(TFloat amplitude);
 private:
@@ -61,9 +76,17 @@ private:
 	WavetableGlottalSource& operator=(WavetableGlottalSource&&) = delete;
 
 	void incrementTablePosition(TFloat frequency);
+	void calculateFallingPortion(unsigned int closureShift, TFloat* table);
+	TFloat tableValue(unsigned int position) const {
+		return table0_[position] + blend_ * (table1_[position] - table0_[position]);
+	}
 
 	TFloat mod0(TFloat value);
 
+	// The tables are stored in the state as offsets in bank_ (-1 means wavetable_).
+	long long tableOffset(const TFloat* table) const;
+	const TFloat* tableFromOffset(long long offset) const;
+
 	/*  GLOTTAL SOURCE OSCILLATOR TABLE VARIABLES  */
 	const unsigned int tableLength_;
 	const unsigned int tableModulus_;
@@ -80,6 +103,11 @@ private:
 	TFloat basicIncrement_;
 	TFloat currentPosition_;
 	std::vector<TFloat> wavetable_;
+	std::vector<TFloat> bank_;
+	unsigned int bankTables_;
+	const TFloat* table0_;
+	const TFloat* table1_;
+	TFloat blend_;
 	std::unique_ptr<WavetableGlottalSourceFIRFilter<TFloat>> firFilter_;
 	TFloat prevAmplitude_;
 };
@@ -88,13 +116,18 @@ private:
 
 template<typename TFloat>
 WavetableGlottalSource<TFloat>::WavetableGlottalSource(Type type, TFloat sampleRate,
-			TFloat tp, TFloat tnMin, TFloat tnMax)
+			TFloat tp, TFloat tnMin, TFloat tnMax,
+			unsigned int bankSize)
 		: tableLength_(512)
 		, tableModulus_(tableLength_ - 1)
 		, firBeta_(0.2)
 		, firGamma_(0.1)
 		, firCutoff_(0.00000001)
 		, wavetable_(tableLength_)
+		, bankTables_()
+		, table0_(wavetable_.data())
+		, table1_(wavetable_.data())
+		, blend_()
 		, prevAmplitude_(-1.0)
 {
 	// Calculates the initial glottal pulse and stores it
@@ -135,6 +168,21 @@ WavetableGlottalSource<TFloat>::WavetableGlottalSource(Type type, TFloat sampleR
 		}
 	}
 
+	/*  CALCULATE THE BANK OF TABLES FOR THE VARIABLE FALLING PORTION  */
+	if (type == Type::pulse && tnDelta_ > 0.0) {
+		const unsigned int numClosurePoints = static_cast<unsigned int>(tnDelta_) + 1U;
+		bankTables_ = (bankSize == 0 || bankSize >= numClosurePoints) ? numClosurePoints : std::max(bankSize, 2U);
+		bank_.resize(static_cast<std::size_t>(bankTables_) * tableLength_);
+		for (unsigned int i = 0; i < bankTables_; ++i) {
+			TFloat* table = &bank_[static_cast<std::size_t>(i) * tableLength_];
+			std::copy(wavetable_.begin(), wavetable_.end(), table);
+			const unsigned int closureShift = (bankTables_ == numClosurePoints) ?
+						i :
+						static_cast<unsigned int>(std::rint((static_cast<TFloat>(i) / (bankTables_ - 1U)) * tnDelta_));
+			calculateFallingPortion(closureShift, table);
+		}
+	}
+
 #if VTM_WAVETABLE_GLOTTAL_SOURCE_OVERSAMPLING_OSCILLATOR
 	firFilter_ = std::make_unique<WavetableGlottalSourceFIRFilter<TFloat>>(firBeta_, firGamma_, firCutoff_);
 #endif
@@ -146,40 +194,130 @@ WavetableGlottalSource<TFloat>::reset()
 {
 	currentPosition_ = 0;
 	firFilter_->reset();
+	table0_ = wavetable_.data();
+	table1_ = wavetable_.data();
+	blend_ = 0.0;
 	prevAmplitude_ = -1.0;
 }
 
+template<typename TFloat>
+void
+WavetableGlottalSource<TFloat>::setSampleRate(TFloat sampleRate)
+{
+	basicIncrement_ = tableLength_ / sampleRate;
+}
+
+template<typename TFloat>
+void
+WavetableGlottalSource<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.write(currentPosition_);
+	w.write(tableOffset(table0_));
+	w.write(tableOffset(table1_));
+	w.write(blend_);
+	w.write(prevAmplitude_);
+	firFilter_->saveState(w);
+}
+
+template<typename TFloat>
+void
+WavetableGlottalSource<TFloat>::loadState(DSPStateReader& r)
+{
+	long long offset0, offset1;
+	r.read(currentPosition_);
+	r.read(offset0);
+	r.read(offset1);
+	r.read(blend_);
+	r.read(prevAmplitude_);
+	firFilter_->loadState(r);
+	table0_ = tableFromOffset(offset0);
+	table1_ = tableFromOffset(offset1);
+}
+
+template<typename TFloat>
+long long
+WavetableGlottalSource<TFloat>::tableOffset(const TFloat* table) const
+{
+	if (table == wavetable_.data()) {
+		return -1;
+	}
+	return table - bank_.data();
+}
+
+template<typename TFloat>
+const TFloat*
+WavetableGlottalSource<TFloat>::tableFromOffset(long long offset) const
+{
+	if (offset == -1) {
+		return wavetable_.data();
+	}
+	if (offset < 0 || offset % tableLength_ != 0 || static_cast<unsigned long long>(offset) >= bank_.size()) {
+		THROW_EXCEPTION(InvalidValueException, "[WavetableGlottalSource] Invalid table offset in state: " << offset << '.');
+	}
+	return bank_.data() + offset;
+}
+
 /******************************************************************************
 *
-*  function:  updateWavetable
+*  function:  setup
 *
-*  purpose:   Rewrites the changeable part of the glottal pulse
-*             according to the amplitude.
+*  purpose:   Selects the tables of the glottal pulse that correspond
+*             to the amplitude.
 *
 ******************************************************************************/
 template<typename TFloat>
 void
 WavetableGlottalSource<TFloat>::setup(TFloat amplitude)
 {
-	if (tnDelta_ == 0.0 || amplitude == prevAmplitude_) {
+	if (bankTables_ == 0 || amplitude == prevAmplitude_) {
 		return;
 	} else {
 		prevAmplitude_ = amplitude;
 	}
 
-	/*  CALCULATE NEW CLOSURE POINT, BASED ON AMPLITUDE  */
-	const TFloat newDiv2 = std::max(tableDiv2_ - std::rint(amplitude * tnDelta_), TFloat{0.0});
+	const unsigned int lastTable = bankTables_ - 1U;
+	if (bankTables_ == static_cast<unsigned int>(tnDelta_) + 1U) {
+		/*  ONE TABLE FOR EACH CLOSURE POINT  */
+		const TFloat closureShift = std::min(std::max(std::rint(amplitude * tnDelta_), TFloat{0.0}), tnDelta_);
+		table0_ = &bank_[static_cast<std::size_t>(closureShift) * tableLength_];
+		table1_ = table0_;
+		blend_ = 0.0;
+	} else {
+		/*  INTERPOLATE BETWEEN NEIGHBOURING TABLES  */
+		const TFloat position = std::min(std::max(amplitude, TFloat{0.0}), TFloat{1.0}) * lastTable;
+		const unsigned int index = std::min(static_cast<unsigned int>(position), lastTable - 1U);
+		table0_ = &bank_[static_cast<std::size_t>(index) * tableLength_];
+		table1_ = table0_ + tableLength_;
+		blend_ = position - index;
+	}
+}
+
+/******************************************************************************
+*
+*  function:  calculateFallingPortion
+*
+*  purpose:   Rewrites the changeable part of the glottal pulse
+*             in the table, moving the closure point back by
+*             closureShift positions.
+*
+******************************************************************************/
+template<typename TFloat>
+void
+WavetableGlottalSource<TFloat>::calculateFallingPortion(unsigned int closureShift, TFloat* table)
+{
+	/*  CALCULATE NEW CLOSURE POINT  */
+	const TFloat newDiv2 = std::max(tableDiv2_ - static_cast<TFloat>(closureShift), TFloat{0.0});
 	const TFloat invNewTnLength = 1.0f / (newDiv2 - tableDiv1_);
 
 	/*  RECALCULATE THE FALLING PORTION OF THE GLOTTAL PULSE  */
 	TFloat x = 0.0;
 	for (unsigned int i = tableDiv1_, end = static_cast<unsigned int>(newDiv2); i < end; ++i, x += invNewTnLength) {
-		wavetable_[i] = 1.0f - (x * x);
+		table[i] = 1.0f - (x * x);
 	}
 
 	/*  FILL IN WITH CLOSED PORTION OF GLOTTAL PULSE  */
 	for (unsigned int i = static_cast<unsigned int>(newDiv2); i < tableDiv2_; i++) {
-		wavetable_[i] = 0.0;
+		table[i] = 0.0;
 	}
 }
 
@@ -222,9 +360,10 @@ WavetableGlottalSource<TFloat>::getSample(TFloat frequency)  /*  2X OVERSAMPLING
 		const unsigned int upperPosition = static_cast<unsigned int>(mod0(lowerPosition + 1));
 
 		/*  CALCULATE INTERPOLATED TABLE VALUE  */
-		const TFloat interpolatedValue = wavetable_[lowerPosition] +
+		const TFloat lowerValue = tableValue(lowerPosition);
+		const TFloat interpolatedValue = lowerValue +
 					((currentPosition_ - lowerPosition) *
-					(wavetable_[upperPosition] - wavetable_[lowerPosition]));
+					(tableValue(upperPosition) - lowerValue));
 
 		/*  PUT VALUE THROUGH FIR FILTER  */
 		output = firFilter_->filter(interpolatedValue, i);
@@ -246,9 +385,10 @@ WavetableGlottalSource<TFloat>::getSample(TFloat frequency)  /*  PLAIN OSCILLATO
 	const unsigned int upperPosition = static_cast<unsigned int>(mod0(lowerPosition + 1));
 
 	/*  RETURN INTERPOLATED TABLE VALUE  */
-	return wavetable_[lowerPosition] +
+	const TFloat lowerValue = tableValue(lowerPosition);
+	return lowerValue +
 		((currentPosition_ - lowerPosition) *
-		(wavetable_[upperPosition] - wavetable_[lowerPosition]));
+		(tableValue(upperPosition) - lowerValue));
 }
 #endif
 
@@ -24,6 +24,7 @@
 #include <cmath>
 #include <vector>
 
+#include "DSPState.h"
 #include "Exception.h"
 
 
@@ -45,6 +46,8 @@ public:
 	~WavetableGlottalSourceFIRFilter() = default;
 
 	void reset();
+	void saveState(DSPStateWriter& w) const;
+	void loadState(DSPStateReader& r);
 	TFloat filter(TFloat input, int needOutput);
 private:
 	enum {
@@ -121,6 +124,25 @@ WavetableGlottalSourceFIRFilter<TFloat>::reset()
 	ptr_ = 0;
 }
 
+template<typename TFloat>
+void
+WavetableGlottalSourceFIRFilter<TFloat>::saveState(DSPStateWriter& w) const
+{
+	w.writeVector(data_);
+	w.write(ptr_);
+}
+
+template<typename TFloat>
+void
+WavetableGlottalSourceFIRFilter<TFloat>::loadState(DSPStateReader& r)
+{
+	r.readVector(data_);
+	r.read(ptr_);
+	if (ptr_ < 0 || ptr_ >= numberTaps_) {
+		THROW_EXCEPTION(InvalidValueException, "[WavetableGlottalSourceFIRFilter] Invalid pointer in state: " << ptr_ << '.');
+	}
+}
+
 /******************************************************************************
 *
 *  function:  maximallyFlat
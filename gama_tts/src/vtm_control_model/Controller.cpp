@@ -20,30 +20,73 @@
 
 #include "Controller.h"
 
+#include <algorithm> /* copy, min */
+#include <atomic>
 #include <cctype> /* isspace */
 #include <cmath> /* rint */
-#include <cstdio> /* printf */
+#include <exception>
 #include <fstream>
 #include <sstream>
+#include <system_error>
+#include <thread>
+#include <utility> /* move */
 
 #include "Exception.h"
 #include "Index.h"
 #include "Log.h"
+#include "SampleRateConverter.h"
 #include "VTMUtil.h"
 #include "WAVEFileWriter.h"
 
 
 
+namespace {
+
+// Maximum number of audio blocks waiting for the output thread.
+const std::size_t OUTPUT_QUEUE_SIZE = 4;
+
+// Parallel synthesis (seconds).
+const double MIN_SEGMENT_DURATION = 2.0;
+const double WARM_UP_DURATION     = 0.05;
+const double CROSSFADE_DURATION   = 0.01;
+
+void
+convertSampleRate(const std::vector<float>& input, double inputRate, double outputRate, std::vector<float>& output)
+{
+	output.clear();
+	output.reserve(static_cast<std::size_t>(input.size() * (outputRate / inputRate)) + 1U);
+
+	// When downsampling, the gain of the converter is inputRate / outputRate.
+	const float gain = (outputRate < inputRate) ? static_cast<float>(outputRate / inputRate) : 1.0f;
+
+	GS::VTM::SampleRateConverter<double> srConv(inputRate, outputRate, [&](float sample) {
+		output.push_back(sample * gain);
+	});
+	for (float sample : input) {
+		srConv.dataFill(sample);
+	}
+	srConv.flushBuffer();
+}
+
+} /* namespace */
+
 namespace GS {
 namespace VTMControlModel {
 
-Controller::Controller(const Index& index, Model& model)
+Controller::Controller(const Index& index, const Model& model)
 		: index_(index)
 		, model_(model)
 		, eventList_(index, model_)
 		, vtmControlModelConfig_(index)
 		, outputScale_(1.0)
+		, debugEnabled_(Log::debugEnabled)
+		, draftMode_()
+		, outputNormalization_(true)
+		, synthesisThreads_()
+		, outputFileFormat_(WAVEFileWriter::Format::pcm16)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	// Load VTM configuration.
 	vtmConfigData_ = std::make_unique<ConfigurationData>(index.entry("vtm_file"));
 	vtmConfigData_->insert(*vtmControlModelConfig_.variantData);
@@ -54,6 +97,81 @@ Controller::Controller(const Index& index, Model& model)
 	eventList_.setControlPeriod(vtmControlModelConfig_.controlPeriod);
 }
 
+void
+Controller::setDraftMode(bool enabled)
+{
+	if (enabled == draftMode_) return;
+
+	Log::DebugScope logScope{debugEnabled_};
+
+	vtm_ = VTM::VocalTractModel::getInstance(*vtmConfigData_, false, enabled);
+	workerVTMList_.clear();
+	draftMode_ = enabled;
+}
+
+void
+Controller::setOutputThreadEnabled(bool enabled)
+{
+	if (enabled == outputThreadEnabled()) return;
+
+	if (enabled) {
+		outputThread_ = std::make_unique<AudioWriterThread>(OUTPUT_QUEUE_SIZE);
+	} else {
+		auto outputThread = std::move(outputThread_);
+		outputThread->wait();
+	}
+}
+
+void
+Controller::waitForOutput()
+{
+	if (outputThread_) outputThread_->wait();
+}
+
+void
+Controller::setRuleCacheEnabled(bool enabled)
+{
+	ruleCache_.enabled = enabled;
+	ruleCache_.valid = false;
+	ruleCache_.phoneticString.clear();
+	ruleCache_.chunkList.clear();
+}
+
+void
+Controller::setVocalTractLength(double vocalTractLength, double temperature)
+{
+	Log::DebugScope logScope{debugEnabled_};
+
+	vtmConfigData_->put("vocal_tract_length", vocalTractLength);
+	vtmConfigData_->put("temperature", temperature);
+
+	try {
+		vtm_->setTubeLengthAndTemperature(
+				vtmConfigData_->value<double>("vocal_tract_length_offset") + vocalTractLength,
+				temperature);
+	} catch (const InvalidCallException&) {
+		vtm_ = VTM::VocalTractModel::getInstance(*vtmConfigData_, false, draftMode_);
+	}
+	workerVTMList_.clear();
+}
+
+void
+Controller::setOutputSampleRate(int outputRate)
+{
+	if (outputRate == vtmConfigData_->value<int>("output_rate")) return;
+
+	Log::DebugScope logScope{debugEnabled_};
+
+	vtmConfigData_->put("output_rate", outputRate);
+
+	try {
+		vtm_->setOutputSampleRate(outputRate);
+	} catch (const InvalidCallException&) {
+		vtm_ = VTM::VocalTractModel::getInstance(*vtmConfigData_, false, draftMode_);
+	}
+	workerVTMList_.clear();
+}
+
 void
 Controller::initUtterance()
 {
@@ -61,11 +179,9 @@ Controller::initUtterance()
 	const float vtlOffset = vtmConfigData_->value<float>("vocal_tract_length_offset");
 	const float vocalTractLength = vtmConfigData_->value<float>("vocal_tract_length");
 
-	if (Log::debugEnabled) {
-		printf("tube length: %f\n", vtlOffset + vocalTractLength);
-		printf("variant: %s\n", vtmControlModelConfig_.variantName.c_str());
-		printf("sampling rate: %d\n", outputRate);
-	}
+	LOG_DEBUG("tube length: " << vtlOffset + vocalTractLength);
+	LOG_DEBUG("variant: " << vtmControlModelConfig_.variantName);
+	LOG_DEBUG("sampling rate: " << outputRate);
 
 	eventList_.setInitialPitch(vtmControlModelConfig_.initialPitch);
 	eventList_.setMeanPitch(vtmControlModelConfig_.pitchOffset + vtmConfigData_->value<double>("reference_glottal_pitch"));
@@ -79,6 +195,7 @@ Controller::initUtterance()
 	eventList_.setIntonationDrift( vtmControlModelConfig_.intonationDrift);
 	eventList_.setRandomIntonation(vtmControlModelConfig_.randomIntonation);
 	eventList_.setIntonationFactor(vtmControlModelConfig_.intonationFactor);
+	eventList_.setRandomSeed(vtmControlModelConfig_.randomSeed);
 }
 
 bool
@@ -119,6 +236,7 @@ void
 Controller::getParametersFromPhoneticString(const std::string& phoneticString)
 {
 	vtmParamList_.clear();
+	chunkEndList_.clear();
 	initUtterance();
 
 	if (vtmControlModelConfig_.phoStrFormat == PhoneticStringFormat::mbrola) {
@@ -134,6 +252,23 @@ Controller::getParametersFromPhoneticString(const std::string& phoneticString)
 		pho1Parser_->parse(phoneticString);
 		eventList_.generateOutput(vtmParamList_);
 	} else {
+		if (ruleCache_.enabled) {
+			if (ruleCache_.valid &&
+					ruleCache_.tempo == vtmControlModelConfig_.tempo &&
+					ruleCache_.phoneticString == phoneticString) {
+				LOG_DEBUG("Using the rule cache.");
+				for (const auto& chunkData : ruleCache_.chunkList) {
+					eventList_.restoreSegmentalData(chunkData);
+					eventList_.applyIntonation();
+					eventList_.generateOutput(vtmParamList_);
+					chunkEndList_.push_back(vtmParamList_.size());
+				}
+				return;
+			}
+			ruleCache_.valid = false;
+			ruleCache_.chunkList.clear();
+		}
+
 		if (!phoneticStringParser_) {
 			phoneticStringParser_ = std::make_unique<PhoneticStringParser>(index_, model_, eventList_);
 		}
@@ -146,12 +281,23 @@ Controller::getParametersFromPhoneticString(const std::string& phoneticString)
 				phoneticStringParser_->parse(&phoneticString[index], size);
 
 				eventList_.generateEventList();
+				if (ruleCache_.enabled) {
+					ruleCache_.chunkList.emplace_back();
+					eventList_.saveSegmentalData(ruleCache_.chunkList.back());
+				}
 				eventList_.applyIntonation();
 				eventList_.generateOutput(vtmParamList_);
+				chunkEndList_.push_back(vtmParamList_.size());
 			}
 
 			index += size;
 		}
+
+		if (ruleCache_.enabled) {
+			ruleCache_.phoneticString = phoneticString;
+			ruleCache_.tempo = vtmControlModelConfig_.tempo;
+			ruleCache_.valid = true;
+		}
 	}
 }
 
@@ -159,6 +305,7 @@ void
 Controller::getParametersFromEventList()
 {
 	vtmParamList_.clear();
+	chunkEndList_.clear();
 
 	initUtterance();
 
@@ -171,6 +318,7 @@ void
 Controller::getParametersFromStream(std::istream& in)
 {
 	vtmParamList_.clear();
+	chunkEndList_.clear();
 	std::string line;
 	const std::size_t numParam = model_.parameterList().size();
 	std::vector<float> param(numParam);
@@ -194,6 +342,8 @@ Controller::getParametersFromStream(std::istream& in)
 void
 Controller::synthesizePhoneticStringToFile(const std::string& phoneticString, const char* vtmParamFile, const char* outputFile)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	getParametersFromPhoneticString(phoneticString);
 	if (vtmParamFile) writeVTMParameterFile(vtmParamList_, vtmParamFile);
 	synthesizeToFile(outputFile);
@@ -202,14 +352,118 @@ Controller::synthesizePhoneticStringToFile(const std::string& phoneticString, co
 void
 Controller::synthesizePhoneticStringToBuffer(const std::string& phoneticString, const char* vtmParamFile, std::vector<float>& buffer)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	getParametersFromPhoneticString(phoneticString);
 	if (vtmParamFile) writeVTMParameterFile(vtmParamList_, vtmParamFile);
 	synthesizeToBuffer(buffer);
 }
 
+void
+Controller::synthesizePhoneticStringByChunk(const std::string& phoneticString,
+						const std::function<void(const std::vector<float>& buffer)>& chunkOutput)
+{
+	Log::DebugScope logScope{debugEnabled_};
+
+	std::vector<float> buffer;
+	auto output = [&]() {
+		if (outputThread_) {
+			outputThread_->write(std::move(buffer), chunkOutput);
+		} else {
+			chunkOutput(buffer);
+		}
+	};
+
+	// The MBROLA format does not have chunks.
+	if (vtmControlModelConfig_.phoStrFormat == PhoneticStringFormat::mbrola) {
+		getParametersFromPhoneticString(phoneticString);
+		synthesizeToBuffer(buffer);
+		output();
+		return;
+	}
+
+	std::size_t index = 0, size = 0;
+	while (index < phoneticString.size()) {
+		if (nextChunk(phoneticString, index, size)) {
+			getParametersFromPhoneticString(phoneticString.substr(index, size));
+			synthesizeToBuffer(buffer);
+			output();
+		}
+
+		index += size;
+	}
+}
+
+void
+Controller::synthesizePhoneticStringToRates(const std::string& phoneticString, const char* vtmParamFile,
+						const std::vector<RateOutput>& outputList)
+{
+	Log::DebugScope logScope{debugEnabled_};
+
+	for (const auto& rateOutput : outputList) {
+		if (rateOutput.sampleRate <= 0) {
+			THROW_EXCEPTION(InvalidParameterException, "Invalid output sample rate: " << rateOutput.sampleRate << '.');
+		}
+	}
+
+	getParametersFromPhoneticString(phoneticString);
+	if (vtmParamFile) writeVTMParameterFile(vtmParamList_, vtmParamFile);
+
+	std::vector<float> parallelAudioData;
+	const std::vector<float>* audioData = &parallelAudioData;
+	if (!synthesizeInParallel(parallelAudioData)) {
+		if (!vtm_->outputBuffer().empty()) vtm_->reset();
+		synthesize(vtmParamList_);
+		vtm_->finishSynthesis();
+		audioData = &vtm_->outputBuffer();
+	}
+
+	const double inputRate = vtm_->outputSampleRate();
+	std::vector<float> convertedAudioData;
+	for (const auto& rateOutput : outputList) {
+		std::vector<float> buffer;
+		float scale;
+		if (rateOutput.sampleRate == inputRate) {
+			writeOutputToBuffer(*audioData, buffer, scale);
+		} else {
+			convertSampleRate(*audioData, inputRate, rateOutput.sampleRate, convertedAudioData);
+			writeOutputToBuffer(convertedAudioData, buffer, scale);
+		}
+		LOG_DEBUG("output sample rate: " << rateOutput.sampleRate << " scale: " << scale);
+
+		if (outputThread_) {
+			outputThread_->write(std::move(buffer), rateOutput.output);
+		} else {
+			rateOutput.output(buffer);
+		}
+	}
+}
+
+void
+Controller::splitPhoneticString(const std::string& phoneticString, std::vector<std::string>& chunkList)
+{
+	chunkList.clear();
+
+	if (vtmControlModelConfig_.phoStrFormat == PhoneticStringFormat::mbrola) {
+		chunkList.push_back(phoneticString);
+		return;
+	}
+
+	std::size_t index = 0, size = 0;
+	while (index < phoneticString.size()) {
+		if (nextChunk(phoneticString, index, size)) {
+			chunkList.push_back(phoneticString.substr(index, size));
+		}
+
+		index += size;
+	}
+}
+
 void
 Controller::synthesizeFromEventListToFile(const char* vtmParamFile, const char* outputFile)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	getParametersFromEventList();
 	if (vtmParamFile) writeVTMParameterFile(vtmParamList_, vtmParamFile);
 	synthesizeToFile(outputFile);
@@ -218,6 +472,8 @@ Controller::synthesizeFromEventListToFile(const char* vtmParamFile, const char*
 void
 Controller::synthesizeFromEventListToBuffer(const char* vtmParamFile, std::vector<float>& buffer)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	getParametersFromEventList();
 	if (vtmParamFile) writeVTMParameterFile(vtmParamList_, vtmParamFile);
 	synthesizeToBuffer(buffer);
@@ -228,48 +484,66 @@ Controller::synthesizeToFile(const char* outputFile)
 {
 	if (!outputFile) return;
 
+	std::vector<float> audioData;
+	if (synthesizeInParallel(audioData)) {
+		writeOutputToFile(audioData, outputFile, outputScale_);
+		return;
+	}
+
 	if (!vtm_->outputBuffer().empty()) vtm_->reset();
 	synthesize(vtmParamList_);
 	vtm_->finishSynthesis();
-	writeOutputToFile(outputFile, outputScale_);
+	writeOutputToFile(vtm_->outputBuffer(), outputFile, outputScale_);
 }
 
 void
 Controller::synthesizeToFile(std::vector<std::vector<float>>& vtmParamList, const char* vtmParamFile, const char* outputFile)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	if (vtmParamFile) writeVTMParameterFile(vtmParamList, vtmParamFile);
 
 	if (!vtm_->outputBuffer().empty()) vtm_->reset();
 	synthesize(vtmParamList);
 	vtm_->finishSynthesis();
 	float scale;
-	writeOutputToFile(outputFile, scale);
+	writeOutputToFile(vtm_->outputBuffer(), outputFile, scale);
 }
 
 void
 Controller::synthesizeToBuffer(std::vector<float>& outputBuffer)
 {
+	std::vector<float> audioData;
+	if (synthesizeInParallel(audioData)) {
+		writeOutputToBuffer(audioData, outputBuffer, outputScale_);
+		return;
+	}
+
 	if (!vtm_->outputBuffer().empty()) vtm_->reset();
 	synthesize(vtmParamList_);
 	vtm_->finishSynthesis();
-	writeOutputToBuffer(outputBuffer, outputScale_);
+	writeOutputToBuffer(vtm_->outputBuffer(), outputBuffer, outputScale_);
 }
 
 void
 Controller::synthesizeToBuffer(std::vector<std::vector<float>>& vtmParamList, const char* vtmParamFile, std::vector<float>& outputBuffer)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	if (vtmParamFile) writeVTMParameterFile(vtmParamList, vtmParamFile);
 
 	if (!vtm_->outputBuffer().empty()) vtm_->reset();
 	synthesize(vtmParamList);
 	vtm_->finishSynthesis();
 	float scale;
-	writeOutputToBuffer(outputBuffer, scale);
+	writeOutputToBuffer(vtm_->outputBuffer(), outputBuffer, scale);
 }
 
 void
 Controller::synthesizeToFile(std::istream& inputStream, const char* outputFile)
 {
+	Log::DebugScope logScope{debugEnabled_};
+
 	getParametersFromStream(inputStream);
 	synthesizeToFile(outputFile);
 }
@@ -282,16 +556,26 @@ Controller::synthesize(std::vector<std::vector<float>>& vtmParamList)
 	// Duplicate the last set of parameters, to help the interpolation.
 	vtmParamList.push_back(vtmParamList.back());
 
+	synthesize(*vtm_, vtmParamList, 0, vtmParamList.size() - 1);
+}
+
+void
+Controller::synthesize(VTM::VocalTractModel& vtm, const std::vector<std::vector<float>>& vtmParamList,
+			std::size_t firstPeriod, std::size_t lastPeriod) const
+{
 	// Number of internal sample rate periods in each control rate period.
-	const unsigned int controlSteps = static_cast<unsigned int>(std::rint(vtm_->internalSampleRate() / vtmControlModelConfig_.controlRate));
+	const unsigned int controlSteps = static_cast<unsigned int>(std::rint(vtm.internalSampleRate() / vtmControlModelConfig_.controlRate));
 	const float coef = 1.0f / controlSteps;
 
 	const std::size_t numParam = model_.parameterList().size();
 	std::vector<float> currentParameter(numParam);
 	std::vector<float> currentParameterDelta(numParam);
 
+	// Parameters for each step in a control period.
+	std::vector<float> frames(controlSteps * numParam);
+
 	// For each control period:
-	for (std::size_t i = 1, size = vtmParamList.size(); i < size; ++i) {
+	for (std::size_t i = firstPeriod + 1; i <= lastPeriod; ++i) {
 		// Calculates the current parameter values, and their
 		// associated sample-to-sample delta values.
 		for (std::size_t j = 0; j < numParam; ++j) {
@@ -301,36 +585,176 @@ Controller::synthesize(std::vector<std::vector<float>>& vtmParamList)
 
 		// For each step in a control period:
 		for (std::size_t j = 0; j < controlSteps; ++j) {
-			vtm_->setAllParameters(currentParameter);
-			vtm_->execSynthesisStep();
+			std::copy(currentParameter.begin(), currentParameter.end(), frames.begin() + j * numParam);
 
 			// Do linear interpolation.
 			for (std::size_t k = 0; k < numParam; ++k) {
 				currentParameter[k] += currentParameterDelta[k];
 			}
 		}
+
+		// The steps are sent in one block, so the plugins cross
+		// the library boundary once per control period.
+		vtm.execSynthesisSteps(frames.data(), controlSteps, numParam);
 	}
 }
 
+// Each segment is synthesized from a reset state. The segments after the
+// first are primed with the last WARM_UP_DURATION seconds of the previous
+// segment (the output of this part is discarded). The segments before the
+// last continue for CROSSFADE_DURATION seconds, and this part is mixed
+// with the start of the next segment.
+// The segments are defined by the chunk boundaries and the durations,
+// so the result is the same with any number of threads.
+// The sample rate converter sends the output in blocks, so the positions
+// in the output are calculated from the number of control periods.
+bool
+Controller::synthesizeInParallel(std::vector<float>& audioData)
+{
+	if (synthesisThreads_ <= 1 || chunkEndList_.size() <= 1) return false;
+	if (vtmConfigData_->contains("log_parameters") && vtmConfigData_->value<bool>("log_parameters")) return false;
+
+	const double controlRate = vtmControlModelConfig_.controlRate;
+	const std::size_t minSegmentPeriods = static_cast<std::size_t>(std::rint(MIN_SEGMENT_DURATION * controlRate));
+	const std::size_t warmUpPeriods     = static_cast<std::size_t>(std::rint(WARM_UP_DURATION     * controlRate));
+	const std::size_t crossfadePeriods  = static_cast<std::size_t>(std::rint(CROSSFADE_DURATION   * controlRate));
+
+	// Split at the chunk boundaries.
+	const std::size_t numPeriods = vtmParamList_.size();
+	std::vector<std::size_t> segmentStartList{0};
+	for (std::size_t chunkEnd : chunkEndList_) {
+		if (chunkEnd - segmentStartList.back() >= minSegmentPeriods && numPeriods - chunkEnd >= minSegmentPeriods) {
+			segmentStartList.push_back(chunkEnd);
+		}
+	}
+	const std::size_t numSegments = segmentStartList.size();
+	if (numSegments <= 1) return false;
+	segmentStartList.push_back(numPeriods);
+
+	const std::size_t numWorkers = std::min<std::size_t>(synthesisThreads_, numSegments);
+	while (workerVTMList_.size() < numWorkers - 1) {
+		workerVTMList_.push_back(VTM::VocalTractModel::getInstance(*vtmConfigData_, false, draftMode_));
+	}
+
+	LOG_DEBUG("parallel synthesis: " << numSegments << " segments, " << numWorkers << " threads");
+
+	const unsigned int controlSteps = static_cast<unsigned int>(std::rint(vtm_->internalSampleRate() / controlRate));
+	const double samplesPerPeriod = controlSteps * vtm_->outputSampleRate() / vtm_->internalSampleRate();
+	auto outputPosition = [&](std::size_t period) {
+		return static_cast<std::size_t>(std::rint(period * samplesPerPeriod));
+	};
+
+	// Duplicate the last set of parameters, to help the interpolation.
+	vtmParamList_.push_back(vtmParamList_.back());
+
+	struct Segment {
+		std::vector<float> audio;
+		std::size_t begin; // start of the segment, after the warm-up
+		std::size_t end;   // end of the segment, before the crossfade
+	};
+	std::vector<Segment> segmentList(numSegments);
+
+	auto synthesizeSegment = [&](VTM::VocalTractModel& vtm, std::size_t n) {
+		Segment& segment = segmentList[n];
+		const std::size_t firstPeriod = segmentStartList[n];
+		const std::size_t lastPeriod  = segmentStartList[n + 1];
+
+		const bool lastSegment = (n == numSegments - 1);
+		const std::size_t startPeriod = (n > 0) ? firstPeriod - warmUpPeriods : firstPeriod;
+		const std::size_t endPeriod = lastSegment ? lastPeriod : lastPeriod + crossfadePeriods;
+
+		vtm.reset();
+		synthesize(vtm, vtmParamList_, startPeriod, endPeriod);
+		vtm.finishSynthesis();
+		segment.audio = vtm.outputBuffer();
+
+		const std::size_t size = segment.audio.size();
+		segment.begin = std::min(outputPosition(firstPeriod) - outputPosition(startPeriod), size);
+		segment.end = lastSegment ? size : std::min(outputPosition(lastPeriod) - outputPosition(startPeriod), size);
+	};
+
+	std::atomic<std::size_t> nextSegment{0};
+	std::vector<std::exception_ptr> errorList(numWorkers);
+	auto work = [&](VTM::VocalTractModel& vtm, std::exception_ptr& error) {
+		try {
+			for (std::size_t n = nextSegment++; n < numSegments; n = nextSegment++) {
+				synthesizeSegment(vtm, n);
+			}
+		} catch (...) {
+			error = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threadList;
+	try {
+		for (std::size_t i = 1; i < numWorkers; ++i) {
+			threadList.emplace_back(work, std::ref(*workerVTMList_[i - 1]), std::ref(errorList[i]));
+		}
+	} catch (const std::system_error&) {
+		// Continue with the threads that have been created.
+	}
+	work(*vtm_, errorList[0]);
+	for (auto& t : threadList) {
+		t.join();
+	}
+	for (auto& error : errorList) {
+		if (error) std::rethrow_exception(error);
+	}
+
+	// Join the segments.
+	audioData.clear();
+	for (std::size_t n = 0; n < numSegments; ++n) {
+		const Segment& segment = segmentList[n];
+		std::size_t pos = segment.begin;
+		if (n > 0) {
+			const Segment& prevSegment = segmentList[n - 1];
+			const std::size_t fadeSize = std::min(prevSegment.audio.size() - prevSegment.end, segment.end - segment.begin);
+			for (std::size_t i = 0; i < fadeSize; ++i) {
+				const float k = (i + 0.5f) / fadeSize;
+				audioData.push_back(prevSegment.audio[prevSegment.end + i] * (1.0f - k) + segment.audio[pos + i] * k);
+			}
+			pos += fadeSize;
+		}
+		audioData.insert(audioData.end(), segment.audio.begin() + pos, segment.audio.begin() + segment.end);
+	}
+
+	return true;
+}
+
 void
-Controller::writeOutputToFile(const char* outputFile, float& scale)
+Controller::writeOutputToFile(const std::vector<float>& audioData, const char* outputFile, float& scale)
 {
 	if (!outputFile) {
 		THROW_EXCEPTION(MissingValueException, "Missing output file name.");
 	}
-	const std::vector<float>& audioData = vtm_->outputBuffer();
-	WAVEFileWriter fileWriter(outputFile, 1, audioData.size(), vtm_->outputSampleRate());
-
-	scale = VTM::Util::calculateOutputScale(audioData);
-	for (std::size_t i = 0, end = audioData.size(); i < end; ++i) {
-		fileWriter.writeSample(audioData[i] * scale);
+	scale = outputNormalization_ ? VTM::Util::calculateOutputScale(audioData) : 1.0f;
+
+	if (outputThread_) {
+		const std::string filePath{outputFile};
+		const float outputRate = vtm_->outputSampleRate();
+		const WAVEFileWriter::Format format = outputFileFormat_;
+		const float gain = scale;
+		outputThread_->write(audioData, [filePath, outputRate, format, gain](const std::vector<float>& block) {
+			WAVEFileWriter fileWriter(filePath.c_str(), 1, outputRate, format);
+			fileWriter.writeSamples(block.data(), block.size(), gain);
+			fileWriter.close();
+		});
+		return;
 	}
+
+	WAVEFileWriter fileWriter(outputFile, 1, vtm_->outputSampleRate(), outputFileFormat_);
+	fileWriter.writeSamples(audioData.data(), audioData.size(), scale);
+	fileWriter.close();
 }
 
 void
-Controller::writeOutputToBuffer(std::vector<float>& outputBuffer, float& scale)
+Controller::writeOutputToBuffer(const std::vector<float>& audioData, std::vector<float>& outputBuffer, float& scale)
 {
-	const std::vector<float>& audioData = vtm_->outputBuffer();
+	if (!outputNormalization_) {
+		outputBuffer = audioData;
+		scale = 1.0f;
+		return;
+	}
 	outputBuffer.resize(audioData.size());
 
 	scale = VTM::Util::calculateOutputScale(audioData);
@@ -22,11 +22,13 @@
 #define VTM_CONTROL_MODEL_CONTROLLER_H_
 
 #include <cstddef> /* std::size_t */
+#include <functional>
 #include <istream>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "AudioWriterThread.h"
 #include "ConfigurationData.h"
 #include "EventList.h"
 #include "Model.h"
@@ -34,6 +36,7 @@
 #include "PhoneticStringParser.h"
 #include "VocalTractModel.h"
 #include "VTMControlModelConfiguration.h"
+#include "WAVEFileWriter.h"
 
 
 
@@ -45,7 +48,13 @@ namespace VTMControlModel {
 
 class Controller {
 public:
-	Controller(const Index& index, Model& model);
+	// Output of synthesizePhoneticStringToRates.
+	struct RateOutput {
+		int sampleRate;
+		std::function<void(const std::vector<float>& buffer)> output;
+	};
+
+	Controller(const Index& index, const Model& model);
 	~Controller() = default;
 
 	Configuration& vtmControlModelConfiguration() { return vtmControlModelConfig_; }
@@ -56,10 +65,98 @@ public:
 	float outputScale() const { return outputScale_; }
 	double vtmInternalSampleRate() const { return vtm_->internalSampleRate(); }
 
+	// Debug messages of this controller.
+	// The default value is the value of Log::debugEnabled in the thread that created the object.
+	bool debugEnabled() const { return debugEnabled_; }
+	void setDebugEnabled(bool enabled) { debugEnabled_ = enabled; }
+
+	// Draft mode: faster synthesis with lower quality, for previews (see VTM::VocalTractModel::getInstance).
+	// It is applied to the next synthesis.
+	bool draftMode() const { return draftMode_; }
+	void setDraftMode(bool enabled);
+
+	// Changes the vocal tract length (cm, without the offset) and the
+	// temperature (degrees Celsius) of the voice. If the vocal tract model
+	// supports it, the existing instance is updated, otherwise it is recreated.
+	// It is applied to the next synthesis.
+	void setVocalTractLength(double vocalTractLength, double temperature);
+
+	// Changes the output sample rate (Hz). If the vocal tract model
+	// supports it, the existing instance is updated, otherwise it is recreated.
+	// It is applied to the next synthesis.
+	void setOutputSampleRate(int outputRate);
+
+	// Sample format of the WAVE files.
+	WAVEFileWriter::Format outputFileFormat() const { return outputFileFormat_; }
+	void setOutputFileFormat(WAVEFileWriter::Format format) { outputFileFormat_ = format; }
+
+	// Output normalization: each utterance is scaled so that its peak
+	// reaches the maximum output level. If disabled, the output of the
+	// vocal tract model is used without scaling (outputScale() returns 1.0).
+	// The range of the samples depends on the model, so this is intended
+	// for the float WAVE format (the integer formats clip at [-1.0, 1.0]).
+	bool outputNormalization() const { return outputNormalization_; }
+	void setOutputNormalization(bool enabled) { outputNormalization_ = enabled; }
+
+	// Output thread: the audio files (and the chunks of
+	// synthesizePhoneticStringByChunk) are written in a separate thread,
+	// while the synthesis continues. An output error is reported by the
+	// next synthesis that sends audio to the thread, or by waitForOutput().
+	bool outputThreadEnabled() const { return outputThread_ != nullptr; }
+	void setOutputThreadEnabled(bool enabled);
+	// Waits until all the audio has been written.
+	void waitForOutput();
+
+	// Parallel synthesis: the utterances of synthesizePhoneticStringToFile
+	// and synthesizePhoneticStringToBuffer are split at chunk boundaries in
+	// segments of at least a few seconds, and the segments are synthesized
+	// by numThreads vocal tract model instances at the same time.
+	// Each instance is primed with the end of the previous segment, and
+	// the segments are joined with a short crossfade. The result does
+	// not depend on the number of threads, but it is not equal to the
+	// result of the sequential synthesis.
+	// 0 or 1: sequential synthesis (default).
+	// The parallel synthesis is not used if the vocal tract model logs
+	// its parameters (log_parameters in vtm.txt).
+	unsigned int synthesisThreads() const { return synthesisThreads_; }
+	void setSynthesisThreads(unsigned int numThreads) { synthesisThreads_ = numThreads; }
+
+	// Rule cache: the result of the rule application for the last phonetic
+	// string is kept. If the same phonetic string is synthesized again with
+	// the same tempo, only the intonation, the generation of the parameters
+	// and the vocal tract model are executed. The other settings of
+	// Configuration (pitch offset, drift, intonation flags and factor,
+	// random seed, etc.) can be changed between the syntheses.
+	// The result is equal to the result without the cache.
+	// The MBROLA format is not cached.
+	bool ruleCacheEnabled() const { return ruleCache_.enabled; }
+	void setRuleCacheEnabled(bool enabled);
+
 	// If vtmParamFile is not null, the VTM parameters will be written to a file.
 	void synthesizePhoneticStringToFile(const std::string& phoneticString, const char* vtmParamFile, const char* outputFile);
 	// If vtmParamFile is not null, the VTM parameters will be written to a file.
 	void synthesizePhoneticStringToBuffer(const std::string& phoneticString, const char* vtmParamFile, std::vector<float>& buffer);
+	// Synthesizes each chunk of the phonetic string as a separate utterance,
+	// and sends its audio to chunkOutput as soon as it is ready.
+	// Each chunk is normalized separately.
+	// If the output thread is enabled, chunkOutput is called in that thread.
+	void synthesizePhoneticStringByChunk(const std::string& phoneticString,
+						const std::function<void(const std::vector<float>& buffer)>& chunkOutput);
+
+	// Synthesizes the phonetic string once, and sends the audio to each
+	// output, converted from the output sample rate of the vocal tract
+	// model (output_rate in vtm.txt) to the sample rate of the output.
+	// The conversion is cheap compared to the synthesis. To avoid
+	// upsampling, output_rate should be the highest of the rates.
+	// Each output is normalized separately.
+	// If vtmParamFile is not null, the VTM parameters will be written to a file.
+	// If the output thread is enabled, the outputs are called in that thread.
+	void synthesizePhoneticStringToRates(const std::string& phoneticString, const char* vtmParamFile,
+						const std::vector<RateOutput>& outputList);
+
+	// Splits the phonetic string in chunks, which can be synthesized separately.
+	// The MBROLA format does not have chunks.
+	void splitPhoneticString(const std::string& phoneticString, std::vector<std::string>& chunkList);
 
 	// If vtmParamFile is not null, the VTM parameters will be written to a file.
 	void synthesizePho1ToFile(const std::string& phoneticString, const char* phonemeMapFile, const char* vtmParamFile, const char* outputFile);
@@ -84,6 +181,15 @@ private:
 	Controller(Controller&&) = delete;
 	Controller& operator=(Controller&&) = delete;
 
+	struct RuleCache {
+		bool enabled;
+		bool valid;
+		std::string phoneticString;
+		double tempo;
+		std::vector<SegmentalData> chunkList;
+		RuleCache() : enabled(), valid(), tempo() {}
+	};
+
 	void initUtterance();
 
 	// Chunks start with /c.
@@ -97,14 +203,20 @@ private:
 	void getParametersFromEventList();
 	void getParametersFromStream(std::istream& in);
 	void synthesize(std::vector<std::vector<float>>& vtmParamList);
+	// Synthesizes the control periods [firstPeriod, lastPeriod).
+	// vtmParamList must contain the parameters for lastPeriod.
+	void synthesize(VTM::VocalTractModel& vtm, const std::vector<std::vector<float>>& vtmParamList,
+				std::size_t firstPeriod, std::size_t lastPeriod) const;
+	// Returns false if the utterance can not be split in segments.
+	bool synthesizeInParallel(std::vector<float>& audioData);
 	void synthesizeToFile(const char* outputFile);
 	void synthesizeToBuffer(std::vector<float>& outputBuffer);
-	void writeOutputToFile(const char* outputFile, float& scale);
-	void writeOutputToBuffer(std::vector<float>& outputBuffer, float& scale);
+	void writeOutputToFile(const std::vector<float>& audioData, const char* outputFile, float& scale);
+	void writeOutputToBuffer(const std::vector<float>& audioData, std::vector<float>& outputBuffer, float& scale);
 	void writeVTMParameterFile(const std::vector<std::vector<float>>& vtmParamList, const char* vtmParamFile);
 
 	const Index& index_;
-	Model& model_;
+	const Model& model_;
 	EventList eventList_;
 	std::unique_ptr<PhoneticStringParser> phoneticStringParser_;
 	std::unique_ptr<Pho1Parser> pho1Parser_;
@@ -112,7 +224,16 @@ private:
 	std::unique_ptr<ConfigurationData> vtmConfigData_;
 	std::unique_ptr<VTM::VocalTractModel> vtm_;
 	std::vector<std::vector<float>> vtmParamList_;
+	std::vector<std::size_t> chunkEndList_; // indexes in vtmParamList_
+	std::vector<std::unique_ptr<VTM::VocalTractModel>> workerVTMList_; // for the parallel synthesis
+	RuleCache ruleCache_;
 	float outputScale_;
+	bool debugEnabled_;
+	bool draftMode_;
+	bool outputNormalization_;
+	unsigned int synthesisThreads_;
+	WAVEFileWriter::Format outputFileFormat_;
+	std::unique_ptr<AudioWriterThread> outputThread_;
 };
 
 } /* namespace VTMControlModel */
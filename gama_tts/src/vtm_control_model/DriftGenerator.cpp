@@ -62,6 +62,13 @@ DriftGenerator::setUp(double deviation, double sampleRate, double lowpassCutoff)
 	filter_.update(sampleRate, lowpassCutoff);
 }
 
+void
+DriftGenerator::reset()
+{
+	seed_ = INITIAL_SEED;
+	filter_.reset();
+}
+
 /******************************************************************************
 *
 *	function:	drift
@@ -34,6 +34,8 @@ public:
 	~DriftGenerator() = default;
 
 	void setUp(double deviation, double sampleRate, double lowpassCutoff);
+	// Restores the initial state of the noise generator and the filter.
+	void reset();
 	double drift();
 private:
 	DriftGenerator(const DriftGenerator&) = delete;
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "EvaluationContext.h"
+
+#include "Exception.h"
+
+
+
+namespace GS {
+namespace VTMControlModel {
+
+/*******************************************************************************
+ *
+ */
+void
+EvaluationContext::setDefaultFormulaSymbols(Transition::Type transitionType)
+{
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION1, 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION2, 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION3, 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION4, 33.3333f);
+
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA1      , 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA2      , 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA3      , 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA4      , 33.3333f);
+
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB1      , 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB2      , 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB3      , 33.3333f);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB4      , 33.3333f);
+
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO1, 1.0);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO2, 1.0);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO3, 1.0);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO4, 1.0);
+
+	setFormulaSymbolValue(FormulaSymbol::SYMB_BEAT ,  33.0);
+	setFormulaSymbolValue(FormulaSymbol::SYMB_MARK1, 100.0);
+	switch (transitionType) {
+	case Transition::Type::diphone:
+		setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, 100.0);
+		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        ,   0.0);
+		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        ,   0.0);
+		break;
+	case Transition::Type::triphone:
+		setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, 200.0);
+		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        , 200.0);
+		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        ,   0.0);
+		break;
+	case Transition::Type::tetraphone:
+		setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, 300.0);
+		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        , 200.0);
+		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        , 300.0);
+		break;
+	default:
+		THROW_EXCEPTION(VTMControlModelException, "Invalid transition type: " << static_cast<int>(transitionType) << '.');
+	}
+}
+
+} /* namespace VTMControlModel */
+} /* namespace GS */
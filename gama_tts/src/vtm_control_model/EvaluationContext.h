@@ -0,0 +1,57 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef VTM_CONTROL_MODEL_EVALUATION_CONTEXT_H_
+#define VTM_CONTROL_MODEL_EVALUATION_CONTEXT_H_
+
+#include "Equation.h"
+#include "FormulaSymbol.h"
+#include "Transition.h"
+
+
+
+namespace GS {
+namespace VTMControlModel {
+
+// Values of the formula symbols, used in the evaluation of the equations.
+// The Model is not modified during the synthesis, so it may be shared by
+// many synthesizers (in different threads). Each synthesizer must have
+// its own EvaluationContext.
+class EvaluationContext {
+public:
+	EvaluationContext() { clearFormulaSymbolList(); }
+	~EvaluationContext() = default;
+
+	void clearFormulaSymbolList() { formulaSymbolList_.fill(0.0f); }
+	void setFormulaSymbolValue(FormulaSymbol::Code symbol, float value) { formulaSymbolList_[symbol] = value; }
+	float getFormulaSymbolValue(FormulaSymbol::Code symbol) const { return formulaSymbolList_[symbol]; }
+	void setDefaultFormulaSymbols(Transition::Type transitionType);
+
+	float evalEquationFormula(const Equation& equation) const { return equation.evalFormula(formulaSymbolList_); }
+private:
+	EvaluationContext(const EvaluationContext&) = delete;
+	EvaluationContext& operator=(const EvaluationContext&) = delete;
+	EvaluationContext(EvaluationContext&&) = delete;
+	EvaluationContext& operator=(EvaluationContext&&) = delete;
+
+	FormulaSymbolList formulaSymbolList_;
+};
+
+} /* namespace VTMControlModel */
+} /* namespace GS */
+
+#endif /* VTM_CONTROL_MODEL_EVALUATION_CONTEXT_H_ */
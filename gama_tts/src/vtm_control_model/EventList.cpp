@@ -21,7 +21,9 @@
 #include "EventList.h"
 
 #include <cassert>
+#include <cstdio> /* snprintf */
 #include <cstring>
+#include <ostream>
 #include <limits> /* std::numeric_limits<double>::infinity() */
 #include <vector>
 
@@ -39,7 +41,7 @@ const double Event::EMPTY_PARAMETER = std::numeric_limits<double>::infinity();
 
 
 
-EventList::EventList(const Index& index, Model& model)
+EventList::EventList(const Index& index, const Model& model)
 		: model_(model)
 		, controlPeriod_(DEFAULT_CONTROL_PERIOD_MS)
 		, macroIntonation_()
@@ -91,6 +93,15 @@ EventList::setUpDriftGenerator(double deviation, double sampleRate, double lowpa
 	driftGenerator_.setUp(deviation, sampleRate, lowpassCutoff);
 }
 
+void
+EventList::setRandomSeed(unsigned long seed)
+{
+	if (seed == 0) return;
+
+	intonationRhythm_.setRandomSeed(seed);
+	driftGenerator_.reset();
+}
+
 const Posture*
 EventList::getPostureAtIndex(unsigned int index) const
 {
@@ -385,17 +396,17 @@ EventList::createSlopeRatioEvents(const Transition::SlopeRatio& slopeRatio,
 
 	double pointTime, pointValue;
 
-	Transition::getPointData(*slopeRatio.pointList.front(), model_, pointTime, pointValue);
+	Transition::getPointData(*slopeRatio.pointList.front(), evalContext_, pointTime, pointValue);
 	const double startValue = pointValue;
 
-	Transition::getPointData(*slopeRatio.pointList.back(), model_, pointTime, pointValue);
+	Transition::getPointData(*slopeRatio.pointList.back(), evalContext_, pointTime, pointValue);
 	const double valueDelta = pointValue - startValue;
 
 	std::vector<double> tempPointValues(numSlopes - 1);
 	double sum = 0.0;
 	for (unsigned int i = 1; i < numPoints; ++i) {
-		const double deltaTime = Transition::getPointTime(*slopeRatio.pointList[i], model_)
-						- Transition::getPointTime(*slopeRatio.pointList[i - 1], model_);
+		const double deltaTime = Transition::getPointTime(*slopeRatio.pointList[i], evalContext_)
+						- Transition::getPointTime(*slopeRatio.pointList[i - 1], evalContext_);
 		const double value = slopeRatio.slopeList[i - 1]->slope * deltaTime;
 		sum += value;
 		if (i < numSlopes) {
@@ -410,11 +421,11 @@ EventList::createSlopeRatioEvents(const Transition::SlopeRatio& slopeRatio,
 		const Transition::Point& point = *slopeRatio.pointList[i];
 
 		if (i >= 1 && i < numPoints - 1) {
-			pointTime = Transition::getPointTime(point, model_);
+			pointTime = Transition::getPointTime(point, evalContext_);
 			pointValue = baseValue + tempPointValues[i - 1] * factor;
 			baseValue = pointValue;
 		} else { // the first and the last points
-			Transition::getPointData(point, model_, pointTime, pointValue);
+			Transition::getPointData(point, evalContext_, pointTime, pointValue);
 		}
 
 		value = baseline + ((pointValue / 100.0) * parameterDelta);
@@ -440,7 +451,7 @@ EventList::applyRule(const Rule& rule, const std::vector<RuleExpressionData>& ru
 	const unsigned int numParam = model_.parameterList().size();
 
 	double ruleSymbols[Rule::NUM_SYMBOLS];
-	rule.evaluateExpressionSymbols(ruleExpressionData, model_, ruleSymbols);
+	rule.evaluateExpressionSymbols(ruleExpressionData, evalContext_, ruleSymbols);
 
 	const double timeMultiplier = 1.0 / postureData_[basePostureIndex].ruleTempo;
 	if (timeMultiplier != 1.0) {
@@ -592,7 +603,7 @@ EventList::applyRule(const Rule& rule, const std::vector<RuleExpressionData>& ru
 						currentValueDelta = targets[static_cast<int>(currentType) - 1] - lastValue;
 					}
 					double pointTime;
-					Transition::getPointData(point, model_,
+					Transition::getPointData(point, evalContext_,
 									targets[static_cast<int>(currentType) - 2], currentValueDelta, minParam[i], maxParam[i],
 									pointTime, value);
 					if (!last) { // not a "phantom" point
@@ -613,7 +624,7 @@ EventList::applyRule(const Rule& rule, const std::vector<RuleExpressionData>& ru
 				const auto& point = dynamic_cast<const Transition::Point&>(pointOrSlope);
 
 				/* calculate time of event */
-				const double time = Transition::getPointTime(point, model_);
+				const double time = Transition::getPointTime(point, evalContext_);
 
 				/* Calculate value of event */
 				const double value = ((point.value / 100.0) * (maxParam[i] - minParam[i]));
@@ -675,6 +686,61 @@ EventList::generateEventList()
 	}
 }
 
+void
+EventList::saveSegmentalData(SegmentalData& data) const
+{
+	data.zeroRef          = zeroRef_;
+	data.zeroIndex        = zeroIndex_;
+	data.duration         = duration_;
+	data.postureData      = postureData_;
+	data.currentPosture   = currentPosture_;
+	data.feet             = feet_;
+	data.currentFoot      = currentFoot_;
+	data.toneGroups       = toneGroups_;
+	data.currentToneGroup = currentToneGroup_;
+	data.ruleData         = ruleData_;
+	data.currentRule      = currentRule_;
+
+	data.eventList.resize(list_.size());
+	for (std::size_t i = 0, size = list_.size(); i < size; ++i) {
+		const Event& event = *list_[i];
+		SegmentalData::EventData& eventData = data.eventList[i];
+		eventData.parameters        = event.parameters;
+		eventData.specialParameters = event.specialParameters;
+		eventData.time              = event.time;
+		eventData.flag              = event.flag;
+	}
+}
+
+void
+EventList::restoreSegmentalData(const SegmentalData& data)
+{
+	zeroRef_          = data.zeroRef;
+	zeroIndex_        = data.zeroIndex;
+	duration_         = data.duration;
+	postureData_      = data.postureData;
+	currentPosture_   = data.currentPosture;
+	feet_             = data.feet;
+	currentFoot_      = data.currentFoot;
+	toneGroups_       = data.toneGroups;
+	currentToneGroup_ = data.currentToneGroup;
+	ruleData_         = data.ruleData;
+	currentRule_      = data.currentRule;
+
+	intonationPoints_.clear();
+
+	const unsigned int numParam = model_.parameterList().size();
+	list_.clear();
+	for (const auto& eventData : data.eventList) {
+		auto event = std::make_unique<Event>(numParam);
+		event->parameters        = eventData.parameters;
+		event->specialParameters = eventData.specialParameters;
+		event->time              = eventData.time;
+		event->flag              = eventData.flag;
+		list_.push_back(std::move(event));
+	}
+}
+
 void
 EventList::setFullTimeScale()
 {
@@ -1110,29 +1176,42 @@ EventList::setControlPeriod(int value)
 void
 EventList::printDataStructures()
 {
-	printf("Tone Groups %d\n", currentToneGroup_);
+	// Formatted with snprintf and sent to the debug stream, which is
+	// stderr when stdout carries audio.
+	std::ostream& out = Log::debugStream();
+	char line[256];
+
+	std::snprintf(line, sizeof line, "Tone Groups %d\n", currentToneGroup_);
+	out << line;
 	for (int i = 0; i < currentToneGroup_; i++) {
-		printf("%d  start: %d  end: %d  type: %d\n", i, toneGroups_[i].startFoot, toneGroups_[i].endFoot,
+		std::snprintf(line, sizeof line, "%d  start: %d  end: %d  type: %d\n", i, toneGroups_[i].startFoot, toneGroups_[i].endFoot,
 			static_cast<int>(toneGroups_[i].type));
+		out << line;
 	}
 
-	printf("\nFeet %d\n", currentFoot_);
+	std::snprintf(line, sizeof line, "\nFeet %d\n", currentFoot_);
+	out << line;
 	for (int i = 0; i < currentFoot_; i++) {
-		printf("%d  tempo: %f start: %d  end: %d  marked: %d last: %d onset1: %f onset2: %f\n", i, feet_[i].tempo,
+		std::snprintf(line, sizeof line, "%d  tempo: %f start: %d  end: %d  marked: %d last: %d onset1: %f onset2: %f\n", i, feet_[i].tempo,
 			feet_[i].start, feet_[i].end, feet_[i].marked, feet_[i].last, feet_[i].onset1, feet_[i].onset2);
+		out << line;
 	}
 
-	printf("\nPostures %d\n", currentPosture_);
+	std::snprintf(line, sizeof line, "\nPostures %d\n", currentPosture_);
+	out << line;
 	for (unsigned int i = 0; i < currentPosture_; i++) {
-		printf("DEBUG_POSTURE %u  \"%s\" tempo: %f syllable: %d onset: %f ruleTempo: %f\n",
+		std::snprintf(line, sizeof line, "DEBUG_POSTURE %u  \"%s\" tempo: %f syllable: %d onset: %f ruleTempo: %f\n",
 			i, postureData_[i].posture->name().c_str(), postureData_[i].tempo, postureData_[i].syllable,
 			postureData_[i].onset, postureData_[i].ruleTempo);
+		out << line;
 	}
 
-	printf("\nRules %d\n", currentRule_);
+	std::snprintf(line, sizeof line, "\nRules %d\n", currentRule_);
+	out << line;
 	for (int i = 0; i < currentRule_; i++) {
-		printf("Number: %d  start: %d  end: %d  duration %f\n", ruleData_[i].number, ruleData_[i].firstPosture,
+		std::snprintf(line, sizeof line, "Number: %d  start: %d  end: %d  duration %f\n", ruleData_[i].number, ruleData_[i].firstPosture,
 			ruleData_[i].lastPosture, ruleData_[i].duration);
+		out << line;
 	}
 }
 
@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "DriftGenerator.h"
+#include "EvaluationContext.h"
 #include "IntonationPoint.h"
 #include "IntonationRhythm.h"
 #include "Model.h"
@@ -160,11 +161,37 @@ struct Event {
 };
 typedef std::unique_ptr<Event> Event_ptr;
 
+// Data generated by the phonetic string parser and by
+// EventList::generateEventList. It does not depend on the intonation
+// settings, so it can be reused to synthesize the same phonetic string
+// with different intonation, without applying the rules again.
+struct SegmentalData {
+	struct EventData {
+		std::vector<double> parameters;
+		std::vector<double> specialParameters;
+		int time;
+		int flag;
+	};
+
+	int zeroRef;
+	int zeroIndex;
+	int duration;
+	std::vector<PostureData> postureData;
+	unsigned int currentPosture;
+	std::vector<Foot> feet;
+	int currentFoot;
+	std::vector<ToneGroup> toneGroups;
+	int currentToneGroup;
+	std::vector<RuleData> ruleData;
+	int currentRule;
+	std::vector<EventData> eventList;
+};
+
 
 
 class EventList {
 public:
-	EventList(const Index& index, Model& model);
+	EventList(const Index& index, const Model& model);
 	~EventList() = default;
 
 	const std::vector<Event_ptr>& list() const { return list_; }
@@ -199,6 +226,10 @@ public:
 
 	void setIntonationFactor(float value) { intonationFactor_ = value; }
 
+	// If seed is not 0, the random intonation and the drift generator
+	// are reinitialized, and the results will be reproducible.
+	void setRandomSeed(unsigned long seed);
+
 	void setCurrentPostureSyllable();
 	void setUp();
 	double getBeatAtIndex(int ruleIndex) const;
@@ -213,6 +244,10 @@ public:
 	void setCurrentPostureRuleTempo(double tempo);
 	void newToneGroup();
 	void generateEventList();
+	// Must be called after generateEventList, before applyIntonation.
+	void saveSegmentalData(SegmentalData& data) const;
+	// Replaces setUp, the parsing and generateEventList.
+	void restoreSegmentalData(const SegmentalData& data);
 	void applyIntonation();
 	void applyRhythm();
 	void prepareMacroIntonationInterpolation();
@@ -253,7 +288,8 @@ private:
 	double createSlopeRatioEvents(const Transition::SlopeRatio& slopeRatio,
 			double baseline, double parameterDelta, double min, double max, int parameter, double timeMultiplier, bool lastGroup);
 
-	Model& model_;
+	const Model& model_;
+	EvaluationContext evalContext_;
 
 	int zeroRef_;
 	int zeroIndex_;
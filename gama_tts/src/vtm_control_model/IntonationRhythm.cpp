@@ -152,6 +152,23 @@ IntonationRhythm::setRandomIntonation(bool value)
 	randomIntonation_ = value;
 }
 
+/*******************************************************************************
+ *
+ */
+void
+IntonationRhythm::setRandomSeed(unsigned long seed)
+{
+	if (seed == 0) {
+		randSrc_.seed(randDev_());
+	} else {
+		randSrc_.seed(static_cast<std::mt19937::result_type>(seed));
+	}
+	randRealDist_.reset();
+	for (auto& item : randomIntonationParamSetIndex_) {
+		if (item) item->reset();
+	}
+}
+
 /*******************************************************************************
  *
  */
@@ -59,6 +59,8 @@ public:
 	}
 
 	void setRandomIntonation(bool value);
+	// If seed is 0, the generator will be seeded by std::random_device.
+	void setRandomSeed(unsigned long seed);
 	bool randomIntonation() const { return randomIntonation_; }
 
 	const float* intonationParameters(ToneGroup toneGroup);
@@ -50,7 +50,6 @@ Model::clear()
 	equationGroupList_.clear();
 	transitionGroupList_.clear();
 	specialTransitionGroupList_.clear();
-	formulaSymbolList_.fill(0.0f);
 }
 
 /*******************************************************************************
@@ -307,91 +306,6 @@ Model::findCategoryName(const std::string& name) const
 	return false;
 }
 
-/*******************************************************************************
- *
- */
-void
-Model::clearFormulaSymbolList()
-{
-	formulaSymbolList_.fill(0.0);
-}
-
-/*******************************************************************************
- *
- */
-void
-Model::setFormulaSymbolValue(FormulaSymbol::Code symbol, float value)
-{
-	formulaSymbolList_[symbol] = value;
-}
-
-/*******************************************************************************
- *
- */
-float
-Model::getFormulaSymbolValue(FormulaSymbol::Code symbol) const
-{
-	return formulaSymbolList_[symbol];
-}
-
-/*******************************************************************************
- *
- */
-void
-Model::setDefaultFormulaSymbols(Transition::Type transitionType)
-{
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION1, 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION2, 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION3, 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION4, 33.3333f);
-
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA1      , 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA2      , 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA3      , 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA4      , 33.3333f);
-
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB1      , 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB2      , 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB3      , 33.3333f);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB4      , 33.3333f);
-
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO1, 1.0);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO2, 1.0);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO3, 1.0);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO4, 1.0);
-
-	setFormulaSymbolValue(FormulaSymbol::SYMB_BEAT ,  33.0);
-	setFormulaSymbolValue(FormulaSymbol::SYMB_MARK1, 100.0);
-	switch (transitionType) {
-	case Transition::Type::diphone:
-		setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, 100.0);
-		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        ,   0.0);
-		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        ,   0.0);
-		break;
-	case Transition::Type::triphone:
-		setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, 200.0);
-		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        , 200.0);
-		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        ,   0.0);
-		break;
-	case Transition::Type::tetraphone:
-		setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, 300.0);
-		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        , 200.0);
-		setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        , 300.0);
-		break;
-	default:
-		THROW_EXCEPTION(VTMControlModelException, "Invalid transition type: " << static_cast<int>(transitionType) << '.');
-	}
-}
-
-/*******************************************************************************
- *
- */
-float
-Model::evalEquationFormula(const Equation& equation) const
-{
-	return equation.evalFormula(formulaSymbolList_);
-}
-
 /*******************************************************************************
  *
  */
@@ -46,6 +46,8 @@ class Index;
 
 namespace VTMControlModel {
 
+// The Model is not modified during the synthesis.
+// The values of the formula symbols are stored in EvaluationContext.
 class Model {
 public:
 	Model() = default;
@@ -55,14 +57,9 @@ public:
 	void load(const Index& index);
 	void load(const std::string& filePath);
 	void save(const std::string& filePath);
-	void clearFormulaSymbolList();
-	void setFormulaSymbolValue(FormulaSymbol::Code symbol, float value);
-	float getFormulaSymbolValue(FormulaSymbol::Code symbol) const;
-	void setDefaultFormulaSymbols(Transition::Type transitionType);
 
 	const std::vector<EquationGroup>& equationGroupList() const { return equationGroupList_; }
 	std::vector<EquationGroup>& equationGroupList() { return equationGroupList_; }
-	float evalEquationFormula(const Equation& equation) const;
 	bool findEquationGroupName(const std::string& name) const;
 	bool findEquationName(const std::string& name) const;
 	bool findEquationIndex(const std::string& name, unsigned int& groupIndex, unsigned int& index) const;
@@ -125,7 +122,6 @@ private:
 	std::vector<EquationGroup> equationGroupList_;
 	std::vector<TransitionGroup> transitionGroupList_;
 	std::vector<TransitionGroup> specialTransitionGroupList_;
-	FormulaSymbolList formulaSymbolList_;
 };
 
 } /* namespace VTMControlModel */
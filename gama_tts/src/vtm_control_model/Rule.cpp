@@ -29,6 +29,7 @@
 
 #include "Category.h"
 #include "Equation.h"
+#include "EvaluationContext.h"
 #include "Model.h"
 #include "Posture.h"
 #include "Text.h"
@@ -465,85 +466,85 @@ Rule::numberOfExpressions() const
 
 // ruleSymbols[Rule::NUM_SYMBOLS]
 void
-Rule::evaluateExpressionSymbols(const std::vector<RuleExpressionData>& expressionData, Model& model, double* ruleSymbols) const
+Rule::evaluateExpressionSymbols(const std::vector<RuleExpressionData>& expressionData, EvaluationContext& context, double* ruleSymbols) const
 {
 	assert(expressionData.size() <= 4);
-	model.clearFormulaSymbolList();
+	context.clearFormulaSymbolList();
 
 	if (expressionData.size() >= 2) {
 		const Posture& posture = *expressionData[0].posture;
 		if (expressionData[0].marked) {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION1, posture.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA1      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB1      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION1, posture.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA1      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB1      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
 		} else {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION1, posture.getSymbolTarget(Posture::SYMB_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA1      , posture.getSymbolTarget(Posture::SYMB_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB1      , posture.getSymbolTarget(Posture::SYMB_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION1, posture.getSymbolTarget(Posture::SYMB_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA1      , posture.getSymbolTarget(Posture::SYMB_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB1      , posture.getSymbolTarget(Posture::SYMB_QSSB));
 		}
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO1, static_cast<float>(expressionData[0].tempo));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO1, static_cast<float>(expressionData[0].tempo));
 
 		const Posture& posture2 = *expressionData[1].posture;
 		if (expressionData[1].marked) {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION2, posture2.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA2      , posture2.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB2      , posture2.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION2, posture2.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA2      , posture2.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB2      , posture2.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
 		} else {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION2, posture2.getSymbolTarget(Posture::SYMB_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA2      , posture2.getSymbolTarget(Posture::SYMB_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB2      , posture2.getSymbolTarget(Posture::SYMB_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION2, posture2.getSymbolTarget(Posture::SYMB_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA2      , posture2.getSymbolTarget(Posture::SYMB_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB2      , posture2.getSymbolTarget(Posture::SYMB_QSSB));
 		}
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO2, static_cast<float>(expressionData[1].tempo));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO2, static_cast<float>(expressionData[1].tempo));
 	}
 	if (expressionData.size() >= 3) {
 		const Posture& posture = *expressionData[2].posture;
 		if (expressionData[2].marked) {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION3, posture.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA3      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB3      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION3, posture.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA3      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB3      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
 		} else {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION3, posture.getSymbolTarget(Posture::SYMB_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA3      , posture.getSymbolTarget(Posture::SYMB_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB3      , posture.getSymbolTarget(Posture::SYMB_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION3, posture.getSymbolTarget(Posture::SYMB_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA3      , posture.getSymbolTarget(Posture::SYMB_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB3      , posture.getSymbolTarget(Posture::SYMB_QSSB));
 		}
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO3, static_cast<float>(expressionData[2].tempo));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO3, static_cast<float>(expressionData[2].tempo));
 	}
 	if (expressionData.size() == 4) {
 		const Posture& posture = *expressionData[3].posture;
 		if (expressionData[3].marked) {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION4, posture.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA4      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB4      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION4, posture.getSymbolTarget(Posture::SYMB_MARKED_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA4      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB4      , posture.getSymbolTarget(Posture::SYMB_MARKED_QSSB));
 		} else {
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION4, posture.getSymbolTarget(Posture::SYMB_TRANSITION));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA4      , posture.getSymbolTarget(Posture::SYMB_QSSA));
-			model.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB4      , posture.getSymbolTarget(Posture::SYMB_QSSB));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_TRANSITION4, posture.getSymbolTarget(Posture::SYMB_TRANSITION));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSA4      , posture.getSymbolTarget(Posture::SYMB_QSSA));
+			context.setFormulaSymbolValue(FormulaSymbol::SYMB_QSSB4      , posture.getSymbolTarget(Posture::SYMB_QSSB));
 		}
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO4, static_cast<float>(expressionData[3].tempo));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_TEMPO4, static_cast<float>(expressionData[3].tempo));
 	}
 
 	// Execute in this order.
 	if (exprSymbolEquations_.duration) {
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, model.evalEquationFormula(*exprSymbolEquations_.duration));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION, context.evalEquationFormula(*exprSymbolEquations_.duration));
 	}
 	if (exprSymbolEquations_.mark1) {
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_MARK1        , model.evalEquationFormula(*exprSymbolEquations_.mark1));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_MARK1        , context.evalEquationFormula(*exprSymbolEquations_.mark1));
 	}
 	if (exprSymbolEquations_.mark2) {
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        , model.evalEquationFormula(*exprSymbolEquations_.mark2));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_MARK2        , context.evalEquationFormula(*exprSymbolEquations_.mark2));
 	}
 	if (exprSymbolEquations_.mark3) {
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        , model.evalEquationFormula(*exprSymbolEquations_.mark3));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_MARK3        , context.evalEquationFormula(*exprSymbolEquations_.mark3));
 	}
 	if (exprSymbolEquations_.beat) {
-		model.setFormulaSymbolValue(FormulaSymbol::SYMB_BEAT         , model.evalEquationFormula(*exprSymbolEquations_.beat));
+		context.setFormulaSymbolValue(FormulaSymbol::SYMB_BEAT         , context.evalEquationFormula(*exprSymbolEquations_.beat));
 	}
 
-	ruleSymbols[Rule::SYMB_DURATION] = model.getFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION);
-	ruleSymbols[Rule::SYMB_BEAT    ] = model.getFormulaSymbolValue(FormulaSymbol::SYMB_BEAT);
-	ruleSymbols[Rule::SYMB_MARK1   ] = model.getFormulaSymbolValue(FormulaSymbol::SYMB_MARK1);
-	ruleSymbols[Rule::SYMB_MARK2   ] = model.getFormulaSymbolValue(FormulaSymbol::SYMB_MARK2);
-	ruleSymbols[Rule::SYMB_MARK3   ] = model.getFormulaSymbolValue(FormulaSymbol::SYMB_MARK3);
+	ruleSymbols[Rule::SYMB_DURATION] = context.getFormulaSymbolValue(FormulaSymbol::SYMB_RULE_DURATION);
+	ruleSymbols[Rule::SYMB_BEAT    ] = context.getFormulaSymbolValue(FormulaSymbol::SYMB_BEAT);
+	ruleSymbols[Rule::SYMB_MARK1   ] = context.getFormulaSymbolValue(FormulaSymbol::SYMB_MARK1);
+	ruleSymbols[Rule::SYMB_MARK2   ] = context.getFormulaSymbolValue(FormulaSymbol::SYMB_MARK2);
+	ruleSymbols[Rule::SYMB_MARK3   ] = context.getFormulaSymbolValue(FormulaSymbol::SYMB_MARK3);
 }
 
 void
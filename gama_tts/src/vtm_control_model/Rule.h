@@ -38,6 +38,7 @@ namespace VTMControlModel {
 
 class Category;
 class Equation;
+class EvaluationContext;
 class Model;
 class Posture;
 class Transition;
@@ -237,7 +238,7 @@ public:
 		specialProfileTransitionList_[parameterIndex] = transition;
 	}
 
-	void evaluateExpressionSymbols(const std::vector<RuleExpressionData>& expressionData, Model& model, double* ruleSymbols) const;
+	void evaluateExpressionSymbols(const std::vector<RuleExpressionData>& expressionData, EvaluationContext& context, double* ruleSymbols) const;
 
 	const std::vector<std::string>& booleanExpressionList() const { return booleanExpressionList_; }
 	void setBooleanExpressionList(const std::vector<std::string>& exprList, const Model& model);
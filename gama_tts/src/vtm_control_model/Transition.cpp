@@ -22,7 +22,7 @@
 
 #include "Transition.h"
 
-#include "Model.h"
+#include "EvaluationContext.h"
 
 
 
@@ -30,37 +30,37 @@ namespace GS {
 namespace VTMControlModel {
 
 double
-Transition::getPointTime(const Transition::Point& point, const Model& model)
+Transition::getPointTime(const Transition::Point& point, const EvaluationContext& context)
 {
 	if (!point.timeExpression) {
 		return point.freeTime;
 	} else {
-		return model.evalEquationFormula(*point.timeExpression);
+		return context.evalEquationFormula(*point.timeExpression);
 	}
 }
 
 void
-Transition::getPointData(const Transition::Point& point, const Model& model,
+Transition::getPointData(const Transition::Point& point, const EvaluationContext& context,
 				double& time, double& value)
 {
 	if (!point.timeExpression) {
 		time = point.freeTime;
 	} else {
-		time = model.evalEquationFormula(*point.timeExpression);
+		time = context.evalEquationFormula(*point.timeExpression);
 	}
 
 	value = point.value;
 }
 
 void
-Transition::getPointData(const Transition::Point& point, const Model& model,
+Transition::getPointData(const Transition::Point& point, const EvaluationContext& context,
 				double baseline, double delta, double min, double max,
 				double& time, double& value)
 {
 	if (!point.timeExpression) {
 		time = point.freeTime;
 	} else {
-		time = model.evalEquationFormula(*point.timeExpression);
+		time = context.evalEquationFormula(*point.timeExpression);
 	}
 
 	value = baseline + ((point.value / 100.0) * delta);
@@ -35,7 +35,7 @@
 namespace GS {
 namespace VTMControlModel {
 
-class Model;
+class EvaluationContext;
 
 class Transition {
 public:
@@ -157,10 +157,10 @@ public:
 	std::vector<PointOrSlope_ptr>& pointOrSlopeList() { return pointOrSlopeList_; }
 	const std::vector<PointOrSlope_ptr>& pointOrSlopeList() const { return pointOrSlopeList_; }
 
-	static double getPointTime(const Transition::Point& point, const Model& model);
-	static void getPointData(const Transition::Point& point, const Model& model,
+	static double getPointTime(const Transition::Point& point, const EvaluationContext& context);
+	static void getPointData(const Transition::Point& point, const EvaluationContext& context,
 					double& time, double& value);
-	static void getPointData(const Transition::Point& point, const Model& model,
+	static void getPointData(const Transition::Point& point, const EvaluationContext& context,
 					double baseline, double delta, double min, double max,
 					double& time, double& value);
 	static Type getTypeFromName(const std::string& typeName) {
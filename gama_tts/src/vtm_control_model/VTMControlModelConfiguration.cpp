@@ -57,6 +57,7 @@ Configuration::Configuration(const Index& index)
 	smoothIntonation = (config.value<int>("smooth_intonation") != 0);
 	intonationDrift  = (config.value<int>("intonation_drift" ) != 0);
 	randomIntonation = (config.value<int>("random_intonation") != 0);
+	randomSeed       = config.value<unsigned long>("random_seed");
 
 	// Load variant data.
 	std::string variantDirPath = index.entry("variant_dir");
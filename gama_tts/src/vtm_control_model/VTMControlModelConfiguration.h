@@ -60,6 +60,7 @@ struct Configuration {
 	bool smoothIntonation;
 	bool intonationDrift;
 	bool randomIntonation;
+	unsigned long randomSeed; // 0: not reproducible
 
 	std::unique_ptr<ConfigurationData> variantData;
 
@@ -99,6 +99,12 @@ JackClient::getSampleRate()
 	return jack_get_sample_rate(client_);
 }
 
+jack_nframes_t
+JackClient::getBufferSize()
+{
+	return jack_get_buffer_size(client_);
+}
+
 void
 JackClient::activate()
 {
@@ -57,6 +57,7 @@ public:
 	jack_port_t* registerPort(const char* portName, const char* portType,
 			unsigned long flags, unsigned long bufferSize);
 	jack_nframes_t getSampleRate();
+	jack_nframes_t getBufferSize();
 	void activate();
 	void getPorts(const char* portNamePattern, const char* typeNamePattern,
 			unsigned long flags, JackPorts& ports);
@@ -27,7 +27,6 @@
 #include "JackConfig.h"
 #include "Log.h"
 #include "VocalTractModel.h"
-#include "VTMUtil.h"
 
 #define PARAMETER_FILTER_PERIOD_SEC (20.0e-3)
 
@@ -86,9 +85,9 @@ ParameterModificationSynthesis::Processor::Processor(
 			double controlRate)
 		: numParameters_(numberOfParameters)
 		, outputPort_()
-		, vtmBufferPos_()
 		, parameterRingbuffer_(parameterRingbuffer)
 		, vocalTractModel_(VTM::VocalTractModel::getInstance(vtmConfigData, false))
+		, renderer_(*vocalTractModel_)
 		, currentParam_(numParameters_)
 		, delta_(numParameters_)
 		, gain_()
@@ -124,22 +123,10 @@ ParameterModificationSynthesis::Processor::process(jack_nframes_t nframes)
 		return 1;
 	}
 	jack_default_audio_sample_t* out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer(outputPort_, nframes));
-	std::vector<float>& vtmOutputBuffer = vocalTractModel_->outputBuffer();
 
-	const std::size_t n = VTM::Util::getSamples(vtmOutputBuffer, vtmBufferPos_, out,
-							nframes, gain_);
-
-	if (n == nframes) return 0; // JACK does not need more samples
-
-	// JACK needs more samples.
-
-	const std::size_t targetBufferSize = nframes - n;
-	while (vtmOutputBuffer.size() < targetBufferSize) { // while there is not enough data available
+	const std::size_t n = renderer_.render(out, nframes, gain_, [&](VTM::VocalTractModel& vtm) {
 		if (paramSetIndex_ >= modifiedParamList_.size()) {
-			// Using this flag because with Pipewire 0.3.65 the "return 1" does not deactivate the client.
-			playback_finished_.store(true, std::memory_order_release);
-
-			return 1; // the port may be disconnected
+			return false; // no more data
 		}
 
 		// Get modification data.
@@ -181,14 +168,20 @@ ParameterModificationSynthesis::Processor::process(jack_nframes_t nframes)
 			++paramSetIndex_;
 		}
 
-		// Synthesize using the VTM.
-		vocalTractModel_->setAllParameters(currentParam_);
-		vocalTractModel_->execSynthesisStep();
-	}
+		vtm.setAllParameters(currentParam_.data(), numParameters_);
+		return true;
+	});
 
-	[[maybe_unused]] const std::size_t n2 = VTM::Util::getSamples(vtmOutputBuffer, vtmBufferPos_, out + n,
-									nframes - n, gain_);
-	assert(n2 == nframes - n);
+	if (n < nframes) {
+		for (std::size_t i = n; i < nframes; ++i) {
+			out[i] = 0.0;
+		}
+
+		// Using this flag because with Pipewire 0.3.65 the "return 1" does not deactivate the client.
+		playback_finished_.store(true, std::memory_order_release);
+
+		return 1; // the port may be disconnected
+	}
 
 	return 0;
 }
@@ -224,13 +217,13 @@ ParameterModificationSynthesis::Processor::validData() const
  *
  */
 void
-ParameterModificationSynthesis::Processor::prepareSynthesis(jack_port_t* jackOutputPort, float gain) {
+ParameterModificationSynthesis::Processor::prepareSynthesis(jack_port_t* jackOutputPort, float gain, std::size_t maxFrames) {
 	if (!jackOutputPort) {
 		THROW_EXCEPTION(MissingValueException, "Missing JACK output port.");
 	}
 
 	outputPort_ = jackOutputPort;
-	vtmBufferPos_ = 0;
+	renderer_.reset(maxFrames);
 	gain_ = gain;
 	stepIndex_ = 0;
 	paramSetIndex_ = 1;
@@ -313,7 +306,7 @@ ParameterModificationSynthesis::startSynthesis(float gain)
 	if (!processor_->validData()) {
 		THROW_EXCEPTION(InvalidValueException, "Not enough data in the parameter modification synthesis processor.");
 	}
-	processor_->prepareSynthesis(outputPort, gain);
+	processor_->prepareSynthesis(outputPort, gain, newJackClient->getBufferSize());
 
 	newJackClient->setProcessCallback(param_modif_jack_process_callback, processor_.get());
 	newJackClient->setShutdownCallback(param_modif_jack_shutdown_callback, processor_.get());
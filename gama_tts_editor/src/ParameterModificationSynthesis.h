@@ -25,15 +25,13 @@
 #include "JackClient.h"
 #include "JackRingbuffer.h"
 #include "MovingAverageFilter.h"
+#include "RealTimeRenderer.h"
 
 
 
 namespace GS {
 
 class ConfigurationData;
-namespace VTM {
-class VocalTractModel;
-}
 
 class ParameterModificationSynthesis {
 public:
@@ -71,7 +69,8 @@ public:
 		// These functions can be called by the main thread only when the JACK thread is not running.
 		void resetData(const std::vector<std::vector<float>>& paramList);
 		bool validData() const;
-		void prepareSynthesis(jack_port_t* jackOutputPort, float gain);
+		// maxFrames: maximum number of frames in a process() call.
+		void prepareSynthesis(jack_port_t* jackOutputPort, float gain, std::size_t maxFrames);
 		template<typename T> void getModifiedParameter(unsigned int parameter, T& paramList) const;
 		template<typename T> void getParameter(unsigned int parameter, T& paramList) const;
 		void getModifiedParameterList(std::vector<std::vector<float>>& paramList) const;
@@ -87,11 +86,11 @@ public:
 
 		unsigned int numParameters_;
 		std::atomic<jack_port_t*> outputPort_;
-		std::size_t vtmBufferPos_;
 		JackRingbuffer* parameterRingbuffer_;
 		std::vector<std::vector<float>> paramList_;
 		std::vector<std::vector<float>> modifiedParamList_;
 		std::unique_ptr<VTM::VocalTractModel> vocalTractModel_;
+		VTM::RealTimeRenderer renderer_;
 		std::vector<float> currentParam_;
 		std::vector<float> delta_;
 		float gain_;
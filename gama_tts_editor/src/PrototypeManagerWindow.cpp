@@ -24,6 +24,7 @@
 #include <QMessageBox>
 #include <QSignalBlocker>
 
+#include "EvaluationContext.h"
 #include "Exception.h"
 #include "Model.h"
 #include "ui_PrototypeManagerWindow.h"
@@ -586,8 +587,9 @@ PrototypeManagerWindow::on_transitionsTree_currentItemChanged(QTreeWidgetItem* c
 
 	TransitionPoint::copyPointsFromTransition(*transition, pointList_);
 
-	model_->setDefaultFormulaSymbols(transition->type());
-	TransitionPoint::calculateTimes(*model_, pointList_);
+	VTMControlModel::EvaluationContext evalContext;
+	evalContext.setDefaultFormulaSymbols(transition->type());
+	TransitionPoint::calculateTimes(evalContext, pointList_);
 
 	TransitionPoint::sortPointListByTypeAndTime(specialPointList_);
 	TransitionPoint::adjustValuesInSlopeRatios(pointList_);
@@ -595,10 +597,10 @@ PrototypeManagerWindow::on_transitionsTree_currentItemChanged(QTreeWidgetItem* c
 	ui_->transitionWidget->updateData(
 		transition->type(),
 		&pointList_,
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_RULE_DURATION),
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK1),
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK2),
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK3)
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_RULE_DURATION),
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK1),
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK2),
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK3)
 	);
 
 	currentTransition_ = transition.get();
@@ -874,18 +876,19 @@ PrototypeManagerWindow::on_specialTransitionsTree_currentItemChanged(QTreeWidget
 
 	TransitionPoint::copyPointsFromTransition(*specialTransition, specialPointList_);
 
-	model_->setDefaultFormulaSymbols(specialTransition->type());
-	TransitionPoint::calculateTimes(*model_, specialPointList_);
+	VTMControlModel::EvaluationContext evalContext;
+	evalContext.setDefaultFormulaSymbols(specialTransition->type());
+	TransitionPoint::calculateTimes(evalContext, specialPointList_);
 
 	TransitionPoint::sortPointListByTime(specialPointList_);
 
 	ui_->specialTransitionWidget->updateData(
 		specialTransition->type(),
 		&specialPointList_,
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_RULE_DURATION),
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK1),
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK2),
-		model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK3)
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_RULE_DURATION),
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK1),
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK2),
+		evalContext.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK3)
 	);
 
 	currentSpecialTransition_ = specialTransition.get();
@@ -24,6 +24,7 @@
 
 #include <QMessageBox>
 
+#include "EvaluationContext.h"
 #include "Model.h"
 #include "ui_RuleTesterWindow.h"
 
@@ -156,8 +157,9 @@ RuleTesterWindow::on_testButton_clicked()
 
 	ui_->consumedTokensLineEdit->setText(QString::number(rule->numberOfExpressions()));
 
+	VTMControlModel::EvaluationContext evalContext;
 	double ruleSymbols[VTMControlModel::Rule::NUM_SYMBOLS];
-	rule->evaluateExpressionSymbols(ruleExpressionData, *model_, ruleSymbols);
+	rule->evaluateExpressionSymbols(ruleExpressionData, evalContext, ruleSymbols);
 
 	ui_->durationLineEdit->setText(QString::number(ruleSymbols[VTMControlModel::Rule::SYMB_DURATION]));
 	ui_->beatLineEdit->setText(    QString::number(ruleSymbols[VTMControlModel::Rule::SYMB_BEAT]));
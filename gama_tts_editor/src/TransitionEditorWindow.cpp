@@ -196,7 +196,7 @@ TransitionEditorWindow::updateTransition()
 
 	fillDefaultParameters();
 	try {
-		TransitionPoint::calculateTimes(*model_, pointList_);
+		TransitionPoint::calculateTimes(evalContext_, pointList_);
 	} catch (const Exception& exc) {
 		QMessageBox::critical(this, tr("Error"), exc.what());
 		clear();
@@ -455,11 +455,11 @@ TransitionEditorWindow::fillDefaultParameters()
 	if (model_ == nullptr) return;
 	if (transition_ == nullptr) return;
 
-	model_->setDefaultFormulaSymbols(transitionType_);
-	ruleDuration_ = model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_RULE_DURATION);
-	ruleMark1_    = model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK1);
-	ruleMark2_    = model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK2);
-	ruleMark3_    = model_->getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK3);
+	evalContext_.setDefaultFormulaSymbols(transitionType_);
+	ruleDuration_ = evalContext_.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_RULE_DURATION);
+	ruleMark1_    = evalContext_.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK1);
+	ruleMark2_    = evalContext_.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK2);
+	ruleMark3_    = evalContext_.getFormulaSymbolValue(VTMControlModel::FormulaSymbol::SYMB_MARK3);
 }
 
 void
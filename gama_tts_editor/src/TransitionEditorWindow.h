@@ -22,6 +22,7 @@
 
 #include <QWidget>
 
+#include "EvaluationContext.h"
 #include "TransitionPoint.h"
 
 
@@ -85,6 +86,7 @@ private:
 	VTMControlModel::Transition* transition_;
 	VTMControlModel::Transition::Type transitionType_;
 	std::vector<TransitionPoint> pointList_;
+	VTMControlModel::EvaluationContext evalContext_;
 	float ruleDuration_;
 	float ruleMark1_;
 	float ruleMark2_;
@@ -25,8 +25,8 @@
 #include <algorithm> /* sort */
 #include <utility> /* move, swap */
 
+#include "EvaluationContext.h"
 #include "Exception.h"
-#include "Model.h"
 
 
 
@@ -89,14 +89,14 @@ TransitionPoint::sortPointListByTime(std::vector<TransitionPoint>& pointList)
 }
 
 void
-TransitionPoint::calculateTimes(const VTMControlModel::Model& model, std::vector<TransitionPoint>& pointList)
+TransitionPoint::calculateTimes(const VTMControlModel::EvaluationContext& context, std::vector<TransitionPoint>& pointList)
 {
 	for (auto& point : pointList) {
 		const auto timeExpression = point.timeExpression.lock();
 		if (!timeExpression) {
 			point.time = point.freeTime;
 		} else {
-			point.time = model.evalEquationFormula(*timeExpression);
+			point.time = context.evalEquationFormula(*timeExpression);
 		}
 	}
 }
@@ -30,7 +30,7 @@
 namespace GS {
 
 namespace VTMControlModel {
-class Model;
+class EvaluationContext;
 }
 
 struct TransitionPoint {
@@ -58,7 +58,7 @@ struct TransitionPoint {
 	static void copyPointsFromTransition(const VTMControlModel::Transition& transition, std::vector<TransitionPoint>& pointList);
 	static void sortPointListByTypeAndTime(std::vector<TransitionPoint>& pointList);
 	static void sortPointListByTime(std::vector<TransitionPoint>& pointList);
-	static void calculateTimes(const VTMControlModel::Model& model, std::vector<TransitionPoint>& pointList);
+	static void calculateTimes(const VTMControlModel::EvaluationContext& context, std::vector<TransitionPoint>& pointList);
 	static void adjustValuesInSlopeRatios(std::vector<TransitionPoint>& pointList);
 	static void copyPointsToTransition(VTMControlModel::Transition::Type type, const std::vector<TransitionPoint>& pointList, VTMControlModel::Transition& transition);
 	static std::unique_ptr<VTMControlModel::Transition::Point> makeNewPoint(const TransitionPoint& sourcePoint);
@@ -22,6 +22,7 @@
 #include "InteractiveAudio.h"
 
 #include <cassert>
+#include <cmath> /* abs */
 #include <cstdlib>
 #include <iostream>
 
@@ -81,9 +82,9 @@ namespace GS {
  */
 InteractiveAudio::Processor::Processor(std::size_t numberOfParameters)
 		: outputPort_()
-		, vtmBufferPos_()
 		, maxAbsSampleValue_()
 		, vocalTractModel_()
+		, renderer_()
 		, parameterRingbuffer_()
 		, analysisRingbuffer_()
 		, paramValues_(numberOfParameters, 0.0)
@@ -95,12 +96,15 @@ InteractiveAudio::Processor::Processor(std::size_t numberOfParameters)
  */
 void
 InteractiveAudio::Processor::reset(jack_port_t* outputPort, InteractiveVTMConfiguration& configuration,
-			JackRingbuffer& parameterRingbuffer, JackRingbuffer& analysisRingbuffer)
+			JackRingbuffer& parameterRingbuffer, JackRingbuffer& analysisRingbuffer,
+			std::size_t maxFrames)
 {
 	outputPort_ = outputPort;
-	vtmBufferPos_ = 0;
 	maxAbsSampleValue_ = 0.0;
+	renderer_.reset();
 	vocalTractModel_ = VTM::VocalTractModel::getInstance(*configuration.vtmData, true);
+	renderer_ = std::make_unique<VTM::RealTimeRenderer>(*vocalTractModel_);
+	renderer_->reset(maxFrames);
 	parameterRingbuffer_ = &parameterRingbuffer;
 	analysisRingbuffer_ = &analysisRingbuffer;
 	for (auto& v : paramValues_) {
@@ -117,10 +121,12 @@ InteractiveAudio::Processor::reset(jack_port_t* outputPort, InteractiveVTMConfig
  *
  */
 float
-InteractiveAudio::Processor::calcScale(const std::vector<float>& buffer) {
-	const float maxValue = VTM::Util::maximumAbsoluteValue(buffer);
-	if (maxValue > maxAbsSampleValue_) {
-		maxAbsSampleValue_ = maxValue;
+InteractiveAudio::Processor::calcScale(const float* buffer, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) {
+		const float absValue = std::abs(buffer[i]);
+		if (absValue > maxAbsSampleValue_) {
+			maxAbsSampleValue_ = absValue;
+		}
 	}
 	return VTM::Util::calculateOutputScale(maxAbsSampleValue_);
 }
@@ -138,30 +144,7 @@ InteractiveAudio::Processor::process(jack_nframes_t nframes)
 	jack_default_audio_sample_t* out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer(outputPort_, nframes));
 	const std::size_t sampleSize = sizeof(jack_default_audio_sample_t);
 
-	std::vector<float>& vtmOutputBuffer = vocalTractModel_->outputBuffer();
-
-	const std::size_t n = VTM::Util::getSamples(vtmOutputBuffer, vtmBufferPos_, out,
-							nframes, calcScale(vtmOutputBuffer));
-
-	// Send data to analysis.
-	for (std::size_t i = 0; i < n; ++i) {
-		if (analysisRingbuffer_ && analysisRingbuffer_->writeSpace() >= sampleSize) {
-#ifndef NDEBUG
-			const std::size_t bytesWritten =
-#endif
-			analysisRingbuffer_->write(reinterpret_cast<const char*>(out + i), sampleSize);
-			assert(bytesWritten == sampleSize);
-		} else {
-			//std::cerr << "[Audio::Processor::process] Analysis buffer full." << std::endl;
-			break;
-		}
-	}
-
-	if (n == nframes) return 0; // JACK does not need more samples
-
-	// JACK needs more samples.
-
-	// Read parameters from ringbuffer, and send them to vocal tract model.
+	// Read parameters from ringbuffer.
 	const size_t elementSize = sizeof(VocalTractModelParameterValue);
 	VocalTractModelParameterValue pv;
 	const int numParam = paramValues_.size();
@@ -176,30 +159,30 @@ InteractiveAudio::Processor::process(jack_nframes_t nframes)
 		}
 	}
 
-	const std::size_t targetBufferSize = nframes - n;
-	while (vtmOutputBuffer.size() < targetBufferSize) {
+	// Send the parameters to the vocal tract model and synthesize.
+	[[maybe_unused]] const std::size_t n = renderer_->render(out, nframes, 1.0f, [&](VTM::VocalTractModel& vtm) {
 		for (int i = 0; i < numParam; ++i) {
-			// May throw exception.
-			vocalTractModel_->setParameter(i, paramFilters_[i].filter(paramValues_[i]));
+			vtm.setParameter(i, paramFilters_[i].filter(paramValues_[i]));
 		}
-		vocalTractModel_->execSynthesisStep();
-	}
+		return true;
+	});
+	assert(n == nframes);
 
-	const std::size_t n2 = VTM::Util::getSamples(vtmOutputBuffer, vtmBufferPos_, out + n,
-							nframes - n, calcScale(vtmOutputBuffer));
-	assert(n2 == nframes - n);
+	const float scale = calcScale(out, nframes);
+	for (std::size_t i = 0; i < nframes; ++i) {
+		out[i] *= scale;
+	}
 
 	// Send data to analysis.
-	jack_default_audio_sample_t* out2 = out + n;
-	for (std::size_t i = 0; i < n2; ++i) {
+	for (std::size_t i = 0; i < nframes; ++i) {
 		if (analysisRingbuffer_ && analysisRingbuffer_->writeSpace() >= sampleSize) {
 #ifndef NDEBUG
 			const std::size_t bytesWritten =
 #endif
-			analysisRingbuffer_->write(reinterpret_cast<const char*>(out2 + i), sampleSize);
+			analysisRingbuffer_->write(reinterpret_cast<const char*>(out + i), sampleSize);
 			assert(bytesWritten == sampleSize);
 		} else {
-			//std::cerr << "[Audio::Processor::process] Analysis buffer full (2)." << std::endl;
+			//std::cerr << "[Audio::Processor::process] Analysis buffer full." << std::endl;
 			break;
 		}
 	}
@@ -253,7 +236,8 @@ InteractiveAudio::start()
 	if (Log::debugEnabled) std::cout << "Output sample rate: " << outputRate << std::endl;
 
 	// Prepare the audio processor.
-	processor_.reset(outputPort, configuration_, *parameterRingbuffer_, *analysisRingbuffer_);
+	processor_.reset(outputPort, configuration_, *parameterRingbuffer_, *analysisRingbuffer_,
+				newJackClient->getBufferSize());
 
 	newJackClient->activate();
 
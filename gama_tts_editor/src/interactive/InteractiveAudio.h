@@ -25,6 +25,7 @@
 #include "JackClient.h"
 #include "JackRingbuffer.h"
 #include "MovingAverageFilter.h"
+#include "RealTimeRenderer.h"
 #include "VocalTractModel.h"
 
 
@@ -49,20 +50,22 @@ public:
 		int process(jack_nframes_t nframes);
 
 		// Can be called by the main thread only when the JACK thread is not running.
+		// maxFrames: maximum number of frames in a process() call.
 		void reset(jack_port_t* outputPort, InteractiveVTMConfiguration& configuration,
-				JackRingbuffer& parameterRingbuffer, JackRingbuffer& analysisRingbuffer);
+				JackRingbuffer& parameterRingbuffer, JackRingbuffer& analysisRingbuffer,
+				std::size_t maxFrames);
 	private:
 		Processor(const Processor&) = delete;
 		Processor& operator=(const Processor&) = delete;
 		Processor(Processor&&) = delete;
 		Processor& operator=(Processor&&) = delete;
 
-		float calcScale(const std::vector<float>& buffer);
+		float calcScale(const float* buffer, std::size_t n);
 
 		jack_port_t* outputPort_;
-		std::size_t vtmBufferPos_;
 		float maxAbsSampleValue_;
 		std::unique_ptr<VTM::VocalTractModel> vocalTractModel_;
+		std::unique_ptr<VTM::RealTimeRenderer> renderer_;
 		JackRingbuffer* parameterRingbuffer_;
 		JackRingbuffer* analysisRingbuffer_;
 		std::vector<float> paramValues_;
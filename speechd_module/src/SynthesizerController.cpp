@@ -31,6 +31,7 @@
 
 #define FADE_OUT_TIME_MS 30.0
 #define DEFAULT_AUDIO_FRAMES_PER_BUFFER 256
+#define SPEAK_LOOP_SLEEP_TIME_MS 20
 
 
 
@@ -56,6 +57,9 @@ SynthesizerController::SynthesizerController(ModuleController& moduleController)
 		: moduleController_(moduleController)
 		, synthThread_(&SynthesizerController::exec, std::ref(*this))
 		, commandType_(ModuleController::CommandType::none)
+		, audioQueueWriteCount_()
+		, audioQueueReadCount_()
+		, audioQueueComplete_()
 		, defaultPitchOffset_()
 		, audioBufferIndex_()
 		, state_(State::stopped)
@@ -105,37 +109,54 @@ SynthesizerController::audioCallback(float* outputBuffer, unsigned int nBufferFr
 {
 	const State st = state_;
 
-	const unsigned int framesAvailable = audioBuffer_.size() - audioBufferIndex_;
-	const unsigned int numFrames = (framesAvailable > nBufferFrames) ? nBufferFrames : framesAvailable;
-	if (st == State::stopping) {
-		for (unsigned int i = 0; i < numFrames; ++i) {
-			fadeOutAmplitude_ -= fadeOutDelta_;
-			if (fadeOutAmplitude_ < 0.0) fadeOutAmplitude_ = 0.0;
-			const unsigned int baseIndex = i * 2;
-			const float value = audioBuffer_[audioBufferIndex_ + i] * fadeOutAmplitude_;
-			outputBuffer[baseIndex]     = value;
-			outputBuffer[baseIndex + 1] = value;
+	unsigned int frameIndex = 0;
+	while (frameIndex < nBufferFrames) {
+		const unsigned int readCount = audioQueueReadCount_;
+		if (readCount == audioQueueWriteCount_) break; // the queue is empty
+
+		const std::vector<float>& audioBuffer = audioQueue_[readCount % AUDIO_QUEUE_SIZE];
+		const unsigned int framesAvailable = audioBuffer.size() - audioBufferIndex_;
+		const unsigned int framesNeeded = nBufferFrames - frameIndex;
+		const unsigned int numFrames = (framesAvailable > framesNeeded) ? framesNeeded : framesAvailable;
+		if (st == State::stopping) {
+			for (unsigned int i = 0; i < numFrames; ++i) {
+				fadeOutAmplitude_ -= fadeOutDelta_;
+				if (fadeOutAmplitude_ < 0.0) fadeOutAmplitude_ = 0.0;
+				const unsigned int baseIndex = (frameIndex + i) * 2;
+				const float value = audioBuffer[audioBufferIndex_ + i] * fadeOutAmplitude_;
+				outputBuffer[baseIndex]     = value;
+				outputBuffer[baseIndex + 1] = value;
+			}
+		} else {
+			for (unsigned int i = 0; i < numFrames; ++i) {
+				const unsigned int baseIndex = (frameIndex + i) * 2;
+				const float value = audioBuffer[audioBufferIndex_ + i];
+				outputBuffer[baseIndex]     = value;
+				outputBuffer[baseIndex + 1] = value;
+			}
 		}
-	} else {
-		for (unsigned int i = 0; i < numFrames; ++i) {
-			const unsigned int baseIndex = i * 2;
-			const float value = audioBuffer_[audioBufferIndex_ + i];
-			outputBuffer[baseIndex]     = value;
-			outputBuffer[baseIndex + 1] = value;
+		audioBufferIndex_ += numFrames;
+		frameIndex += numFrames;
+
+		if (audioBufferIndex_ == audioBuffer.size()) {
+			// Release the buffer to the synthesis thread.
+			audioBufferIndex_ = 0;
+			audioQueueReadCount_ = readCount + 1;
 		}
 	}
-	audioBufferIndex_ += numFrames;
 
-	for (unsigned int i = numFrames; i < nBufferFrames; ++i) {
+	for (unsigned int i = frameIndex; i < nBufferFrames; ++i) {
 		const unsigned int baseIndex = i * 2;
 		outputBuffer[baseIndex]     = 0;
 		outputBuffer[baseIndex + 1] = 0;
 	}
-	if (st == State::stopping && fadeOutAmplitude_ == 0.0) {
+
+	const bool queueEmpty = (audioQueueReadCount_ == audioQueueWriteCount_);
+	if (st == State::stopping && (fadeOutAmplitude_ == 0.0 || queueEmpty)) {
 		state_ = State::stopped;
 		return 1;
 	}
-	if (audioBufferIndex_ == audioBuffer_.size()) {
+	if (queueEmpty && audioQueueComplete_) {
 		state_ = State::stopped;
 		return 1;
 	} else {
@@ -213,6 +234,23 @@ SynthesizerController::set()
 	}
 }
 
+void
+SynthesizerController::resetAudioQueue()
+{
+	audioQueueWriteCount_ = 0;
+	audioQueueReadCount_ = 0;
+	audioQueueComplete_ = false;
+	audioBufferIndex_ = 0;
+}
+
+void
+SynthesizerController::synthesizeChunk(const std::string& phoneticStringChunk)
+{
+	const unsigned int writeCount = audioQueueWriteCount_;
+	modelController_->synthesizePhoneticStringToBuffer(phoneticStringChunk, nullptr, audioQueue_[writeCount % AUDIO_QUEUE_SIZE]);
+	audioQueueWriteCount_ = writeCount + 1;
+}
+
 void
 SynthesizerController::speak()
 {
@@ -225,12 +263,21 @@ SynthesizerController::speak()
 		return;
 	}
 
-	//--------------------
-	// Generate the audio.
+	//------------------------------------
+	// Generate the audio of the first chunk.
 
+	std::vector<std::string> chunkList;
+	std::size_t chunkIndex = 0;
+	resetAudioQueue();
 	try {
 		const std::string phoneticString = textParser_->parse(commandMessage_.c_str());
-		modelController_->synthesizePhoneticStringToBuffer(phoneticString, nullptr, audioBuffer_);
+		Util::splitPhoneticString(phoneticString, chunkList);
+		if (!chunkList.empty()) {
+			synthesizeChunk(chunkList[chunkIndex++]);
+		}
+		if (chunkIndex == chunkList.size()) {
+			audioQueueComplete_ = true;
+		}
 
 	} catch (const std::exception& exc) {
 		std::ostringstream msg;
@@ -245,10 +292,10 @@ SynthesizerController::speak()
 
 	//----------------
 	// Play the audio.
+	// The next chunks are synthesized while the audio is being played.
 
 	moduleController_.sendBeginEvent();
 
-	audioBufferIndex_ = 0;
 	fadeOutAmplitude_ = 1.0;
 
 	try {
@@ -256,13 +303,27 @@ SynthesizerController::speak()
 		bool stopping = false;
 		audio_.startStream();
 		while (audio_.isStreamRunning()) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
 			if (!stopping) {
 				if (moduleController_.state() == ModuleController::State::stopRequested) {
+					// The chunks that have not been synthesized are discarded.
 					state_ = State::stopping;
 					stopping = true;
 				}
 			}
+			if (!stopping && !audioQueueComplete_ &&
+					audioQueueWriteCount_ - audioQueueReadCount_ < AUDIO_QUEUE_SIZE) {
+				try {
+					synthesizeChunk(chunkList[chunkIndex++]);
+				} catch (const std::exception& exc) {
+					std::cerr << "[SynthesizerController::speak] Could not synthesize the text. Reason: " << exc.what() << '.' << std::endl;
+					chunkIndex = chunkList.size();
+				}
+				if (chunkIndex == chunkList.size()) {
+					audioQueueComplete_ = true;
+				}
+			} else {
+				std::this_thread::sleep_for(std::chrono::milliseconds(SPEAK_LOOP_SLEEP_TIME_MS));
+			}
 		}
 		if (stopping) {
 			moduleController_.sendStopEvent();
@@ -18,6 +18,7 @@
 #ifndef SYNTHESIZER_CONTROLLER_H_
 #define SYNTHESIZER_CONTROLLER_H_
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <string>
@@ -40,6 +41,8 @@ namespace GS {
 	}
 }
 
+#define AUDIO_QUEUE_SIZE 3
+
 class SynthesizerController {
 public:
 	explicit SynthesizerController(ModuleController& moduleController);
@@ -65,6 +68,10 @@ private:
 	void init();
 	void set();
 	void speak();
+	void resetAudioQueue();
+	// Synthesizes a chunk of the phonetic string and sends the audio to the queue.
+	// The queue must not be full.
+	void synthesizeChunk(const std::string& phoneticStringChunk);
 
 	ModuleController& moduleController_;
 	std::thread synthThread_;
@@ -77,12 +84,17 @@ private:
 	ModuleController::CommandType commandType_;
 	std::string commandMessage_;
 
-	std::vector<float> audioBuffer_;
+	// Single producer (synthesis thread), single consumer (audio callback).
+	// The synthesis thread fills the next buffers while the current buffer is being played.
+	std::array<std::vector<float>, AUDIO_QUEUE_SIZE> audioQueue_;
+	std::atomic<unsigned int> audioQueueWriteCount_;
+	std::atomic<unsigned int> audioQueueReadCount_;
+	std::atomic<bool> audioQueueComplete_; // all the buffers of the message have been queued
 
 	ModuleConfiguration moduleConfig_;
 	double defaultPitchOffset_;
 
-	unsigned int audioBufferIndex_;
+	unsigned int audioBufferIndex_; // index in the buffer being played
 
 	std::atomic<State> state_;
 	float fadeOutAmplitude_;
@@ -22,6 +22,7 @@ namespace {
 constexpr std::string_view  ltStr{"lt;"};
 constexpr std::string_view  gtStr{"gt;"};
 constexpr std::string_view ampStr{"amp;"};
+constexpr std::string_view chunkStr{"/c"};
 
 } // namespace
 
@@ -90,6 +91,24 @@ removeLF(std::string& msg)
 	}
 }
 
+void
+splitPhoneticString(const std::string& phoneticString, std::vector<std::string>& chunkList)
+{
+	chunkList.clear();
+
+	std::string::size_type pos = phoneticString.find(chunkStr.data(), 0, chunkStr.size());
+	while (pos != std::string::npos) {
+		const std::string::size_type nextPos = phoneticString.find(chunkStr.data(), pos + chunkStr.size(), chunkStr.size());
+		const std::string::size_type endPos = (nextPos == std::string::npos) ? phoneticString.size() : nextPos;
+
+		// Ignore chunks that contain only spaces.
+		if (phoneticString.find_first_not_of(' ', pos + chunkStr.size()) < endPos) {
+			chunkList.push_back(phoneticString.substr(pos, endPos - pos));
+		}
+		pos = nextPos;
+	}
+}
+
 bool
 compare(const std::string_view& s1, const std::string& s2, std::string::size_type s2Index)
 {
@@ -22,6 +22,7 @@
 #include <string>
 #include <string_view>
 #include <utility> /* make_pair, pair */
+#include <vector>
 
 
 
@@ -30,6 +31,8 @@ namespace Util {
 void stripSSML(std::string& msg);
 std::pair<std::string, std::string> getNameAndValue(const std::string& s);
 void removeLF(std::string& msg);
+// Splits a phonetic string in chunks that start with /c.
+void splitPhoneticString(const std::string& phoneticString, std::vector<std::string>& chunkList);
 template<typename T> T convertString(const std::string& s);
 bool compare(const std::string_view& s1, const std::string& s2, std::string::size_type s2Index);
 template<typename T> T bound(T min, T value, T max);